@@ -1,153 +1,12 @@
-
-// ------------------ Árbol sintáctico (AST) ------------------
-struct Nodo {
-    std::string simbolo;
-    std::vector<Nodo*> hijos;
-    Nodo(const std::string &s) : simbolo(s) {}
-};
-
-void imprimirArbolASCII(Nodo* nodo, const std::string &pref = "", bool esUltimo = true) {
-    if (!nodo) return;
-    std::cout << pref;
-    if (esUltimo) std::cout << "└── ";
-    else std::cout << "├── ";
-    std::cout << nodo->simbolo << "\n";
-    std::string nuevoPref = pref + (esUltimo ? "    " : "│   ");
-    for (size_t i = 0; i < nodo->hijos.size(); ++i) {
-        imprimirArbolASCII(nodo->hijos[i], nuevoPref, i+1==nodo->hijos.size());
-    }
-}
-// ------------------ Fin AST ------------------
-
 #include <iostream>
 #include <string>
 #include <cctype>
 #include <vector>
 #include <memory>
+#include "lexer.h"
 
-enum class TokenType {
-    IDENT,   // identificador
-    ENTERO,  // número entero
-    REAL,    // número real: entero '.' entero+
-    OP_SUMA, // +, -
-    OP_MUL,  // *, /
-    OP_ASIG, // =
-    OP_RELAC,// <, >, <=, >=, !=, ==
-    OP_AND,  // &&
-    OP_OR,   // ||
-    OP_NOT,  // !
-    PARENTESIS_ABRE, // (
-    PARENTESIS_CIERRA, // )
-    LLAVE_ABRE, // {
-    LLAVE_CIERRA, // }
-    PUNTO_Y_COMA, // ;
-    RESERVADA_IF, // if
-    RESERVADA_WHILE, // while
-    RESERVADA_RETURN, // return
-    RESERVADA_ELSE, // else
-    TIPO_INT, // int
-    TIPO_FLOAT, // float
-    PESOS, // $
-    DESCONOCIDO,
-    FIN
-};
-
-struct Token {
-    TokenType type;
-    std::string lexeme;
-    size_t pos;
-};
-
-class Lexer {
-public:
-    explicit Lexer(const std::string& src) : s(src), n(src.size()), i(0) {}
-
-    Token next() {
-        saltarBlancos();
-
-        if (i >= n) return {TokenType::FIN, "", i};
-
-        char c = s[i];
-
-        // identificador: letra (letra | digito)*
-        if (esLetra(c)) {
-            size_t start = i++;
-            while (i < n && (esLetra(s[i]) || std::isdigit(static_cast<unsigned char>(s[i])))) {
-                ++i;
-            }
-            std::string lexeme = s.substr(start, i - start);
-            if (lexeme == "if") return {TokenType::RESERVADA_IF, lexeme, start};
-            if (lexeme == "while") return {TokenType::RESERVADA_WHILE, lexeme, start};
-            if (lexeme == "return") return {TokenType::RESERVADA_RETURN, lexeme, start};
-            if (lexeme == "else") return {TokenType::RESERVADA_ELSE, lexeme, start};
-            if (lexeme == "int") return {TokenType::TIPO_INT, lexeme, start};
-            if (lexeme == "float") return {TokenType::TIPO_FLOAT, lexeme, start};
-            return {TokenType::IDENT, lexeme, start};
-        }
-
-        // Entero: dígito+
-        if (std::isdigit(static_cast<unsigned char>(c))) {
-            size_t start = i++;
-            while (i < n && std::isdigit(static_cast<unsigned char>(s[i]))) ++i;
-            return {TokenType::ENTERO, s.substr(start, i - start), start};
-        }
-
-        // Real: entero '.' entero+
-        if (std::isdigit(static_cast<unsigned char>(c))) {
-            size_t start = i;
-            while (i < n && std::isdigit(static_cast<unsigned char>(s[i]))) ++i;
-
-            if (i < n && s[i] == '.') {
-                size_t punto = i++;
-                if (i < n && std::isdigit(static_cast<unsigned char>(s[i]))) {
-                    while (i < n && std::isdigit(static_cast<unsigned char>(s[i]))) ++i;
-                    return {TokenType::REAL, s.substr(start, i - start), start};
-                } else {
-                    i = punto; // retrocede si no hubo dígitos tras el punto
-                }
-            }
-            ++i; // consume un carácter
-            return {TokenType::DESCONOCIDO, s.substr(start, 1), start};
-        }
-
-        // Operadores
-        if (c == '+') { i++; return {TokenType::OP_SUMA, "+", i - 1}; }
-        if (c == '-') { i++; return {TokenType::OP_SUMA, "-", i - 1}; }
-        if (c == '*') { i++; return {TokenType::OP_MUL, "*", i - 1}; }
-        if (c == '/') { i++; return {TokenType::OP_MUL, "/", i - 1}; }
-        if (c == '=') { i++; return {TokenType::OP_ASIG, "=", i - 1}; }
-        if (c == '<') { i++; return {TokenType::OP_RELAC, "<", i - 1}; }
-        if (c == '>') { i++; return {TokenType::OP_RELAC, ">", i - 1}; }
-        if (c == ';') { i++; return {TokenType::PUNTO_Y_COMA, ";", i - 1}; }
-        if (c == '(') { i++; return {TokenType::PARENTESIS_ABRE, "(", i - 1}; }
-        if (c == ')') { i++; return {TokenType::PARENTESIS_CIERRA, ")", i - 1}; }
-        if (c == '{') { i++; return {TokenType::LLAVE_ABRE, "{", i - 1}; }
-        if (c == '}') { i++; return {TokenType::LLAVE_CIERRA, "}", i - 1}; }
-        if (c == '&' && i + 1 < n && s[i + 1] == '&') { i += 2; return {TokenType::OP_AND, "&&", i - 2}; }
-        if (c == '|' && i + 1 < n && s[i + 1] == '|') { i += 2; return {TokenType::OP_OR, "||", i - 2}; }
-        if (c == '!') { i++; return {TokenType::OP_NOT, "!", i - 1}; }
-        if (c == '=' && i + 1 < n && s[i + 1] == '=') { i += 2; return {TokenType::OP_RELAC, "==", i - 2}; }
-        if (c == '!' && i + 1 < n && s[i + 1] == '=') { i += 2; return {TokenType::OP_RELAC, "!=", i - 2}; }
-
-        // Cualquier otro símbolo: DESCONOCIDO (consume 1 char)
-        size_t start = i++;
-        return {TokenType::DESCONOCIDO, s.substr(start - 1, 1), start - 1};
-    }
-
-private:
-    const std::string& s;
-    size_t n;
-    size_t i;
-
-    static bool esLetra(char c) {
-        return std::isalpha(static_cast<unsigned char>(c)) != 0;
-    }
-
-    void saltarBlancos() {
-        while (i < n && std::isspace(static_cast<unsigned char>(s[i]))) ++i;
-    }
-};
-
+// Tokens y Lexer compartidos con el traductor (lexer.h): los mismos tipos
+// que describe docs/compilador.lex.
 // Clase base para elementos de la pila
 class ElementoPila {
 public:
@@ -250,19 +109,25 @@ void ejemplo2() {
     }
 }
 
+// Columna de la tabla de ejemplo: a (identificador), $; E es la columna 2.
+int columnaDe(TokenType t) {
+    return t == TokenType::IDENT ? 0 : t == TokenType::FIN ? 1 : -1;
+}
+
 void ejemplo3() {
     Pila pila;
     int fila, columna, accion;
     bool aceptacion = false;
     Lexer lexico("a$");
 
-    pila.push(new Estado(static_cast<int>(TokenType::PESOS))); // PESOS es 1
+    pila.push(new Estado(static_cast<int>(TokenType::FIN))); // fondo de la pila ($)
     pila.push(new Estado(0)); // Estado inicial
     lexico.next(); // Leer el primer símbolo
 
     while (true) {
         fila = static_cast<int>(pila.top()->toString()[7]) - '0'; // Obtener el estado
-        columna = static_cast<int>(lexico.next().type); // Obtener el tipo del símbolo
+        columna = columnaDe(lexico.next().type); // Obtener el tipo del símbolo
+        if (fila < 0 || fila > 2 || columna < 0) break; // fuera de la tabla: error
         accion = tablaLR[fila][columna];
 
         pila.muestra();
@@ -0,0 +1,130 @@
+// arbol.h
+// Árbol sintáctico construido por el parser LR durante SHIFT/REDUCE.
+// Los nodos viven en arreglos contiguos (arena) y se referencian por índice;
+// los hijos de cada nodo son un rango contiguo de 'hijos'. Todo es trivialmente
+// destructible, así que liberar o reutilizar el árbol completo es O(1).
+#ifndef ARBOL_H
+#define ARBOL_H
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "gramatica.h"
+#include "lexemas.h"
+#include "lexer.h"
+#include "salida.h"
+
+// ------------------ Árbol sintáctico (AST) ------------------
+struct NodoAst {
+    int32_t simbolo;     // regla (1..nReglas) si es interno; -(1+TokenType) si es hoja
+    uint32_t lexema;     // id en TablaLexemas de identificadores y literales
+    uint32_t primerHijo; // rango [primerHijo, primerHijo+nHijos) de Arbol::hijos
+    uint32_t nHijos;
+
+    bool esHoja() const { return simbolo < 0; }
+    int regla() const { return simbolo; }
+    TokenType tipoToken() const { return (TokenType)(-simbolo - 1); }
+};
+
+class Arbol {
+public:
+    static const uint32_t NINGUNO = UINT32_MAX;
+
+    std::vector<NodoAst> nodos;
+    std::vector<uint32_t> hijos;
+    TablaLexemas lexemas;
+    uint32_t raiz = NINGUNO;
+
+    uint32_t hoja(TokenType t, uint32_t lexema) {
+        nodos.push_back(NodoAst{-1 - (int32_t)t, lexema, 0, 0});
+        return (uint32_t)nodos.size() - 1;
+    }
+
+    // Nodo de la regla 'regla' cuyos hijos son los n índices de h, en orden.
+    uint32_t interno(int regla, const uint32_t *h, uint32_t n) {
+        uint32_t primero = (uint32_t)hijos.size();
+        hijos.insert(hijos.end(), h, h + n);
+        nodos.push_back(NodoAst{regla, TablaLexemas::NINGUNO, primero, n});
+        return (uint32_t)nodos.size() - 1;
+    }
+
+    const NodoAst& operator[](uint32_t k) const { return nodos[k]; }
+    uint32_t hijo(const NodoAst &n, uint32_t i) const { return hijos[n.primerHijo + i]; }
+
+    // Conserva la capacidad para el siguiente análisis.
+    void limpiar() {
+        nodos.clear();
+        hijos.clear();
+        lexemas.limpiar();
+        raiz = NINGUNO;
+    }
+
+    size_t bytes() const {
+        return nodos.capacity() * sizeof(NodoAst) + hijos.capacity() * sizeof(uint32_t) + lexemas.bytes();
+    }
+};
+
+// Etiqueta que se imprime para un nodo: nombre de la regla, o clave del
+// terminal seguida de ":lexema" en identificadores y literales.
+inline std::string etiquetaNodo(const Arbol &A, const LRGram &G, uint32_t k) {
+    const NodoAst &n = A[k];
+    if (!n.esHoja()) return G.nombreRegla(n.regla() - 1);
+    std::string s = tokenToKey(n.tipoToken());
+    if (n.lexema != TablaLexemas::NINGUNO) {
+        s += ':';
+        s += A.lexemas.texto(n.lexema);
+    }
+    return s;
+}
+
+inline void escribirEtiqueta(SalidaBuffer &s, const Arbol &A, const LRGram &G, uint32_t k) {
+    const NodoAst &n = A[k];
+    if (!n.esHoja()) { s.escribir(G.nombreRegla(n.regla() - 1)); return; }
+    s.escribir(tokenToKey(n.tipoToken()));
+    if (n.lexema != TablaLexemas::NINGUNO) {
+        s.caracter(':');
+        s.escribir(A.lexemas.texto(n.lexema));
+    }
+}
+
+// Recorrido en preorden con pila explícita: la profundidad del árbol (las
+// cadenas de Definiciones y las expresiones anidadas son recursivas por la
+// derecha) no consume pila de llamadas, y el prefijo es un solo string que
+// crece y se recorta por nivel en lugar de copiarse en cada uno.
+inline void escribirArbolASCII(SalidaBuffer &s, const Arbol &A, const LRGram &G, uint32_t nodo, std::string pref = "", bool esUltimo = true) {
+    if (nodo == Arbol::NINGUNO) return;
+    struct Marco { uint32_t nodo, siguiente; size_t lonPref; };
+    std::vector<Marco> pila;
+    auto visitar = [&](uint32_t k, bool ultimo) {
+        s.escribir(pref);
+        s.escribir(ultimo ? "└── " : "├── ");
+        escribirEtiqueta(s, A, G, k);
+        s.caracter('\n');
+        pila.push_back(Marco{k, 0, pref.size()});
+        pref += ultimo ? "    " : "│   ";
+    };
+    visitar(nodo, esUltimo);
+    while (!pila.empty()) {
+        Marco &m = pila.back();
+        const NodoAst &n = A[m.nodo];
+        if (m.siguiente == n.nHijos) {
+            pref.resize(m.lonPref);
+            pila.pop_back();
+            continue;
+        }
+        uint32_t i = m.siguiente++;
+        visitar(A.hijo(n, i), i + 1 == n.nHijos);
+    }
+}
+
+inline void imprimirArbolASCII(std::ostream &os, const Arbol &A, const LRGram &G, uint32_t nodo, const std::string &pref = "", bool esUltimo = true) {
+    SalidaBuffer s(os);
+    escribirArbolASCII(s, A, G, nodo, pref, esUltimo);
+}
+inline void imprimirArbolASCII(const Arbol &A, const LRGram &G, uint32_t nodo, const std::string &pref = "", bool esUltimo = true) {
+    imprimirArbolASCII(std::cout, A, G, nodo, pref, esUltimo);
+}
+// ------------------ Fin AST ------------------
+
+#endif
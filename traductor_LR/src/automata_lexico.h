@@ -0,0 +1,509 @@
+// automata_lexico.h
+// Generador de analizadores léxicos a partir de definiciones de tokens (una
+// expresión regular por línea, ver docs/compilador.lex):
+//   1. cada expresión se traduce a un AFN con la construcción de Thompson y
+//      todos se unen en un estado inicial común;
+//   2. los bytes se agrupan en clases (dos bytes en la misma clase no los
+//      distingue ninguna expresión) y el AFN se determiniza por
+//      subconjuntos sobre esas clases; cada estado acepta el token de la
+//      primera línea que termina en él;
+//   3. el AFD se minimiza con Hopcroft, partiendo de un bloque por token
+//      aceptado.
+// El resultado son dos tablas (AutomataLexico): la clase de cada byte y una
+// fila de transiciones por estado. LexerDFA las recorre con la regla de la
+// coincidencia más larga y devuelve los mismos Token que LexerRapido, así
+// que sirve como Fuente de analizarLR. generadorlexico.cpp escribe las
+// tablas como arreglos constexpr (lexer_generado.h).
+#ifndef AUTOMATA_LEXICO_H
+#define AUTOMATA_LEXICO_H
+
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "lexer.h"
+
+/* ------------------ Autómata compilado ------------------ */
+// Cada estado es una fila de nClases + 1 celdas: la transición por cada
+// clase y, en la última celda, lo que acepta el estado (0 nada,
+// ACEPTA_IGNORAR, o ACEPTA_TOKEN + TokenType). Una transición guarda el
+// inicio de la fila destino (estado * (nClases+1)) multiplicado por 2, más 1
+// si el destino acepta algo: el recorrido no lee la última celda hasta que
+// termina. La fila 0 es el estado muerto, así que el recorrido termina
+// cuando la transición vale 0.
+struct AutomataLexico {
+    static constexpr uint16_t ACEPTA_IGNORAR = 1, ACEPTA_TOKEN = 2;
+    const uint8_t *clase = nullptr;  // [256]
+    const uint16_t *fila = nullptr;  // [nEstados * (nClases+1)]
+    uint32_t nClases = 0, nEstados = 0;
+    uint32_t inicial = 0;            // inicio de la fila del estado inicial
+};
+
+/* ------------------ LEXER DFA ------------------ */
+class LexerDFA {
+public:
+    explicit LexerDFA(const AutomataLexico &a, std::string_view src = std::string_view(), size_t desde = 0)
+        : A(a), p(src.data()), n(src.size()), i(desde) {}
+
+    void reiniciar(std::string_view src) { p = src.data(); n = src.size(); i = 0; mirado = 0; }
+
+    // Primer byte todavía no consumido.
+    size_t posicion() const { return i; }
+    // Uno más que el último byte que miró el último next(), o n+1 si llegó al
+    // final: lo que siga en la entrada después de ese punto no cambia el token.
+    size_t alcance() const { return mirado; }
+
+    Token next(){
+        const uint16_t *f = A.fila;
+        const uint8_t *clase = A.clase;
+        const uint32_t col = A.nClases;
+        while (true) {
+            size_t start = i, k = i, fin = i;
+            uint32_t e = A.inicial, eFin = 0; // fila 0: no aceptó nada
+            while (k < n) {
+                uint32_t sig = f[e + clase[(unsigned char)p[k]]];
+                if (!sig) break;
+                e = sig >> 1;
+                k++;
+                if (sig & 1) { eFin = e; fin = k; }
+            }
+            mirado = k < n ? k + 1 : n + 1;
+            uint16_t acepta = f[eFin + col];
+            if (!acepta) {
+                if (start >= n) return {TokenType::FIN, "$", start};
+                i = start + 1;
+                return {TokenType::DESCONOCIDO, std::string_view(p + start, 1), start};
+            }
+            i = fin;
+            if (acepta != AutomataLexico::ACEPTA_IGNORAR)
+                return {(TokenType)(acepta - AutomataLexico::ACEPTA_TOKEN), std::string_view(p + start, fin - start), start};
+        }
+    }
+
+private:
+    AutomataLexico A;
+    const char *p;
+    size_t n;
+    size_t i;
+    size_t mirado = 0;
+};
+
+/* ------------------ Definiciones de tokens ------------------ */
+struct ReglaLexica {
+    std::string nombre;    // enumerador de TokenType, o "-" para descartar
+    std::string expresion;
+    uint16_t acepta;       // celda de aceptación (ver AutomataLexico)
+    int linea;
+};
+
+// Una regla por línea: "NOMBRE expresión". Las líneas vacías y las que
+// empiezan con '#' se saltan. Con la misma longitud gana la regla anterior.
+inline bool leerEspecLexica(std::istream &f, std::vector<ReglaLexica> &reglas, std::string &error){
+    reglas.clear();
+    std::string linea;
+    for (int nLinea = 1; std::getline(f, linea); nLinea++) {
+        if (!linea.empty() && linea.back() == '\r') linea.pop_back();
+        size_t a = linea.find_first_not_of(" \t");
+        if (a == std::string::npos || linea[a] == '#') continue;
+        size_t b = linea.find_first_of(" \t", a);
+        size_t c = b == std::string::npos ? b : linea.find_first_not_of(" \t", b);
+        if (c == std::string::npos) { error = "línea " + std::to_string(nLinea) + ": falta la expresión"; return false; }
+        size_t d = linea.find_last_not_of(" \t");
+        ReglaLexica r{linea.substr(a, b - a), linea.substr(c, d + 1 - c), 0, nLinea};
+        if (r.nombre == "-") r.acepta = AutomataLexico::ACEPTA_IGNORAR;
+        for (int t = 0; t < (int)TokenType::FIN && !r.acepta; t++)
+            if (r.nombre == nombreTipoToken((TokenType)t)) r.acepta = (uint16_t)(AutomataLexico::ACEPTA_TOKEN + t);
+        if (!r.acepta) { error = "línea " + std::to_string(nLinea) + ": '" + r.nombre + "' no es un tipo de token"; return false; }
+        reglas.push_back(r);
+    }
+    if (reglas.empty()) { error = "no hay definiciones de tokens"; return false; }
+    return true;
+}
+
+inline bool leerEspecLexica(const std::string &ruta, std::vector<ReglaLexica> &reglas, std::string &error){
+    std::ifstream f(ruta);
+    if (!f) { error = "No se puede abrir el archivo de tokens: " + ruta; return false; }
+    return leerEspecLexica(f, reglas, error);
+}
+
+/* ------------------ Construcción ------------------ */
+struct TablaLexica {
+    std::vector<uint8_t> clase;
+    std::vector<uint16_t> fila;
+    uint32_t nClases = 0, nEstados = 0, inicial = 0;
+    size_t estadosAFN = 0, estadosAFD = 0; // antes de minimizar
+
+    AutomataLexico vista() const { return AutomataLexico{clase.data(), fila.data(), nClases, nEstados, inicial}; }
+    size_t bytes() const { return clase.size() + fila.size() * sizeof(uint16_t); }
+};
+
+class ConstructorLexico {
+public:
+    bool construir(const std::vector<ReglaLexica> &reglas, TablaLexica &t, std::string &error){
+        afn.clear();
+        conjuntos.clear();
+        int inicio = nuevo(), libre = inicio; // cadena de estados con dos salidas vacías
+        for (size_t r = 0; r < reglas.size(); r++) {
+            expr = reglas[r].expresion;
+            k = 0;
+            Fragmento fr;
+            if (!alternativa(fr, error) || (k < expr.size() && fallar("')' sin abrir", error))) {
+                error = "línea " + std::to_string(reglas[r].linea) + ": " + error;
+                return false;
+            }
+            afn[fr.fin].regla = (int)r;
+            enlazar(libre, fr.ini);
+            int sig = nuevo();
+            enlazar(libre, sig);
+            libre = sig;
+        }
+        clasesDeBytes(t);
+        if (!determinizar(inicio, reglas, t, error)) return false;
+        minimizar(t);
+        return tablas(t, error);
+    }
+
+private:
+    // Cada estado tiene hasta dos transiciones vacías o una por un conjunto
+    // de bytes (índice en 'conjuntos').
+    struct EstadoAFN { int eps[2] = {-1, -1}; int conjunto = -1, destino = -1, regla = -1; };
+    struct Fragmento { int ini, fin; };
+    typedef std::bitset<256> Bytes;
+
+    std::vector<EstadoAFN> afn;
+    std::vector<Bytes> conjuntos;
+    std::string expr;
+    size_t k = 0;
+    std::vector<int> claseDe;       // clase de cada byte
+    std::vector<int> representante; // un byte de cada clase
+    std::vector<std::vector<int>> delta; // AFD: [estado][clase]
+    std::vector<uint16_t> acepta;        // AFD: celda de aceptación
+    int inicial = 1;
+
+    int nuevo(){ afn.emplace_back(); return (int)afn.size() - 1; }
+    void enlazar(int a, int b){ afn[a].eps[afn[a].eps[0] < 0 ? 0 : 1] = b; }
+    bool fallar(const std::string &m, std::string &error){ error = m + " en la posición " + std::to_string(k + 1) + " de '" + expr + "'"; return true; }
+
+    Fragmento hoja(const Bytes &b){
+        Fragmento fr{nuevo(), nuevo()};
+        conjuntos.push_back(b);
+        afn[fr.ini].conjunto = (int)conjuntos.size() - 1;
+        afn[fr.ini].destino = fr.fin;
+        return fr;
+    }
+
+    /* ---- Expresiones: alternativa := secuencia ('|' secuencia)* ---- */
+    bool alternativa(Fragmento &fr, std::string &error){
+        if (!secuencia(fr, error)) return false;
+        while (k < expr.size() && expr[k] == '|') {
+            k++;
+            Fragmento b;
+            if (!secuencia(b, error)) return false;
+            Fragmento u{nuevo(), nuevo()};
+            enlazar(u.ini, fr.ini); enlazar(u.ini, b.ini);
+            enlazar(fr.fin, u.fin); enlazar(b.fin, u.fin);
+            fr = u;
+        }
+        return true;
+    }
+
+    bool secuencia(Fragmento &fr, std::string &error){
+        fr.ini = fr.fin = nuevo();
+        while (k < expr.size() && expr[k] != '|' && expr[k] != ')') {
+            Fragmento b;
+            if (!repeticion(b, error)) return false;
+            enlazar(fr.fin, b.ini);
+            fr.fin = b.fin;
+        }
+        return true;
+    }
+
+    bool repeticion(Fragmento &fr, std::string &error){
+        if (!atomo(fr, error)) return false;
+        while (k < expr.size() && (expr[k] == '*' || expr[k] == '+' || expr[k] == '?')) {
+            char op = expr[k++];
+            Fragmento u{nuevo(), nuevo()};
+            enlazar(u.ini, fr.ini);
+            if (op != '+') enlazar(u.ini, u.fin);
+            if (op != '?') enlazar(fr.fin, fr.ini);
+            enlazar(fr.fin, u.fin);
+            fr = u;
+        }
+        return true;
+    }
+
+    bool escape(unsigned char &c, std::string &error){
+        if (++k >= expr.size()) return !fallar("'\\' al final", error);
+        switch (expr[k]) {
+            case 't': c = '\t'; break;
+            case 'n': c = '\n'; break;
+            case 'v': c = '\v'; break;
+            case 'f': c = '\f'; break;
+            case 'r': c = '\r'; break;
+            default: c = (unsigned char)expr[k];
+        }
+        k++;
+        return true;
+    }
+
+    bool atomo(Fragmento &fr, std::string &error){
+        unsigned char c = (unsigned char)expr[k];
+        Bytes b;
+        if (c == '(') {
+            k++;
+            if (!alternativa(fr, error)) return false;
+            if (k >= expr.size() || expr[k] != ')') return !fallar("falta ')'", error);
+            k++;
+            return true;
+        }
+        if (c == '*' || c == '+' || c == '?') return !fallar("operador sin operando", error);
+        if (c == '.') { b.set(); b.reset('\n'); k++; }
+        else if (c == '\\') { if (!escape(c, error)) return false; b.set(c); }
+        else if (c == '[') { if (!clase(b, error)) return false; }
+        else { b.set(c); k++; }
+        fr = hoja(b);
+        return true;
+    }
+
+    // [abc], [a-z0-9], [^"]; ']' y '-' se escapan con '\'.
+    bool clase(Bytes &b, std::string &error){
+        bool negada = ++k < expr.size() && expr[k] == '^';
+        if (negada) k++;
+        while (k < expr.size() && expr[k] != ']') {
+            unsigned char lo = (unsigned char)expr[k], hi;
+            if (lo == '\\') { if (!escape(lo, error)) return false; } else k++;
+            hi = lo;
+            if (k + 1 < expr.size() && expr[k] == '-' && expr[k + 1] != ']') {
+                hi = (unsigned char)expr[++k];
+                if (hi == '\\') { if (!escape(hi, error)) return false; } else k++;
+                if (hi < lo) return !fallar("rango invertido", error);
+            }
+            for (int x = lo; x <= hi; x++) b.set(x);
+        }
+        if (k >= expr.size()) return !fallar("falta ']'", error);
+        k++;
+        if (negada) b.flip();
+        return true;
+    }
+
+    /* ---- Clases de bytes ---- */
+    // Dos bytes van a la misma clase si pertenecen a los mismos conjuntos.
+    void clasesDeBytes(TablaLexica &t){
+        std::map<std::vector<bool>, int> firmas;
+        claseDe.assign(256, 0);
+        representante.clear();
+        for (int c = 0; c < 256; c++) {
+            std::vector<bool> firma(conjuntos.size());
+            for (size_t j = 0; j < conjuntos.size(); j++) firma[j] = conjuntos[j][c];
+            auto it = firmas.emplace(firma, (int)firmas.size()).first;
+            if (it->second == (int)representante.size()) representante.push_back(c);
+            claseDe[c] = it->second;
+        }
+        t.nClases = (uint32_t)representante.size();
+        t.estadosAFN = afn.size();
+    }
+
+    /* ---- Subconjuntos ---- */
+    void cerradura(std::vector<int> &s, std::vector<char> &visto) const {
+        std::vector<int> pila(s);
+        for (int x : s) visto[x] = 1;
+        while (!pila.empty()) {
+            int x = pila.back();
+            pila.pop_back();
+            for (int y : afn[x].eps)
+                if (y >= 0 && !visto[y]) { visto[y] = 1; s.push_back(y); pila.push_back(y); }
+        }
+        for (int x : s) visto[x] = 0;
+        std::sort(s.begin(), s.end());
+    }
+
+    bool determinizar(int inicio, const std::vector<ReglaLexica> &reglas, TablaLexica &t, std::string &error){
+        std::map<std::vector<int>, int> id;
+        std::vector<std::vector<int>> estados;
+        std::vector<char> visto(afn.size(), 0);
+        auto agregar = [&](std::vector<int> &s){
+            auto it = id.find(s);
+            if (it != id.end()) return it->second;
+            int r = (int)estados.size(), mejor = -1;
+            for (int x : s)
+                if (afn[x].regla >= 0 && (mejor < 0 || afn[x].regla < mejor)) mejor = afn[x].regla;
+            id.emplace(s, r);
+            estados.push_back(s);
+            delta.emplace_back(t.nClases, 0);
+            acepta.push_back(mejor < 0 ? 0 : reglas[mejor].acepta);
+            return r;
+        };
+        delta.clear();
+        acepta.clear();
+        std::vector<int> s;
+        agregar(s); // 0: muerto
+        s.push_back(inicio);
+        cerradura(s, visto);
+        agregar(s);
+        if (acepta[1]) {
+            for (int x : estados[1])
+                if (afn[x].regla >= 0) { error = "línea " + std::to_string(reglas[afn[x].regla].linea) + ": la expresión acepta la cadena vacía"; break; }
+            return false;
+        }
+        for (size_t e = 1; e < estados.size(); e++)
+            for (uint32_t c = 0; c < t.nClases; c++) {
+                std::vector<int> m;
+                for (int x : estados[e])
+                    if (afn[x].conjunto >= 0 && conjuntos[afn[x].conjunto][representante[c]]) m.push_back(afn[x].destino);
+                if (m.empty()) continue;
+                cerradura(m, visto);
+                int d = agregar(m);
+                delta[e][c] = d;
+            }
+        t.estadosAFD = estados.size();
+        return true;
+    }
+
+    /* ---- Hopcroft ---- */
+    // Bloques iniciales: uno por celda de aceptación (el muerto cae con los
+    // que no aceptan). Cada bloque que sale de la lista de pendientes parte a
+    // los demás según sus predecesores por cada clase; de un bloque partido
+    // que no estaba pendiente se agrega sólo la mitad más chica.
+    void minimizar(TablaLexica &t){
+        const int n = (int)delta.size(), C = (int)t.nClases;
+        // Predecesores por (destino, clase) en un arreglo compacto.
+        std::vector<int> inicioPred((size_t)n * C + 1, 0), pred((size_t)n * C);
+        for (int e = 0; e < n; e++) for (int c = 0; c < C; c++) inicioPred[(size_t)delta[e][c] * C + c + 1]++;
+        for (size_t j = 1; j < inicioPred.size(); j++) inicioPred[j] += inicioPred[j - 1];
+        std::vector<int> lleno(inicioPred.begin(), inicioPred.end() - 1);
+        for (int e = 0; e < n; e++) for (int c = 0; c < C; c++) pred[lleno[(size_t)delta[e][c] * C + c]++] = e;
+
+        std::vector<int> bloque(n);
+        std::vector<std::vector<int>> miembros;
+        std::map<uint16_t, int> porAcepta;
+        for (int e = 0; e < n; e++) {
+            auto it = porAcepta.emplace(acepta[e], (int)miembros.size()).first;
+            if (it->second == (int)miembros.size()) miembros.emplace_back();
+            bloque[e] = it->second;
+            miembros[it->second].push_back(e);
+        }
+        std::vector<int> pendientes;
+        std::vector<char> pendiente(miembros.size(), 1);
+        for (size_t b = 0; b < miembros.size(); b++) pendientes.push_back((int)b);
+
+        std::vector<char> marcado(n, 0);
+        std::vector<int> tocados, cuenta;
+        while (!pendientes.empty()) {
+            int a = pendientes.back();
+            pendientes.pop_back();
+            pendiente[a] = 0;
+            std::vector<int> A = miembros[a];
+            for (int c = 0; c < C; c++) {
+                std::vector<int> X;
+                for (int d : A)
+                    for (int j = inicioPred[(size_t)d * C + c]; j < inicioPred[(size_t)d * C + c + 1]; j++)
+                        if (!marcado[pred[j]]) { marcado[pred[j]] = 1; X.push_back(pred[j]); }
+                cuenta.resize(miembros.size(), 0);
+                for (int e : X) if (cuenta[bloque[e]]++ == 0) tocados.push_back(bloque[e]);
+                for (int y : tocados) {
+                    if (cuenta[y] < (int)miembros[y].size()) { // se parte: los marcados van a un bloque nuevo
+                        int z = (int)miembros.size();
+                        miembros.emplace_back();
+                        std::vector<int> quedan;
+                        for (int e : miembros[y]) (marcado[e] ? miembros[z] : quedan).push_back(e);
+                        miembros[y].swap(quedan);
+                        for (int e : miembros[z]) bloque[e] = z;
+                        pendiente.push_back(0);
+                        cuenta.push_back(0);
+                        int agregar = pendiente[y] || miembros[z].size() <= miembros[y].size() ? z : y;
+                        pendiente[agregar] = 1;
+                        pendientes.push_back(agregar);
+                    }
+                    cuenta[y] = 0;
+                }
+                tocados.clear();
+                for (int e : X) marcado[e] = 0;
+            }
+        }
+
+        // Un estado por bloque: el del muerto queda en 0 y el resto en el
+        // orden en que se alcanzan desde el inicial.
+        std::vector<int> nuevoId(miembros.size(), -1), orden;
+        nuevoId[bloque[0]] = 0;
+        orden.push_back(bloque[0]);
+        if (bloque[1] != bloque[0]) { nuevoId[bloque[1]] = 1; orden.push_back(bloque[1]); }
+        inicial = nuevoId[bloque[1]];
+        for (size_t j = 1; j < orden.size(); j++) {
+            int e = miembros[orden[j]][0];
+            for (int c = 0; c < C; c++) {
+                int b = bloque[delta[e][c]];
+                if (nuevoId[b] < 0) { nuevoId[b] = (int)orden.size(); orden.push_back(b); }
+            }
+        }
+        std::vector<std::vector<int>> d2(orden.size(), std::vector<int>(C, 0));
+        std::vector<uint16_t> a2(orden.size());
+        for (size_t j = 0; j < orden.size(); j++) {
+            int e = miembros[orden[j]][0];
+            for (int c = 0; c < C; c++) d2[j][c] = nuevoId[bloque[delta[e][c]]];
+            a2[j] = acepta[e];
+        }
+        delta.swap(d2);
+        acepta.swap(a2);
+    }
+
+    bool tablas(TablaLexica &t, std::string &error){
+        const size_t R = t.nClases + 1;
+        t.nEstados = (uint32_t)delta.size();
+        if (t.nEstados * R * 2 > UINT16_MAX) { error = "el autómata mínimo tiene " + std::to_string(t.nEstados) + " estados: no cabe en filas de 16 bits"; return false; }
+        t.clase.assign(claseDe.begin(), claseDe.end());
+        t.fila.assign(t.nEstados * R, 0);
+        for (size_t e = 0; e < t.nEstados; e++) {
+            for (size_t c = 0; c < t.nClases; c++) t.fila[e * R + c] = (uint16_t)(delta[e][c] * R * 2 + (acepta[delta[e][c]] != 0));
+            t.fila[e * R + t.nClases] = acepta[e];
+        }
+        t.inicial = (uint32_t)(inicial * R);
+        return true;
+    }
+};
+
+inline bool construirLexico(const std::vector<ReglaLexica> &reglas, TablaLexica &t, std::string &error){
+    return ConstructorLexico().construir(reglas, t, error);
+}
+
+inline bool cargarLexico(const std::string &ruta, TablaLexica &t, std::string &error){
+    std::vector<ReglaLexica> reglas;
+    return leerEspecLexica(ruta, reglas, error) && construirLexico(reglas, t, error);
+}
+
+inline void reporteLexico(const TablaLexica &t, std::ostream &os){
+    os << "Léxico: AFN de " << t.estadosAFN << " estados, AFD de " << t.estadosAFD << ", mínimo de " << t.nEstados
+       << " (con el muerto), " << t.nClases << " clases de bytes, " << t.bytes() << " bytes de tablas\n";
+}
+
+/* ------------------ Tablas como código ------------------ */
+// Encabezado con las tablas constexpr; 'origen' queda en el comentario.
+inline void escribirLexerGenerado(std::ostream &os, const TablaLexica &t, const std::string &origen){
+    const size_t R = t.nClases + 1;
+    os << "// lexer_generado.h\n"
+       << "// GENERADO por generadorlexico a partir de " << origen << "; no editar.\n"
+       << "// " << t.nEstados << " estados, " << t.nClases << " clases de bytes (automata_lexico.h).\n"
+       << "#ifndef LEXER_GENERADO_H\n#define LEXER_GENERADO_H\n\n"
+       << "#include \"automata_lexico.h\"\n\n"
+       << "namespace lexer_generado {\n\n"
+       << "inline constexpr uint8_t CLASE[256] = {";
+    for (int c = 0; c < 256; c++) os << (c % 32 ? " " : "\n    ") << (int)t.clase[c] << ",";
+    os << "\n};\n\n"
+       << "// Una fila por estado: destino (2 * inicio de fila + acepta) por clase y, al final, lo que acepta.\n"
+       << "inline constexpr uint16_t FILA[" << t.fila.size() << "] = {";
+    for (size_t e = 0; e < t.nEstados; e++) {
+        os << "\n    ";
+        for (size_t c = 0; c < R; c++) os << t.fila[e * R + c] << (c + 1 < R ? ", " : ",");
+    }
+    os << "\n};\n\n"
+       << "inline constexpr AutomataLexico AUTOMATA{CLASE, FILA, " << t.nClases << ", " << t.nEstados << ", " << t.inicial << "};\n\n"
+       << "} // namespace lexer_generado\n\n#endif\n";
+}
+
+#endif
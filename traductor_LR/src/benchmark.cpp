@@ -0,0 +1,686 @@
+// benchmark.cpp
+// Mediciones de rendimiento del traductor sobre entradas sintéticas de varios MB.
+// Compilar: g++ -std=c++17 -O2 -pthread benchmark.cpp -o benchmark
+// Ejecutar: ./benchmark compilador.lr compilador.inf [--mb 8] [--lexico compilador.lex]
+//           ./benchmark --verificar-lexer [compilador.lex]   (prueba diferencial Lexer vs LexerRapido, LexerFlujo y
+//               lexerParalelo; con el .lex también LexerDFA y lexer_generado.h)
+//           ./benchmark --verificar-incremental compilador.lr compilador.inf
+//           ./benchmark --verificar-lalr compilador.lr compilador.inf   (tabla generada por lalr.h frente a la del .lr)
+//           ./benchmark --verificar-tabla compilador.lr compilador.inf  (accion() de la tabla compacta frente a la densa)
+//           ./benchmark --suite compilador.lr compilador.inf [--tokens N] [--json salida.json]
+//               (programas de generador.h con varios perfiles; resultados en JSON)
+//           ./benchmark --verificar-directo compilador.lr compilador.inf (parser_generado.h frente a analizarLR)
+//           ./benchmark --verificar-arbol compilador.lr compilador.inf (ida y vuelta del árbol en binario, JSON y ASCII)
+//           ./benchmark --verificar-semantica compilador.lr compilador.inf [--declaraciones N]
+//               (errores esperados en programas chicos y costo por declaración a tres tamaños)
+//           ./benchmark --verificar-atajos compilador.lr compilador.inf
+//               (mismo árbol y diagnóstico con y sin atajos de reducción; pasos por token)
+//           ./benchmark --verificar-optimizacion compilador.lr compilador.inf
+//               (el árbol de optimizar.h da los mismos errores semánticos y la misma ejecución en la VM)
+//           ./benchmark --carga <socket> [--conexiones C] [--peticiones N] [--kb K] [--modo check|nodos|arbol|json|bin] [--fin]
+//               (generador de carga para traductor --servidor: latencia p50/p99 por petición)
+// Las pruebas --verificar-X están junto a cada módulo, en <modulo>_verificar.h,
+// y comparten el conteo de casos y los generadores de verificacion.h.
+
+#include <bits/stdc++.h>
+#include "arbol.h"
+#include "automata_lexico.h"
+#include "estadisticas.h"
+#include "flujo.h"
+#include "generador.h"
+#include "gramatica.h"
+#include "gramatica_verificar.h"
+#include "hilos.h"
+#include "incremental.h"
+#include "incremental_verificar.h"
+#include "lalr.h"
+#include "lalr_verificar.h"
+#include "lexer.h"
+#include "lexer_paralelo.h"
+#include "lexer_rapido.h"
+#include "lexer_verificar.h"
+#include "optimizar.h"
+#include "optimizar_verificar.h"
+#include "parser.h"
+#include "parser_paralelo.h"
+#include "parser_verificar.h"
+#include "semantica.h"
+#include "semantica_verificar.h"
+#include "serializar.h"
+#include "serializar_verificar.h"
+#include "servidor.h"
+#include "tuberia.h"
+#include "verificacion.h"
+#include "vm.h"
+#if __has_include("gramatica_embebida.h") // ./compilartabla --embebida compilador.lr compilador.inf gramatica_embebida.h
+#include "gramatica_embebida.h"
+#define HAY_GRAMATICA_EMBEBIDA
+#endif
+#if __has_include("lexer_generado.h") // ./generadorlexico compilador.lex lexer_generado.h
+#include "lexer_generado.h"
+#define HAY_LEXER_GENERADO
+#endif
+#if __has_include("parser_generado.h") // ./generarparser compilador.lr compilador.inf parser_generado.h
+#include "parser_generado.h"
+#define HAY_PARSER_DIRECTO
+#endif
+using namespace std;
+
+/* ------------------ Reconocedores ------------------ */
+// Recorren la tabla igual que parseLR pero sin construir el árbol.
+
+// Antes: clave std::string por token y búsqueda en unordered_map<string,int>.
+static bool reconocerConClaves(const LRGram &G, const unordered_map<string,int> &mapa, const string &entrada, size_t &tokens){
+    Lexer lx(entrada);
+    vector<int> estados{0};
+    Token tk = lx.next();
+    tokens = 1;
+    while(true){
+        string key = tokenToKey(tk.type);
+        auto it = mapa.find(key);
+        if(it == mapa.end()) return false;
+        int accion = G.accion(estados.back(), it->second);
+        if(accion > 0){ estados.push_back(accion); tk = lx.next(); tokens++; }
+        else if(accion == -1) return key == "$";
+        else if(accion < 0){
+            int regla = -accion - 1;
+            estados.resize(estados.size() - G.lonRegla[regla-1]);
+            estados.push_back(G.accion(estados.back(), G.idRegla[regla-1]));
+        } else return false;
+    }
+}
+
+// Después: columna precalculada por tipo de token (reconocerLR de parser.h,
+// que además usa LexerRapido).
+
+// Sólo el lexer, para separar su costo del de la tabla.
+template<class L>
+static size_t contarTokens(const string &entrada){
+    L lx(entrada);
+    size_t tokens = 1;
+    while(lx.next().type != TokenType::FIN) tokens++;
+    return tokens;
+}
+
+static void reportar(const char *nombre, size_t tokens, size_t bytes, double seg){
+    printf("%-28s %10.2f Mtokens/s %9.1f MB/s  (%.3f s)\n", nombre, tokens / seg / 1e6, bytes / seg / 1e6, seg);
+}
+
+/* ------------------ Escritura del árbol ------------------ */
+// Sumidero que sólo cuenta bytes: mide a los escritores sin guardar la salida.
+class SumideroNulo : public streambuf {
+public:
+    uint64_t bytes = 0;
+protected:
+    int overflow(int c) override { bytes++; return c == EOF ? 0 : c; }
+    streamsize xsputn(const char*, streamsize n) override { bytes += (uint64_t)n; return n; }
+};
+
+/* ------------------ Micro-benchmarks de la VM ------------------ */
+// Programas chicos que ejercitan ciclos, recursión, llamadas y aritmética
+// entera y real. Cada uno tiene su equivalente en C++ como referencia (y
+// para comprobar el resultado); 'n' viene de una variable volatile para que
+// el compilador no resuelva el ciclo nativo en tiempo de compilación.
+static bool medirVM(const LRGram &G, ostringstream &js){
+    static volatile int64_t escala = 1;
+    struct Micro { const char *nombre; string fuente; function<ValorBC()> nativo; };
+    auto entero = [](int64_t v){ ValorBC x; x.i = v; return x; };
+    auto real = [](double v){ ValorBC x; x.f = v; return x; };
+    vector<Micro> micros = {
+        {"bucle", "int main() { int i, s, n; n = 30000000; i = 0; s = 0;\n"
+                  "  while (i < n) { s = s + i; i = i + 1; }\n  return s; }\n",
+         [&]{ int64_t s = 0, n = 30000000 * escala; for(int64_t i=0;i<n;i++) s += i; return entero(s); }},
+        {"fib", "int fib(int n) { if (n < 2) return n; return fib(n - 1) + fib(n - 2); }\n"
+                "int main() { return fib(30); }\n",
+         [&]{ function<int64_t(int64_t)> fib = [&](int64_t n) -> int64_t { return n < 2 ? n : fib(n - 1) + fib(n - 2); }; return entero(fib(30 * escala)); }},
+        {"llamadas", "int suma(int a, int b) { return a + b; }\n"
+                     "int main() { int i, s, n; n = 10000000; i = 0; s = 0;\n"
+                     "  while (i < n) { s = suma(s, i); i = i + 1; }\n  return s; }\n",
+         [&]{ int64_t s = 0, n = 10000000 * escala; for(int64_t i=0;i<n;i++) s += i; return entero(s); }},
+        {"flotante", "float main() { int i, n; float x; n = 20000000; i = 0; x = 0.0;\n"
+                     "  while (i < n) { x = x * 0.999 + 1.5; i = i + 1; }\n  return x; }\n",
+         [&]{ double x = 0; int64_t n = 20000000 * escala; for(int64_t i=0;i<n;i++) x = x * 0.999 + 1.5; return real(x); }},
+        {"primos", "int main() { int p, d, primo, total; total = 0; p = 2;\n"
+                   "  while (p < 60000) { primo = 1; d = 2;\n"
+                   "    while (d * d <= p && primo) { if (p - p / d * d == 0) primo = 0; d = d + 1; }\n"
+                   "    total = total + primo; p = p + 1; }\n  return total; }\n",
+         [&]{ int64_t total = 0; for(int64_t p=2;p<60000*escala;p++){ bool primo = true; for(int64_t d=2;d*d<=p && primo;d++) if(p % d == 0) primo = false; total += primo; } return entero(total); }},
+    };
+    bool ok = true;
+    for(size_t k=0;k<micros.size();k++){
+        const Micro &m = micros[k];
+        Arbol arbol;
+        ProgramaBC prog;
+        string error;
+        if(!parseLR(G, m.fuente, arbol, true).aceptada || !compilarBytecode(arbol, G, prog, error)){
+            fprintf(stderr, "Error: micro-benchmark %s: %s\n", m.nombre, error.c_str());
+            ok = false;
+            continue;
+        }
+        MaquinaBC vm(prog);
+        SumideroNulo nulo;
+        ostream os(&nulo);
+        ResultadoVM cuenta = vm.ejecutarContando(os), r;
+        double seg = mejorTiempo(3, [&]{ r = vm.ejecutar(os); });
+        ValorBC esperado{};
+        double segNativo = mejorTiempo(3, [&]{ esperado = m.nativo(); });
+        bool igual = r.ok && (r.tipo == TipoBC::REAL ? fabs(r.valor.f - esperado.f) <= 1e-9 * fabs(esperado.f) : r.valor.i == esperado.i);
+        ok &= igual;
+        printf("vm %-10s %8.3f s %8.1f Minstr/s %5.2f ns/instr  nativo %.4f s (%.0fx)%s\n", m.nombre, seg,
+               cuenta.instrucciones / seg / 1e6, seg * 1e9 / cuenta.instrucciones, segNativo, seg / segNativo, igual ? "" : "  RESULTADO DISTINTO");
+        char buf[512];
+        snprintf(buf, sizeof buf, "{\"programa\": \"%s\", \"seg\": %.6f, \"instrucciones\": %llu, \"instr_s\": %.0f, "
+                 "\"bytecode\": %zu, \"nativo_seg\": %.6f, \"correcto\": %s}", m.nombre, seg, (unsigned long long)cuenta.instrucciones,
+                 cuenta.instrucciones / seg, prog.codigo.size(), segNativo, igual ? "true" : "false");
+        js << (k ? "," : "") << "\n    " << buf;
+    }
+    return ok;
+}
+
+/* ------------------ Suite con programas generados ------------------ */
+// Memoria residente de /proc/self/status en KB (-1 si no está disponible).
+static long leerStatusKB(const char *campo){
+    ifstream f("/proc/self/status");
+    size_t n = strlen(campo);
+    for(string l; getline(f, l);) if(l.compare(0, n, campo) == 0) return atol(l.c_str() + n);
+    return -1;
+}
+// Lleva el pico (VmHWM) a la RSS actual, para medir el pico de cada fase.
+static bool reiniciarPicoRSS(){
+    ofstream f("/proc/self/clear_refs");
+    return (bool)(f << "5" << flush);
+}
+
+struct ContarAcciones {
+    size_t desplazamientos = 0, reducciones = 0;
+    void desplazar(const Token&){ desplazamientos++; }
+    void reducir(int, int){ reducciones++; }
+    void aceptar(){}
+};
+
+struct ResultadoFase {
+    string nombre;
+    double seg = 0;
+    size_t bytes = 0, tokens = 0, reducciones = 0, memoria = 0;
+    long rssBaseKB = -1, rssPicoKB = -1;
+};
+
+template<class F>
+static ResultadoFase medirFase(const char *nombre, size_t bytes, size_t tokens, F f){
+    ResultadoFase r;
+    r.nombre = nombre;
+    r.bytes = bytes;
+    r.tokens = tokens;
+    bool porFase = reiniciarPicoRSS();
+    r.rssBaseKB = leerStatusKB("VmRSS:");
+    r.seg = mejorTiempo(3, f);
+    r.rssPicoKB = leerStatusKB("VmHWM:");
+    if(!porFase) r.rssBaseKB = -1; // el pico es el de todo el proceso
+    return r;
+}
+
+static string faseJSON(const ResultadoFase &r){
+    auto num = [](long v){ return v < 0 ? string("null") : to_string(v); };
+    char buf[512];
+    snprintf(buf, sizeof buf,
+        "{\"fase\": \"%s\", \"seg\": %.6f, \"bytes\": %zu, \"tokens\": %zu, \"mb_s\": %.2f, \"tokens_s\": %.0f, "
+        "\"reducciones\": %zu, \"reducciones_s\": %.0f, \"memoria_bytes\": %zu, \"rss_base_kb\": %s, \"rss_pico_kb\": %s}",
+        r.nombre.c_str(), r.seg, r.bytes, r.tokens, r.bytes / r.seg / 1e6, r.tokens / r.seg,
+        r.reducciones, r.reducciones / r.seg, r.memoria, num(r.rssBaseKB).c_str(), num(r.rssPicoKB).c_str());
+    return buf;
+}
+
+// Mide lexer, parseLR e impresión del árbol por separado sobre programas
+// generados con distintos perfiles, y escribe los resultados en JSON.
+static int ejecutarSuite(int argc, char **argv){
+    size_t tokens = 1000000, tokensImpresion = 5000;
+    string rutaJSON;
+    for(int i=4;i<argc;i++){
+        string arg = argv[i];
+        if(arg == "--tokens" && i+1 < argc) tokens = (size_t)atoll(argv[++i]);
+        else if(arg == "--json" && i+1 < argc) rutaJSON = argv[++i];
+    }
+    LRGram G;
+    if(!cargarLR(argv[2], G) || !leerInf(argv[3], G)) return 1;
+    resolverTokens(G);
+    GramaticaBNF g;
+    string error;
+    if(!leerProducciones(argv[3], g, error)){ fprintf(stderr, "Error: %s\n", error.c_str()); return 1; }
+    GeneradorProgramas gen(g);
+
+    struct Perfil { const char *nombre; int anidamiento, complejidad; };
+    const Perfil perfiles[] = {{"plano", 1, 1}, {"tipico", 3, 3}, {"anidado", 8, 2}, {"expresiones", 2, 8}};
+    ostringstream js;
+    js << "{\n  \"version\": 1,\n  \"fecha\": " << (long long)time(nullptr) << ",\n  \"compilador\": \"" << __VERSION__
+       << "\",\n  \"tokens_pedidos\": " << tokens << ",\n  \"perfiles\": [";
+    bool ok = true;
+    for(size_t k=0;k<sizeof perfiles / sizeof *perfiles;k++){
+        const Perfil &pf = perfiles[k];
+        OpcionesGenerador op;
+        op.tokens = tokens;
+        op.anidamiento = pf.anidamiento;
+        op.complejidad = pf.complejidad;
+        op.semilla = 1234 + (uint32_t)k;
+        string entrada;
+        vector<ResultadoFase> fases;
+        fases.push_back(medirFase("generador", 0, 0, [&]{ entrada = gen.generar(op); }));
+        fases.back().bytes = entrada.size();
+        fases.back().tokens = gen.tokens();
+        size_t nTok = 0;
+        fases.push_back(medirFase("lexer", entrada.size(), 0, [&]{ nTok = contarTokens<Lexer>(entrada); }));
+        fases.back().tokens = nTok;
+        size_t nTokRapido = 0;
+        fases.push_back(medirFase("lexer_rapido", entrada.size(), nTok, [&]{ nTokRapido = contarTokens<LexerRapido>(entrada); }));
+        ok &= nTokRapido == nTok;
+        ContarAcciones cuenta;
+        LexerRapido lxCuenta(entrada);
+        ok &= analizarLR(G, lxCuenta, cuenta).aceptada;
+        fases.push_back(medirFase("reconocerLR", entrada.size(), nTok, [&]{ ok &= reconocerLR(G, entrada).aceptada; }));
+        fases.back().reducciones = cuenta.reducciones;
+        {
+            Arbol arbol;
+            fases.push_back(medirFase("parseLR", entrada.size(), nTok, [&]{ ok &= parseLR(G, entrada, arbol).aceptada; }));
+            fases.back().reducciones = cuenta.reducciones;
+            fases.back().memoria = arbol.bytes();
+            // JSON y binario son lineales en el número de nodos: se escriben
+            // con el programa completo ('bytes' es la salida).
+            for(FormatoArbol f : {FormatoArbol::JSON, FormatoArbol::BINARIO}){
+                SumideroNulo nulo;
+                ostream os(&nulo);
+                fases.push_back(medirFase(f == FormatoArbol::JSON ? "arbol_json" : "arbol_bin", 0, nTok, [&]{
+                    nulo.bytes = 0;
+                    escribirArbol(os, arbol, G, arbol.raiz, f);
+                }));
+                fases.back().bytes = nulo.bytes;
+                fases.back().memoria = arbol.bytes();
+            }
+        }
+        // La salida ASCII repite el prefijo de cada nivel en cada línea (y la
+        // lista de definiciones anida una por nivel), así que se imprime un
+        // programa más chico con el mismo perfil; 'bytes' es la salida.
+        {
+            OpcionesGenerador opImp = op;
+            opImp.tokens = min(tokens, tokensImpresion);
+            string chico = gen.generar(opImp);
+            Arbol arbol;
+            ok &= parseLR(G, chico, arbol).aceptada;
+            string texto;
+            fases.push_back(medirFase("impresion", 0, gen.tokens(), [&]{
+                ostringstream os;
+                imprimirArbolASCII(os, arbol, G, arbol.raiz);
+                texto = os.str();
+            }));
+            fases.back().bytes = texto.size();
+            fases.back().memoria = arbol.bytes();
+        }
+        printf("perfil %s (anidamiento %d, complejidad %d): %.1f MB, %zu tokens\n", pf.nombre, pf.anidamiento, pf.complejidad, entrada.size() / 1e6, nTok);
+        for(const ResultadoFase &r : fases){
+            printf("  %-14s %10.2f Mtokens/s %9.1f MB/s", r.nombre.c_str(), r.tokens / r.seg / 1e6, r.bytes / r.seg / 1e6);
+            if(r.reducciones) printf(" %8.2f Mred/s", r.reducciones / r.seg / 1e6);
+            if(r.memoria) printf("  AST %.1f MB", r.memoria / 1e6);
+            if(r.rssPicoKB >= 0) printf("  RSS pico %.1f MB", r.rssPicoKB / 1e3);
+            printf("\n");
+        }
+        js << (k ? "," : "") << "\n    {\"perfil\": \"" << pf.nombre << "\", \"anidamiento\": " << pf.anidamiento
+           << ", \"complejidad\": " << pf.complejidad << ", \"semilla\": " << op.semilla << ", \"fases\": [";
+        for(size_t i=0;i<fases.size();i++) js << (i ? "," : "") << "\n      " << faseJSON(fases[i]);
+        js << "\n    ]}";
+    }
+    js << "\n  ],\n  \"vm\": [";
+    bool vmOk = medirVM(G, js);
+    js << "\n  ]\n}\n";
+    if(rutaJSON.empty()) fputs(js.str().c_str(), stdout);
+    else {
+        ofstream f(rutaJSON);
+        if(!(f << js.str())){ fprintf(stderr, "Error: no se pudo escribir %s\n", rutaJSON.c_str()); return 1; }
+    }
+    if(!ok){ fprintf(stderr, "Error: un programa generado no fue aceptado\n"); return 1; }
+    if(!vmOk){ fprintf(stderr, "Error: un micro-benchmark de la VM falló o dio otro resultado\n"); return 1; }
+    return 0;
+}
+
+/* ------------------ Generador LALR(1) ------------------ */
+// n copias de la gramática con no-terminales propios, cada una detrás de un
+// terminal nuevo: inicio ::= t_k <programa_k>. Sirve para medir cómo crece la
+// generación con cientos de reglas.
+static GramaticaBNF escalarGramatica(const GramaticaBNF &g, int n){
+    GramaticaBNF e;
+    int T = g.nTerminales, N = g.nSimbolos() - T;
+    e.nombres.assign(g.nombres.begin(), g.nombres.begin() + T);
+    for(int k=0;k<n;k++) e.nombres.push_back("t" + to_string(k));
+    e.nTerminales = T + n;
+    e.fin = g.fin;
+    e.nombres.push_back("inicio");
+    for(int k=0;k<n;k++) for(int y=T;y<T+N;y++) e.nombres.push_back(g.nombres[y] + "_" + to_string(k));
+    auto mapa = [&](int s, int k){ return s < T ? s : T + n + 1 + k * N + (s - T); };
+    for(int k=0;k<n;k++) e.reglas.push_back(Produccion{T + n, {T + k, mapa(g.reglas[0].lhs, k)}});
+    for(int k=0;k<n;k++)
+        for(const Produccion &p : g.reglas){
+            Produccion q{mapa(p.lhs, k), {}};
+            for(int s : p.rhs) q.rhs.push_back(mapa(s, k));
+            e.reglas.push_back(q);
+        }
+    return e;
+}
+
+static void medirGeneracionLALR(const string &rutaInf){
+    GramaticaBNF g;
+    string error;
+    if(!leerProducciones(rutaInf, g, error)){ fprintf(stderr, "Error: %s\n", error.c_str()); return; }
+    for(int n : {1, 4, 16, 64}){
+        GramaticaBNF e = n == 1 ? g : escalarGramatica(g, n);
+        TablaLALR t;
+        double seg = mejorTiempo(3, [&]{ generarLALR(e, t, error); });
+        printf("LALR(1), %5zu reglas         %8.2f ms  (%d estados, %zu ítems, %zu conflictos)\n",
+               e.reglas.size(), seg * 1e3, t.nEstados, t.nItems, t.conflictos.size());
+    }
+}
+
+/* ------------------ MAIN ------------------ */
+/* ------------------ Generador de carga ------------------ */
+#ifdef SERVIDOR_UNIX
+// C conexiones en lazo cerrado (cada una manda la siguiente petición al
+// recibir la respuesta anterior) contra un traductor --servidor. La latencia
+// se mide en el cliente, de la escritura de la petición a la lectura completa
+// de la respuesta, así que incluye el socket y el cambio de contexto.
+static int generarCarga(int argc, char **argv){
+    string ruta = argv[2], modo = "nodos";
+    unsigned conexiones = 4;
+    size_t peticiones = 2000, kb = 4;
+    bool fin = false;
+    for(int i=3;i<argc;i++){
+        string arg = argv[i];
+        if(arg == "--conexiones" && i+1 < argc) conexiones = max(1, atoi(argv[++i]));
+        else if(arg == "--peticiones" && i+1 < argc) peticiones = (size_t)atoll(argv[++i]);
+        else if(arg == "--kb" && i+1 < argc) kb = (size_t)atoll(argv[++i]);
+        else if(arg == "--modo" && i+1 < argc) modo = argv[++i];
+        else if(arg == "--fin") fin = true;
+    }
+    auto conectar = [&ruta]{
+        sockaddr_un dir{};
+        dir.sun_family = AF_UNIX;
+        snprintf(dir.sun_path, sizeof dir.sun_path, "%s", ruta.c_str());
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if(fd >= 0 && connect(fd, (sockaddr*)&dir, sizeof dir) < 0){ close(fd); fd = -1; }
+        return fd;
+    };
+    // Una petición y su respuesta; devuelve false si la conexión se cortó.
+    auto pedir = [](int fd, LectorMarcos &lector, const string &m, const string &cuerpo, string &estado, string &respuesta){
+        string cab = "0 " + m + " " + to_string(cuerpo.size()) + "\n";
+        if(!escribirTodo(fd, cab.data(), cab.size()) || !escribirTodo(fd, cuerpo.data(), cuerpo.size())) return false;
+        string linea, id;
+        unsigned long long us = 0, lon = 0;
+        if(!lector.leerLinea(linea)) return false;
+        istringstream is(linea);
+        if(!(is >> id >> estado >> us >> lon)) return false;
+        return lector.leer(respuesta, (size_t)lon);
+    };
+
+    string entrada = generarEntrada(kb * 1000);
+    vector<vector<uint32_t>> lat(conexiones);
+    atomic<size_t> errores{0};
+    auto t0 = chrono::steady_clock::now();
+    vector<thread> hilos;
+    for(unsigned c=0;c<conexiones;c++) hilos.emplace_back([&, c]{
+        int fd = conectar();
+        if(fd < 0){ errores += peticiones; return; }
+        LectorMarcos lector(fd);
+        string estado, respuesta;
+        lat[c].reserve(peticiones);
+        for(size_t k=0;k<peticiones;k++){
+            auto a = chrono::steady_clock::now();
+            if(!pedir(fd, lector, modo, entrada, estado, respuesta)){ errores += peticiones - k; break; }
+            lat[c].push_back((uint32_t)chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - a).count());
+            if(estado != "OK") errores++;
+        }
+        close(fd);
+    });
+    for(auto &h : hilos) h.join();
+    double seg = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    vector<uint32_t> todas;
+    for(auto &v : lat) todas.insert(todas.end(), v.begin(), v.end());
+    if(todas.empty()){ fprintf(stderr, "Error: no se pudo conectar con %s\n", ruta.c_str()); return 1; }
+    sort(todas.begin(), todas.end());
+    auto pct = [&todas](double p){ return todas[min(todas.size() - 1, (size_t)(p / 100.0 * (double)(todas.size() - 1) + 0.5))]; };
+    printf("Carga: %u conexiones x %zu peticiones '%s' de %.1f KB, %zu errores\n", conexiones, peticiones, modo.c_str(), entrada.size() / 1e3, errores.load());
+    printf("  %.0f peticiones/s, %.1f MB/s\n", todas.size() / seg, todas.size() * entrada.size() / 1e6 / seg);
+    printf("  latencia en el cliente (us): p50 %u, p90 %u, p99 %u, max %u\n", pct(50), pct(90), pct(99), todas.back());
+
+    int fd = conectar();
+    if(fd >= 0){
+        LectorMarcos lector(fd);
+        string estado, respuesta;
+        if(pedir(fd, lector, "stats", "", estado, respuesta)){
+            istringstream is(respuesta);
+            for(string linea; getline(is, linea);) printf("  servidor: %s\n", linea.c_str());
+        }
+        if(fin) pedir(fd, lector, "fin", "", estado, respuesta);
+        close(fd);
+    }
+    return errores ? 1 : 0;
+}
+#endif
+
+// Pruebas diferenciales: cada una vive junto a su módulo (<modulo>_verificar.h)
+// y recibe la gramática ya cargada.
+static const struct { const char *opcion; int (*verificar)(ContextoVerificacion&); } verificadores[] = {
+    {"--verificar-incremental", verificarIncremental},
+    {"--verificar-lalr", verificarLALR},
+    {"--verificar-tabla", verificarTabla},
+    {"--verificar-directo", verificarDirecto},
+    {"--verificar-arbol", verificarSerializacion},
+    {"--verificar-semantica", verificarSemantica},
+    {"--verificar-atajos", verificarAtajos},
+    {"--verificar-optimizacion", verificarOptimizacion},
+};
+
+int main(int argc, char **argv){
+    if(argc >= 2 && string(argv[1]) == "--verificar-lexer") return verificarLexer(argc >= 3 ? argv[2] : "");
+#ifdef SERVIDOR_UNIX
+    if(argc >= 3 && string(argv[1]) == "--carga") return generarCarga(argc, argv);
+#endif
+    if(argc >= 4 && string(argv[1]) == "--suite") return ejecutarSuite(argc, argv);
+    for(auto &v : verificadores)
+        if(argc >= 4 && string(argv[1]) == v.opcion){
+            ContextoVerificacion c;
+            if(!c.cargar(argv[2], argv[3])) return 1;
+            c.opciones.assign(argv + 4, argv + argc);
+            return v.verificar(c);
+        }
+    if(argc < 3){
+        cerr << "Uso: " << argv[0] << " <archivo_gramatica.lr> <archivo_mapeo.inf> [--mb N] [--lexico <tokens.lex>]\n";
+        cerr << "     " << argv[0] << " --verificar-lexer [<tokens.lex>]\n";
+        cerr << "     " << argv[0] << " --verificar-incremental <archivo_gramatica.lr> <archivo_mapeo.inf>\n";
+        cerr << "     " << argv[0] << " --verificar-lalr <archivo_gramatica.lr> <archivo_mapeo.inf>\n";
+        cerr << "     " << argv[0] << " --verificar-tabla <archivo_gramatica.lr> <archivo_mapeo.inf>\n";
+        cerr << "     " << argv[0] << " --verificar-directo <archivo_gramatica.lr> <archivo_mapeo.inf>\n";
+        cerr << "     " << argv[0] << " --verificar-arbol <archivo_gramatica.lr> <archivo_mapeo.inf>\n";
+        cerr << "     " << argv[0] << " --verificar-semantica <archivo_gramatica.lr> <archivo_mapeo.inf> [--declaraciones N]\n";
+        cerr << "     " << argv[0] << " --verificar-atajos <archivo_gramatica.lr> <archivo_mapeo.inf>\n";
+        cerr << "     " << argv[0] << " --verificar-optimizacion <archivo_gramatica.lr> <archivo_mapeo.inf>\n";
+        cerr << "     " << argv[0] << " --suite <archivo_gramatica.lr> <archivo_mapeo.inf> [--tokens N] [--json salida.json]\n";
+        cerr << "     " << argv[0] << " --carga <socket> [--conexiones C] [--peticiones N] [--kb K] [--modo check|nodos|arbol|json|bin] [--fin]\n";
+        return 1;
+    }
+    double mb = 8;
+    string rutaLex;
+    for(int i=3;i<argc;i++){
+        string arg = argv[i];
+        if(arg == "--mb" && i+1 < argc) mb = atof(argv[++i]);
+        else if(arg == "--lexico" && i+1 < argc) rutaLex = argv[++i];
+    }
+
+    LRGram G;
+    auto tCarga = chrono::steady_clock::now();
+    if(!cargarLR(argv[1], G) || !leerInf(argv[2], G)) return 1;
+    resolverTokens(G);
+    double segCarga = chrono::duration<double>(chrono::steady_clock::now() - tCarga).count();
+    unordered_map<string,int> mapa; // como lo devolvía leerInf
+    for(int t=0;t<G.nTerminales;t++) mapa[G.cadenas + G.termNombre[t]] = G.termCol[t];
+
+    string entrada = generarEntrada((size_t)(mb * 1e6));
+    printf("Entrada: %.1f MB\n", entrada.size() / 1e6);
+    printf("Carga de la gramática (cargarLR + leerInf): %.0f us; el modo servidor la paga una sola vez\n", segCarga * 1e6);
+#ifdef HAY_GRAMATICA_EMBEBIDA
+    {
+        LRGram E;
+        auto t0 = chrono::steady_clock::now();
+        gramatica_embebida::cargar(E);
+        resolverTokens(E);
+        double us = chrono::duration<double>(chrono::steady_clock::now() - t0).count() * 1e6;
+        bool igual = huellaGramatica(E) == huellaGramatica(G) && reconocerLR(E, entrada).aceptada;
+        printf("Tablas embebidas (gramatica_embebida.h): %.2f us, sin E/S; misma tabla que el .lr: %s\n", us, igual ? "sí" : "NO");
+        if(!igual) return 1;
+    }
+#endif
+    medirGeneracionLALR(argv[2]);
+
+    size_t tokens = 0;
+    bool ok = true;
+    double seg = mejorTiempo(3, [&]{ tokens = contarTokens<Lexer>(entrada); });
+    reportar("lexer (referencia)", tokens, entrada.size(), seg);
+    seg = mejorTiempo(3, [&]{ tokens = contarTokens<LexerRapido>(entrada); });
+    reportar("lexer rápido (" LEXER_SIMD ")", tokens, entrada.size(), seg);
+    {
+        PoolTrabajo pool;
+        double segPar = mejorTiempo(3, [&]{ tokens = lexerParalelo(entrada, pool).size(); });
+        char nombre[64];
+        snprintf(nombre, sizeof nombre, "lexer paralelo (%u hilos)", pool.size());
+        reportar(nombre, tokens, entrada.size(), segPar);
+        printf("  frente al secuencial: %.2fx (incluye guardar los tokens)\n", seg / segPar);
+    }
+    {
+        // LexerDFA con el autómata del .lex (--lexico) y con el de lexer_generado.h.
+        TablaLexica lexico;
+        vector<pair<string, AutomataLexico>> automatas;
+        string error;
+        if(!rutaLex.empty()){
+            if(!cargarLexico(rutaLex, lexico, error)){ fprintf(stderr, "Error: %s\n", error.c_str()); return 1; }
+            automatas.push_back({"lexer DFA (" + rutaLex.substr(rutaLex.find_last_of('/') + 1) + ")", lexico.vista()});
+        }
+#ifdef HAY_LEXER_GENERADO
+        automatas.push_back({"lexer DFA (generado)", lexer_generado::AUTOMATA});
+#endif
+        for(auto &a : automatas){
+            double segDFA = mejorTiempo(3, [&]{
+                LexerDFA lx(a.second, entrada);
+                for(tokens = 1; lx.next().type != TokenType::FIN; tokens++){}
+            });
+            reportar(a.first.c_str(), tokens, entrada.size(), segDFA);
+        }
+    }
+    seg = mejorTiempo(3, [&]{ ok &= reconocerConClaves(G, mapa, entrada, tokens); });
+    reportar("claves string (antes)", tokens, entrada.size(), seg);
+    double segCheck = mejorTiempo(3, [&]{ ok &= reconocerLR(G, entrada).aceptada; });
+    reportar("reconocerLR (--check)", tokens, entrada.size(), segCheck);
+    Arbol arbol;
+    seg = mejorTiempo(3, [&]{ ok &= parseLR(G, entrada, arbol).aceptada; });
+    reportar("parseLR con árbol", tokens, entrada.size(), seg);
+    printf("  árbol: %zu nodos, %.1f MB; --check es %.2fx más rápido\n", arbol.nodos.size(), arbol.bytes() / 1e6, seg / segCheck);
+
+    // Parser directo (generarparser): mismo lexer y mismo constructor, sin
+    // consultar la tabla.
+#ifdef HAY_PARSER_DIRECTO
+    if(huellaGramatica(G) == parser_generado::HUELLA){
+        double segD = mejorTiempo(3, [&]{ ok &= parser_generado::reconocerLR(entrada).aceptada; });
+        reportar("parser directo (--check)", tokens, entrada.size(), segD);
+        printf("  frente a la tabla: %.2fx\n", segCheck / segD);
+        Arbol directo;
+        segD = mejorTiempo(3, [&]{ ok &= parser_generado::parseLR(entrada, directo).aceptada; });
+        reportar("parser directo con árbol", tokens, entrada.size(), segD);
+        bool igual = mismaArena(arbol, directo);
+        printf("  frente a la tabla: %.2fx; árbol idéntico: %s\n", seg / segD, igual ? "sí" : "NO");
+        ok &= igual;
+    } else printf("parser directo: parser_generado.h corresponde a otra tabla; se omite\n");
+#endif
+
+    // Análisis paralelo por definiciones: debe dar exactamente la misma arena.
+    {
+        PoolTrabajo pool;
+        Arbol par;
+        double segPar = mejorTiempo(3, [&]{ ok &= parseLRParalelo(G, entrada, par, pool).aceptada; });
+        char nombre[64];
+        snprintf(nombre, sizeof nombre, "parseLR paralelo (%u hilos)", pool.size());
+        reportar(nombre, tokens, entrada.size(), segPar);
+        bool igual = mismaArena(arbol, par);
+        printf("  frente al secuencial: %.2fx; árbol idéntico: %s\n", seg / segPar, igual ? "sí" : "NO");
+        ok &= igual;
+        // Con operadores (--optimizar, --ejecutar): misma arena que parseLR con operadores.
+        Arbol secOp, parOp;
+        ok &= parseLR(G, entrada, secOp, true).aceptada && parseLRParalelo(G, entrada, parOp, pool, true).aceptada;
+        igual = mismaArena(secOp, parOp);
+        printf("  con operadores, árbol idéntico: %s\n", igual ? "sí" : "NO");
+        ok &= igual;
+        // --check --paralelo: mismo diagnóstico que reconocerLR, también con errores.
+        double segRec = mejorTiempo(3, [&]{ ok &= reconocerLRParalelo(G, entrada, pool).aceptada; });
+        snprintf(nombre, sizeof nombre, "reconocerLR paralelo (%u hilos)", pool.size());
+        reportar(nombre, tokens, entrada.size(), segRec);
+        string corto = entrada.substr(0, min<size_t>(entrada.size(), 200000));
+        uint32_t x = 99991u;
+        int distintos = 0;
+        for(int k=0;k<20;k++){
+            x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+            string u = corto;
+            if(k) u.erase(x % u.size(), 1 + x % 3);
+            Diagnostico a = reconocerLR(G, u), b = reconocerLRParalelo(G, u, pool);
+            distintos += a.aceptada != b.aceptada || a.mensaje != b.mensaje;
+        }
+        printf("  frente al secuencial: %.2fx; diagnósticos distintos en 20 entradas: %d\n", segCheck / segRec, distintos);
+        ok &= distintos == 0;
+    }
+
+    // Reanálisis incremental: renombrar un identificador a mitad del archivo y
+    // volver atrás, con entradas de distinto tamaño.
+    for(double f : {0.01, 0.1, 1.0}){
+        string e = generarEntrada((size_t)(mb * 1e6 * f));
+        ParserIncremental inc;
+        ok &= inc.analizar(G, e).aceptada;
+        size_t p = e.find("float r;", e.size() / 2) + 6;
+        int reps = 200;
+        auto t0 = chrono::steady_clock::now();
+        for(int k=0;k<reps;k++){
+            ok &= inc.editar(G, {{p, 1, "s"}}).aceptada;
+            ok &= inc.editar(G, {{p, 1, "r"}}).aceptada;
+        }
+        double us = chrono::duration<double>(chrono::steady_clock::now() - t0).count() / (2 * reps) * 1e6;
+        Arbol completo;
+        double segCompleto = mejorTiempo(3, [&]{ ok &= parseLR(G, inc.texto(), completo).aceptada; });
+        ok &= mismoArbol(inc.arbol(), completo);
+        printf("incremental, %7.2f MB        %10.1f us/edición (completo %.1f ms, %.0fx); relexados %zu, reusados %zu, nuevos %zu\n",
+               e.size() / 1e6, us, segCompleto * 1e3, segCompleto * 1e6 / us,
+               inc.ultima().tokensRelexados, inc.ultima().nodosReusados, inc.ultima().nodosNuevos);
+    }
+
+    // Tubería: lexer y parser en hilos distintos. Sólo conviene con dos
+    // núcleos libres y cuando el parser no domina (p. ej. con árbol).
+    SoloReconocer nada;
+    double segT = mejorTiempo(3, [&]{ ok &= analizarEnTuberia(G, entrada, nada).aceptada; });
+    reportar("tubería (--check)", tokens, entrada.size(), segT);
+    printf("  frente a un hilo: %.2fx\n", segCheck / segT);
+    segT = mejorTiempo(3, [&]{ ConstruirArbol cons(arbol); ok &= analizarEnTuberia(G, entrada, cons).aceptada; });
+    reportar("tubería con árbol", tokens, entrada.size(), segT);
+    printf("  frente a un hilo: %.2fx (%u núcleos)\n", seg / segT, thread::hardware_concurrency());
+
+    // Modo lote: la misma entrada repartida en archivos de ~64 KB, analizados
+    // con 1, 2, 4... hilos que comparten G.
+    vector<string> archivos;
+    size_t bytesLote = 0;
+    while(bytesLote < entrada.size()){ archivos.push_back(generarEntrada(64000)); bytesLote += archivos.back().size(); }
+    size_t tokensLote = (size_t)((double)tokens * bytesLote / entrada.size()); // aproximado: mismo texto
+    unsigned maxHilos = max(1u, thread::hardware_concurrency());
+    double seg1 = 0;
+    for(unsigned h=1;; h = min(h*2, maxHilos)){
+        PoolTrabajo pool(h);
+        vector<char> aceptado(archivos.size());
+        seg = mejorTiempo(3, [&]{ pool.paraCada(archivos.size(), [&](size_t i, unsigned){ aceptado[i] = reconocerLR(G, archivos[i]).aceptada; }); });
+        for(char a : aceptado) ok &= a != 0;
+        if(h == 1) seg1 = seg;
+        char nombre[64];
+        snprintf(nombre, sizeof nombre, "lote, %u hilo%s", h, h == 1 ? "" : "s");
+        reportar(nombre, tokensLote, bytesLote, seg);
+        if(h > 1) printf("  aceleración %.2fx\n", seg1 / seg);
+        if(h == maxHilos) break;
+    }
+    if(!ok){ cerr << "Error: la entrada sintética no fue aceptada\n"; return 1; }
+    return 0;
+}
@@ -0,0 +1,634 @@
+// bytecode.h
+// Traducción del árbol sintáctico a bytecode de registros (lo ejecuta vm.h).
+// Cada función tiene un marco de registros de 8 bytes (ValorBC: int de 64
+// bits o double); el tipo de cada registro se conoce al compilar, así que
+// las instrucciones vienen en versión entera (…I) y real (…F) y la VM no
+// revisa tipos. Los parámetros son los primeros registros, luego las
+// variables locales y arriba los temporales de cada expresión, que se
+// reservan y liberan como una pila. Para llamar, el que llama deja los
+// argumentos en registros consecutivos y el marco de la función empieza en
+// el primero de ellos; el valor de retorno queda en ese mismo registro.
+//
+// El lenguaje es el de compilador.inf: variables globales y locales int y
+// float, funciones con parámetros (recursión incluida), asignación, if/else,
+// while, return, llamadas y los operadores de Expresion (&& y || con
+// cortocircuito; mezclar int y float promueve a float; los relacionales dan
+// int). int es de 64 bits con aritmética modular. Las variables empiezan en
+// 0. print(a, b, ...) es la única función predefinida y la única que acepta
+// cadenas. El programa empieza en main(), que no tiene parámetros.
+//
+// Los nodos se reconocen por el nombre de su regla y la forma de sus hijos
+// (vista_ast.h), no por el número de regla, así que sirve el árbol completo
+// o el compacto de optimizar.h. El texto de opSuma, opMul, opRelac y
+// opIgualdad (+/-, * o /, ...) sólo queda en el árbol si se analizó con
+// parseLR(G, entrada, arbol, true).
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "arbol.h"
+#include "gramatica.h"
+#include "lexer.h"
+#include "vista_ast.h"
+
+/* ------------------ Instrucciones ------------------ */
+// a, b y c son registros salvo donde se indica; k = b | c << 16 (constante,
+// global, cadena, función o destino de salto). Los SALTA<cmp> comparan
+// enteros y saltan c (con signo) instrucciones desde la propia.
+#define OPS_BC(X) \
+    X(MOV) X(CARGAK) X(CARGAG) X(GUARDAG) X(I2F) X(F2I) \
+    X(SUMAI) X(RESTAI) X(MULI) X(DIVI) X(SUMAIK) X(NEGI) X(NOT) \
+    X(SUMAF) X(RESTAF) X(MULF) X(DIVF) X(NEGF) X(NOTF) \
+    X(LTI) X(LEI) X(GTI) X(GEI) X(EQI) X(NEI) \
+    X(LTF) X(LEF) X(GTF) X(GEF) X(EQF) X(NEF) \
+    X(SALTA) X(SALTAF) X(SALTAV) \
+    X(SALTALT) X(SALTALE) X(SALTAGT) X(SALTAGE) X(SALTAEQ) X(SALTANE) \
+    X(LLAMAR) X(RET) X(RET0) \
+    X(IMPRIMIRI) X(IMPRIMIRF) X(IMPRIMIRS) X(IMPRIMIRNL)
+
+enum class OpBC : uint16_t {
+#define X(n) n,
+    OPS_BC(X)
+#undef X
+};
+
+inline const char* nombreOpBC(OpBC op) {
+    static const char *const NOMBRES[] = {
+#define X(n) #n,
+        OPS_BC(X)
+#undef X
+    };
+    return NOMBRES[(int)op];
+}
+
+struct InstrBC {
+    uint16_t op, a, b, c;
+    uint32_t k() const { return b | (uint32_t)c << 16; }
+};
+
+union ValorBC {
+    int64_t i;
+    double f;
+};
+
+enum class TipoBC : uint8_t { ENTERO, REAL, CADENA, NADA };
+
+inline const char* nombreTipoBC(TipoBC t) {
+    return t == TipoBC::ENTERO ? "int" : t == TipoBC::REAL ? "float" : t == TipoBC::CADENA ? "cadena" : "nada";
+}
+
+struct FuncionBC {
+    std::string nombre;
+    TipoBC retorno = TipoBC::ENTERO;
+    std::vector<TipoBC> parametros;
+    uint32_t inicio = 0;
+    uint16_t nParametros = 0, nLocales = 0, nRegistros = 0; // nLocales incluye los parámetros
+};
+
+struct ProgramaBC {
+    std::vector<InstrBC> codigo;
+    std::vector<ValorBC> constantes;
+    std::vector<std::string> cadenas;
+    std::vector<FuncionBC> funciones;
+    std::vector<TipoBC> globales;
+    std::vector<std::string> nombresGlobales;
+    int principal = -1;
+};
+
+/* ------------------ Compilador ------------------ */
+class CompiladorBC : private VistaAst {
+public:
+    // Límite de anidamiento de expresiones y sentencias: el recorrido es
+    // recursivo y no debe agotar la pila de llamadas.
+    static const int PROFUNDIDAD_MAX = 10000;
+
+    CompiladorBC(const Arbol &A, const LRGram &G) : VistaAst(A, G) {}
+
+    bool compilar(ProgramaBC &prog, std::string &err) {
+        P = &prog;
+        prog = ProgramaBC();
+        error.clear();
+        enterosChicos.clear();
+        enFuncion = false;
+        etiqueta = 0;
+        profundidad = 0;
+        clasificarReglas();
+        size_t L = A.lexemas.size();
+        funcionDe.assign(L, -1);
+        globalDe.assign(L, -1);
+        localDe.assign(L, -1);
+        // Primera pasada: firmas y globales, para poder usarlas antes de su definición.
+        std::vector<uint32_t> defs;
+        definiciones(defs);
+        for (uint32_t d : defs) {
+            if (categoria(d) == DEFVAR) declararVariables(d, true);
+            else if (categoria(d) == DEFFUNC) declararFuncion(d);
+        }
+        if (error.empty() && prog.principal < 0) fallar("no hay función main");
+        if (error.empty() && prog.funciones[prog.principal].nParametros) fallar("main no debe tener parámetros");
+        int f = 0;
+        for (uint32_t d : defs)
+            if (categoria(d) == DEFFUNC && error.empty()) compilarFuncion(d, f++);
+        if (!error.empty()) { err = error; return false; }
+        return true;
+    }
+
+private:
+    struct Operando { int reg; TipoBC tipo; };
+
+    ProgramaBC *P = nullptr;
+    std::string error;
+    std::vector<int> funcionDe, globalDe, localDe; // por id de lexema
+    std::vector<TipoBC> tipoLocal;
+    std::vector<uint32_t> declaradas;
+    int funcion = 0, nLocales = 0, tope = 0, maxReg = 0, profundidad = 0;
+    bool enFuncion = false;
+    uint32_t etiqueta = 0; // destino de salto más alto emitido hasta ahora
+
+    void fallar(const std::string &m) {
+        if (error.empty()) error = enFuncion ? "en " + P->funciones[funcion].nombre + "(): " + m : m;
+    }
+
+    /* ---- Acceso al árbol ---- */
+    TipoBC tipoDe(uint32_t hojaTipo) const { return esToken(hojaTipo, TokenType::TIPO_FLOAT) ? TipoBC::REAL : TipoBC::ENTERO; }
+    std::string_view textoOperador(uint32_t k) {
+        if (A[k].lexema == TablaLexemas::NINGUNO)
+            fallar("el árbol no guarda el texto de los operadores (analizar con parseLR(G, entrada, arbol, true))");
+        return texto(k);
+    }
+
+    // Quita Expresion -> Termino y los paréntesis.
+    uint32_t sinParentesis(uint32_t k) const {
+        for (k = desenvolver(k); categoria(k) == EXPRESION && nHijos(k) == 3 && esToken(hijo(k, 0), TokenType::PARENTESIS_ABRE);)
+            k = desenvolver(hijo(k, 1));
+        return k;
+    }
+    // La hoja si la expresión es un literal o una variable; si no, NINGUNO.
+    uint32_t hojaSimple(uint32_t k) const {
+        k = sinParentesis(k);
+        return A[k].esHoja() ? k : Arbol::NINGUNO;
+    }
+
+    /* ---- Emisión ---- */
+    uint32_t aqui() const { return (uint32_t)P->codigo.size(); }
+    uint32_t emitir(OpBC op, int a = 0, int b = 0, int c = 0) {
+        P->codigo.push_back(InstrBC{(uint16_t)op, (uint16_t)a, (uint16_t)b, (uint16_t)c});
+        return aqui() - 1;
+    }
+    uint32_t emitirK(OpBC op, int a, uint32_t k) { return emitir(op, a, (int)(k & 0xffff), (int)(k >> 16)); }
+    void parchear(uint32_t i, uint32_t destino) {
+        if (destino > etiqueta) etiqueta = destino;
+        P->codigo[i].b = (uint16_t)(destino & 0xffff);
+        P->codigo[i].c = (uint16_t)(destino >> 16);
+    }
+    int temporal() {
+        int r = tope++;
+        if (tope > maxReg) maxReg = tope;
+        if (tope > 0xffff) fallar("la función necesita más de 65535 registros");
+        return r;
+    }
+    uint32_t constante(ValorBC v) {
+        P->constantes.push_back(v);
+        return (uint32_t)P->constantes.size() - 1;
+    }
+    uint32_t constanteEntera(int64_t v) {
+        // Las constantes pequeñas se comparten.
+        if (v >= -16 && v < 240) {
+            if (enterosChicos.empty()) enterosChicos.assign(256, UINT32_MAX);
+            uint32_t &k = enterosChicos[(size_t)(v + 16)];
+            if (k == UINT32_MAX) { ValorBC c; c.i = v; k = constante(c); }
+            return k;
+        }
+        ValorBC c;
+        c.i = v;
+        return constante(c);
+    }
+    std::vector<uint32_t> enterosChicos;
+
+    // Si la última instrucción cargó un literal entero en 'reg' y ningún
+    // salto cae después de ella, la cambia por el mismo literal como real.
+    bool literalAReal(int reg) {
+        if (P->codigo.empty() || etiqueta >= aqui()) return false;
+        InstrBC &u = P->codigo.back();
+        if (u.op != (uint16_t)OpBC::CARGAK || u.a != reg) return false;
+        ValorBC c;
+        c.f = (double)P->constantes[u.k()].i;
+        uint32_t k = constante(c);
+        u.b = (uint16_t)(k & 0xffff);
+        u.c = (uint16_t)(k >> 16);
+        return true;
+    }
+
+    // Deja en 'dst' el valor de 'v' convertido a 't'.
+    void convertirEn(int dst, Operando v, TipoBC t) {
+        if (v.tipo == TipoBC::CADENA || v.tipo == TipoBC::NADA) { fallar(std::string("no se puede usar un valor de tipo ") + nombreTipoBC(v.tipo) + " aquí"); return; }
+        if (v.tipo == t) { if (dst != v.reg) emitir(OpBC::MOV, dst, v.reg); }
+        else if (t == TipoBC::REAL && dst == v.reg && literalAReal(v.reg)) return;
+        else emitir(t == TipoBC::REAL ? OpBC::I2F : OpBC::F2I, dst, v.reg);
+    }
+    Operando aTipo(Operando v, TipoBC t) {
+        if (v.tipo == t || !error.empty()) return v;
+        if (t == TipoBC::REAL && v.reg >= nLocales && literalAReal(v.reg)) return Operando{v.reg, TipoBC::REAL};
+        int r = temporal();
+        convertirEn(r, v, t);
+        return Operando{r, t};
+    }
+
+    struct Nivel {
+        CompiladorBC &c;
+        explicit Nivel(CompiladorBC &c) : c(c) {
+            if (++c.profundidad > PROFUNDIDAD_MAX) c.fallar("anidamiento de más de " + std::to_string(PROFUNDIDAD_MAX) + " niveles");
+        }
+        ~Nivel() { c.profundidad--; }
+    };
+
+    /* ---- Declaraciones ---- */
+    void declararVariables(uint32_t d, bool global) {
+        TipoBC t = tipoDe(hijo(d, 0));
+        std::vector<uint32_t> nombres;
+        nombresDeclarados(d, nombres);
+        for (uint32_t n : nombres) {
+            uint32_t id = lexema(n);
+            if (global) {
+                if (globalDe[id] >= 0 || funcionDe[id] >= 0) { fallar("'" + std::string(texto(n)) + "' ya está declarado"); return; }
+                globalDe[id] = (int)P->globales.size();
+                P->globales.push_back(t);
+                P->nombresGlobales.emplace_back(texto(n));
+            } else declararLocal(id, t, texto(n));
+        }
+    }
+    void declararLocal(uint32_t id, TipoBC t, std::string_view nombre) {
+        if (localDe[id] >= 0) { fallar("la variable local '" + std::string(nombre) + "' ya está declarada"); return; }
+        localDe[id] = nLocales;
+        declaradas.push_back(id);
+        tipoLocal.push_back(t);
+        tope = ++nLocales;
+        if (tope > maxReg) maxReg = tope;
+    }
+    void declararFuncion(uint32_t d) {
+        uint32_t id = lexema(hijo(d, 1));
+        if (globalDe[id] >= 0 || funcionDe[id] >= 0) { fallar("'" + std::string(texto(hijo(d, 1))) + "' ya está declarado"); return; }
+        FuncionBC f;
+        f.nombre = std::string(texto(hijo(d, 1)));
+        f.retorno = tipoDe(hijo(d, 0));
+        std::vector<uint32_t> p;
+        parametros(d, p); // tipo, id, tipo, id, ...
+        for (size_t i = 0; i + 1 < p.size(); i += 2) f.parametros.push_back(tipoDe(p[i]));
+        f.nParametros = (uint16_t)f.parametros.size();
+        funcionDe[id] = (int)P->funciones.size();
+        if (f.nombre == "main") P->principal = (int)P->funciones.size();
+        P->funciones.push_back(std::move(f));
+    }
+
+    /* ---- Funciones y sentencias ---- */
+    void compilarFuncion(uint32_t d, int idx) {
+        funcion = idx;
+        enFuncion = true;
+        P->funciones[idx].inicio = aqui();
+        nLocales = tope = maxReg = 0;
+        tipoLocal.clear();
+        std::vector<uint32_t> v;
+        parametros(d, v);
+        for (size_t i = 0; i + 1 < v.size(); i += 2) declararLocal(lexema(v[i + 1]), tipoDe(v[i]), texto(v[i + 1]));
+        v.clear();
+        contenido(cuerpoFuncion(d), v);
+        for (size_t i = 0; i < v.size() && error.empty(); i++) {
+            if (categoria(v[i]) == DEFVAR) declararVariables(v[i], false);
+            else sentencia(v[i]);
+        }
+        emitir(OpBC::RET0);
+        FuncionBC &f = P->funciones[idx];
+        f.nLocales = (uint16_t)nLocales;
+        f.nRegistros = (uint16_t)maxReg;
+        for (uint32_t id : declaradas) localDe[id] = -1;
+        declaradas.clear();
+        enFuncion = false;
+    }
+
+    // Cuerpo de un if, else o while: un Bloque o una sola Sentencia.
+    void compilarCuerpo(uint32_t k) {
+        k = rama(k);
+        if (categoria(k) != BLOQUE) { sentencia(k); return; }
+        std::vector<uint32_t> v;
+        contenido(k, v);
+        for (size_t i = 0; i < v.size() && error.empty(); i++) sentencia(v[i]);
+    }
+
+    void sentencia(uint32_t s) {
+        Nivel nivel(*this);
+        if (!error.empty()) return;
+        uint32_t x = hijo(s, 0);
+        if (esToken(x, TokenType::IDENT)) asignacion(x, hijo(s, 2));
+        else if (esToken(x, TokenType::RESERVADA_IF)) {
+            uint32_t salto = saltoSi(hijo(s, 2), false);
+            compilarCuerpo(hijo(s, 4));
+            uint32_t otro = ramaElse(s);
+            if (otro != Arbol::NINGUNO) {
+                uint32_t fin = emitir(OpBC::SALTA);
+                parchear(salto, aqui());
+                compilarCuerpo(otro);
+                parchear(fin, aqui());
+            } else parchear(salto, aqui());
+        } else if (esToken(x, TokenType::RESERVADA_WHILE)) {
+            // La condición va al final: una sola instrucción de salto por vuelta.
+            uint32_t entrada = emitir(OpBC::SALTA);
+            uint32_t cuerpo = aqui();
+            compilarCuerpo(hijo(s, 4));
+            parchear(entrada, aqui());
+            saltarAtrasSi(hijo(s, 2), cuerpo);
+        } else if (esToken(x, TokenType::RESERVADA_RETURN)) {
+            uint32_t v = valorRetorno(s);
+            if (v == Arbol::NINGUNO) emitir(OpBC::RET0);
+            else {
+                Operando r = expresion(v, -1);
+                r = aTipo(r, P->funciones[funcion].retorno);
+                emitir(OpBC::RET, r.reg);
+            }
+        } else llamada(x, true);
+        tope = nLocales;
+    }
+
+    void asignacion(uint32_t nombre, uint32_t e) {
+        uint32_t id = lexema(nombre);
+        if (localDe[id] >= 0) {
+            int r = localDe[id];
+            convertirEn(r, expresion(e, r), tipoLocal[r]);
+        } else if (globalDe[id] >= 0) {
+            int g = globalDe[id];
+            Operando v = aTipo(expresion(e, -1), P->globales[g]);
+            emitirK(OpBC::GUARDAG, v.reg, (uint32_t)g);
+        } else fallar("variable '" + std::string(texto(nombre)) + "' no declarada");
+    }
+
+    // Salto (a parchear) que se toma cuando la condición vale 'valor'.
+    uint32_t saltoSi(uint32_t e, bool valor) {
+        int marca = tope;
+        Operando c = expresion(e, -1);
+        if (c.tipo == TipoBC::REAL) {
+            int r = temporal();
+            emitir(OpBC::NOTF, r, c.reg);
+            c = Operando{r, TipoBC::ENTERO};
+            valor = !valor;
+        } else if (c.tipo != TipoBC::ENTERO) fallar("la condición debe ser int o float");
+        tope = marca;
+        return emitir(valor ? OpBC::SALTAV : OpBC::SALTAF, c.reg);
+    }
+
+    // Salto hacia atrás a 'destino' si la condición es verdadera. Una
+    // comparación entre enteros se hace en la misma instrucción.
+    void saltarAtrasSi(uint32_t e, uint32_t destino) {
+        static const char *const CMP[] = {"<", "<=", ">", ">=", "==", "!="};
+        static const OpBC SALTOS[] = {OpBC::SALTALT, OpBC::SALTALE, OpBC::SALTAGT, OpBC::SALTAGE, OpBC::SALTAEQ, OpBC::SALTANE};
+        e = sinParentesis(e);
+        if (categoria(e) == EXPRESION && nHijos(e) == 3 &&
+            (esToken(hijo(e, 1), TokenType::OP_RELAC) || esToken(hijo(e, 1), TokenType::OP_IGUALDAD))) {
+            int marca = tope;
+            Operando x = expresion(hijo(e, 0), -1), y = expresion(hijo(e, 2), -1);
+            std::string_view op = textoOperador(hijo(e, 1));
+            int64_t salto = (int64_t)destino - (int64_t)aqui();
+            if (x.tipo == TipoBC::ENTERO && y.tipo == TipoBC::ENTERO && salto >= INT16_MIN)
+                for (int k = 0; k < 6; k++)
+                    if (op == CMP[k]) { emitir(SALTOS[k], x.reg, y.reg, (int)(int16_t)salto); tope = marca; return; }
+            uint32_t s = comparar(hijo(e, 1), x, y, -1, marca).reg;
+            tope = marca;
+            parchear(emitir(OpBC::SALTAV, (int)s), destino);
+            return;
+        }
+        parchear(saltoSi(e, true), destino);
+    }
+
+    /* ---- Expresiones ---- */
+    // El resultado puede quedar en 'dest' (si se pasa) o en cualquier otro
+    // registro; quien llama lo mueve si hace falta.
+    Operando expresion(uint32_t e, int dest) {
+        Nivel nivel(*this);
+        if (!error.empty()) return Operando{0, TipoBC::ENTERO};
+        e = desenvolver(e);
+        Categoria c = categoria(e);
+        if (c == HOJA || c == LLAMADAFUNC) return termino(e, dest);
+        if (c != EXPRESION) { fallar("nodo inesperado en una expresión"); return Operando{0, TipoBC::ENTERO}; }
+        uint32_t n = nHijos(e);
+        if (n == 3 && esToken(hijo(e, 0), TokenType::PARENTESIS_ABRE)) return expresion(hijo(e, 1), dest);
+        int marca = tope;
+        if (n == 2) {
+            uint32_t op = hijo(e, 0);
+            Operando x = expresion(hijo(e, 1), -1);
+            if (x.tipo != TipoBC::ENTERO && x.tipo != TipoBC::REAL) { fallar("operando de tipo " + std::string(nombreTipoBC(x.tipo))); return x; }
+            if (esToken(op, TokenType::OP_SUMA) && textoOperador(op) == "+") return x;
+            tope = marca;
+            int r = dest >= 0 ? dest : temporal();
+            if (esToken(op, TokenType::OP_NOT)) {
+                emitir(x.tipo == TipoBC::REAL ? OpBC::NOTF : OpBC::NOT, r, x.reg);
+                return Operando{r, TipoBC::ENTERO};
+            }
+            emitir(x.tipo == TipoBC::REAL ? OpBC::NEGF : OpBC::NEGI, r, x.reg);
+            return Operando{r, x.tipo};
+        }
+        uint32_t op = hijo(e, 1);
+        if (esToken(op, TokenType::OP_AND) || esToken(op, TokenType::OP_OR)) return logica(e, dest);
+        Operando x = expresion(hijo(e, 0), -1);
+        if (esToken(op, TokenType::OP_SUMA) && x.tipo == TipoBC::ENTERO) {
+            // x + k y x - k con k literal pequeño: una sola instrucción.
+            uint32_t h = hojaSimple(hijo(e, 2));
+            int64_t k;
+            if (h != Arbol::NINGUNO && esToken(h, TokenType::ENTERO) && literalEntero(h, k)) {
+                if (textoOperador(op) == "-") k = (int64_t)(0 - (uint64_t)k); // k puede ser INT64_MIN tras plegar
+                if (k >= INT16_MIN && k <= INT16_MAX) {
+                    tope = marca;
+                    int r = dest >= 0 ? dest : temporal();
+                    emitir(OpBC::SUMAIK, r, x.reg, (int)(int16_t)k);
+                    return Operando{r, TipoBC::ENTERO};
+                }
+            }
+        }
+        Operando y = expresion(hijo(e, 2), -1);
+        if (esToken(op, TokenType::OP_RELAC) || esToken(op, TokenType::OP_IGUALDAD)) return comparar(op, x, y, dest, marca);
+        TipoBC t = promover(x, y);
+        x = aTipo(x, t);
+        y = aTipo(y, t);
+        std::string_view s = textoOperador(op);
+        OpBC codigo;
+        if (esToken(op, TokenType::OP_SUMA)) codigo = s == "-" ? (t == TipoBC::REAL ? OpBC::RESTAF : OpBC::RESTAI) : (t == TipoBC::REAL ? OpBC::SUMAF : OpBC::SUMAI);
+        else if (esToken(op, TokenType::OP_MUL)) codigo = s == "/" ? (t == TipoBC::REAL ? OpBC::DIVF : OpBC::DIVI) : (t == TipoBC::REAL ? OpBC::MULF : OpBC::MULI);
+        else { fallar("operador desconocido"); return x; }
+        tope = marca;
+        int r = dest >= 0 ? dest : temporal();
+        emitir(codigo, r, x.reg, y.reg);
+        return Operando{r, t};
+    }
+
+    TipoBC promover(Operando x, Operando y) {
+        for (Operando o : {x, y})
+            if (o.tipo != TipoBC::ENTERO && o.tipo != TipoBC::REAL) fallar("operando de tipo " + std::string(nombreTipoBC(o.tipo)));
+        return x.tipo == TipoBC::REAL || y.tipo == TipoBC::REAL ? TipoBC::REAL : TipoBC::ENTERO;
+    }
+
+    Operando comparar(uint32_t op, Operando x, Operando y, int dest, int marca) {
+        static const char *const CMP[] = {"<", "<=", ">", ">=", "==", "!="};
+        static const OpBC ENTEROS[] = {OpBC::LTI, OpBC::LEI, OpBC::GTI, OpBC::GEI, OpBC::EQI, OpBC::NEI};
+        static const OpBC REALES[] = {OpBC::LTF, OpBC::LEF, OpBC::GTF, OpBC::GEF, OpBC::EQF, OpBC::NEF};
+        TipoBC t = promover(x, y);
+        x = aTipo(x, t);
+        y = aTipo(y, t);
+        std::string_view s = textoOperador(op);
+        tope = marca;
+        int r = dest >= 0 ? dest : temporal();
+        for (int k = 0; k < 6; k++)
+            if (s == CMP[k]) { emitir(t == TipoBC::REAL ? REALES[k] : ENTEROS[k], r, x.reg, y.reg); return Operando{r, TipoBC::ENTERO}; }
+        if (error.empty()) fallar("operador de comparación desconocido '" + std::string(s) + "'");
+        return Operando{r, TipoBC::ENTERO};
+    }
+
+    // && y || con cortocircuito; el resultado (0 o 1) se escribe al final,
+    // así que 'dest' puede ser una variable que aparece en la expresión.
+    Operando logica(uint32_t e, int dest) {
+        bool y = esToken(hijo(e, 1), TokenType::OP_AND);
+        int r = dest >= 0 ? dest : temporal();
+        uint32_t s1 = saltoSi(hijo(e, 0), !y);
+        uint32_t s2 = saltoSi(hijo(e, 2), !y);
+        emitirK(OpBC::CARGAK, r, constanteEntera(y ? 1 : 0));
+        uint32_t fin = emitir(OpBC::SALTA);
+        parchear(s1, aqui());
+        parchear(s2, aqui());
+        emitirK(OpBC::CARGAK, r, constanteEntera(y ? 0 : 1));
+        parchear(fin, aqui());
+        return Operando{r, TipoBC::ENTERO};
+    }
+
+    bool literalEntero(uint32_t h, int64_t &v) {
+        std::string s(texto(h));
+        errno = 0;
+        char *fin = nullptr;
+        long long x = std::strtoll(s.c_str(), &fin, 10);
+        if (errno || !fin || *fin) { fallar("entero fuera de rango: " + s); return false; }
+        v = x;
+        return true;
+    }
+
+    Operando termino(uint32_t t, int dest) {
+        uint32_t x = desenvolver(t);
+        if (categoria(x) == LLAMADAFUNC) return llamada(x, false);
+        if (!A[x].esHoja()) { fallar("nodo inesperado en un término"); return Operando{0, TipoBC::ENTERO}; }
+        TokenType tt = A[x].tipoToken();
+        if (tt == TokenType::IDENT) {
+            uint32_t id = lexema(x);
+            if (localDe[id] >= 0) return Operando{localDe[id], tipoLocal[localDe[id]]};
+            if (globalDe[id] >= 0) {
+                int r = dest >= 0 ? dest : temporal();
+                emitirK(OpBC::CARGAG, r, (uint32_t)globalDe[id]);
+                return Operando{r, P->globales[globalDe[id]]};
+            }
+            fallar("variable '" + std::string(texto(x)) + "' no declarada");
+            return Operando{0, TipoBC::ENTERO};
+        }
+        if (tt == TokenType::CADENA) { fallar("las cadenas sólo pueden usarse como argumento de print"); return Operando{0, TipoBC::CADENA}; }
+        int r = dest >= 0 ? dest : temporal();
+        if (tt == TokenType::ENTERO) {
+            int64_t v = 0;
+            literalEntero(x, v);
+            emitirK(OpBC::CARGAK, r, constanteEntera(v));
+            return Operando{r, TipoBC::ENTERO};
+        }
+        ValorBC c;
+        c.f = std::strtod(std::string(texto(x)).c_str(), nullptr);
+        emitirK(OpBC::CARGAK, r, constante(c));
+        return Operando{r, TipoBC::REAL};
+    }
+
+    Operando llamada(uint32_t ll, bool comoSentencia) {
+        uint32_t nombre = hijo(ll, 0);
+        std::vector<uint32_t> args;
+        argumentos(ll, args);
+        int f = funcionDe[lexema(nombre)];
+        if (f < 0) {
+            if (texto(nombre) != "print") { fallar("función '" + std::string(texto(nombre)) + "' no declarada"); return Operando{0, TipoBC::ENTERO}; }
+            if (!comoSentencia) { fallar("print no devuelve un valor"); return Operando{0, TipoBC::ENTERO}; }
+            imprimir(args);
+            return Operando{0, TipoBC::NADA};
+        }
+        const FuncionBC &fn = P->funciones[f];
+        if (args.size() != fn.parametros.size()) {
+            fallar(fn.nombre + "() espera " + std::to_string(fn.parametros.size()) + " argumentos y recibe " + std::to_string(args.size()));
+            return Operando{0, fn.retorno};
+        }
+        int base = tope;
+        for (size_t i = 0; i < args.size() && error.empty(); i++) {
+            tope = base + (int)i;
+            int r = temporal();
+            convertirEn(r, expresion(args[i], r), P->funciones[f].parametros[i]);
+        }
+        tope = base;
+        temporal();
+        emitirK(OpBC::LLAMAR, base, (uint32_t)f);
+        return Operando{base, P->funciones[f].retorno};
+    }
+
+    void imprimir(const std::vector<uint32_t> &args) {
+        int marca = tope;
+        for (size_t i = 0; i < args.size() && error.empty(); i++) {
+            int sep = i ? 1 : 0;
+            uint32_t h = hojaSimple(args[i]);
+            if (h != Arbol::NINGUNO && esToken(h, TokenType::CADENA)) {
+                std::string_view s = texto(h);
+                P->cadenas.emplace_back(s.substr(1, s.size() >= 2 ? s.size() - 2 : 0)); // sin comillas
+                emitirK(OpBC::IMPRIMIRS, sep, (uint32_t)P->cadenas.size() - 1);
+                continue;
+            }
+            Operando v = expresion(args[i], -1);
+            if (v.tipo != TipoBC::ENTERO && v.tipo != TipoBC::REAL) fallar("no se puede imprimir un valor de tipo " + std::string(nombreTipoBC(v.tipo)));
+            emitir(v.tipo == TipoBC::REAL ? OpBC::IMPRIMIRF : OpBC::IMPRIMIRI, v.reg, sep);
+            tope = marca;
+        }
+        emitir(OpBC::IMPRIMIRNL);
+    }
+};
+
+inline bool compilarBytecode(const Arbol &A, const LRGram &G, ProgramaBC &P, std::string &error) {
+    CompiladorBC c(A, G);
+    return c.compilar(P, error);
+}
+
+/* ------------------ Listado ------------------ */
+inline void desensamblar(const ProgramaBC &P, std::ostream &os) {
+    for (size_t g = 0; g < P.globales.size(); g++)
+        os << "global G" << g << " " << nombreTipoBC(P.globales[g]) << " " << P.nombresGlobales[g] << "\n";
+    for (size_t f = 0; f < P.funciones.size(); f++) {
+        const FuncionBC &fn = P.funciones[f];
+        uint32_t fin = f + 1 < P.funciones.size() ? P.funciones[f + 1].inicio : (uint32_t)P.codigo.size();
+        os << "\n" << nombreTipoBC(fn.retorno) << " " << fn.nombre << "(" << fn.nParametros << " parámetros, "
+           << fn.nLocales << " locales, " << fn.nRegistros << " registros)\n";
+        for (uint32_t i = fn.inicio; i < fin; i++) {
+            const InstrBC &x = P.codigo[i];
+            OpBC op = (OpBC)x.op;
+            os << "  " << i << "\t" << nombreOpBC(op) << "\t";
+            switch (op) {
+            case OpBC::CARGAK: {
+                ValorBC v = P.constantes[x.k()];
+                os << "r" << x.a << ", K" << x.k() << " (" << v.i << " | " << v.f << ")";
+                break;
+            }
+            case OpBC::CARGAG: case OpBC::GUARDAG: os << "r" << x.a << ", G" << x.k(); break;
+            case OpBC::SALTA: os << x.k(); break;
+            case OpBC::SALTAF: case OpBC::SALTAV: os << "r" << x.a << ", " << x.k(); break;
+            case OpBC::SALTALT: case OpBC::SALTALE: case OpBC::SALTAGT: case OpBC::SALTAGE: case OpBC::SALTAEQ: case OpBC::SALTANE:
+                os << "r" << x.a << ", r" << x.b << ", " << (int64_t)i + (int16_t)x.c; break;
+            case OpBC::SUMAIK: os << "r" << x.a << ", r" << x.b << ", " << (int16_t)x.c; break;
+            case OpBC::LLAMAR: os << "r" << x.a << ", " << P.funciones[x.k()].nombre; break;
+            case OpBC::RET: case OpBC::IMPRIMIRI: case OpBC::IMPRIMIRF: os << "r" << x.a; break;
+            case OpBC::IMPRIMIRS: os << "\"" << P.cadenas[x.k()] << "\""; break;
+            case OpBC::RET0: case OpBC::IMPRIMIRNL: break;
+            case OpBC::MOV: case OpBC::I2F: case OpBC::F2I: case OpBC::NEGI: case OpBC::NEGF: case OpBC::NOT: case OpBC::NOTF:
+                os << "r" << x.a << ", r" << x.b; break;
+            default: os << "r" << x.a << ", r" << x.b << ", r" << x.c;
+            }
+            os << "\n";
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,54 @@
+// compilartabla.cpp
+// Convierte la tabla de texto (.lr + .inf) al formato binario .lrb que el
+// traductor proyecta en memoria con mmap (ver gramatica.h).
+// Compilar: g++ -std=c++17 -O2 compilartabla.cpp -o compilartabla
+// Ejecutar: ./compilartabla compilador.lr compilador.inf compilador.lrb
+//           ./compilartabla --embebida compilador.lr compilador.inf gramatica_embebida.h
+//               (tablas como arreglos constexpr para compilarlas dentro del traductor, ver embebida.h)
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "embebida.h"
+#include "gramatica.h"
+
+int main(int argc, char **argv) {
+    bool embebida = argc >= 2 && std::string(argv[1]) == "--embebida";
+    if (embebida) { argv++; argc--; }
+    if (argc < 4) {
+        std::cerr << "Uso: " << argv[0] << " <archivo_gramatica.lr> <archivo_mapeo.inf> <salida.lrb>\n";
+        std::cerr << "     " << argv[0] << " --embebida <archivo_gramatica.lr> <archivo_mapeo.inf> <salida.h>\n";
+        return 1;
+    }
+
+    LRGram G;
+    if (!cargarLR(argv[1], G)) return 1;
+    if (!leerInf(argv[2], G)) {
+        std::cerr << "Error: El archivo .inf está vacío o no se pudo leer.\n";
+        return 1;
+    }
+    if (embebida) {
+        std::string origen = argv[1];
+        origen = origen.substr(origen.find_last_of('/') + 1);
+        std::ostringstream os;
+        escribirCabeceraEmbebida(G, origen, os);
+        std::ofstream f(argv[3], std::ios::binary);
+        if (!(f << os.str())) {
+            std::cerr << "Error: no se pudo escribir " << argv[3] << "\n";
+            return 1;
+        }
+        std::cout << argv[3] << ": " << G.nReglas << " reglas, tabla " << G.nFilas << "x" << G.nCols << ", "
+                  << G.bytesTabla() << " bytes de tabla compacta\n";
+        return 0;
+    }
+    if (!escribirLRB(G, argv[3])) return 1;
+
+    // Se vuelve a cargar para comprobar que el archivo generado es válido.
+    LRGram B;
+    if (!cargarLRB(argv[3], B)) return 1;
+    std::cout << argv[3] << ": " << B.nReglas << " reglas, tabla " << B.nFilas << "x" << B.nCols
+              << ", " << B.nTerminales << " terminales, " << B.tamMapa << " bytes\n";
+    reporteTabla(B, std::cout);
+    return 0;
+}
@@ -0,0 +1,167 @@
+// embebida.h
+// Tablas embebidas en el binario: `compilartabla --embebida` escribe una
+// cabecera (gramatica_embebida.h) con las reglas, la tabla compacta y el
+// mapeo de terminales como arreglos constexpr. La cabecera se valida al
+// compilar (static_assert) y enlazarEmbebida() hace que LRGram apunte a esos
+// arreglos, así que el parser es el mismo que con las tablas leídas de disco.
+#ifndef EMBEBIDA_H
+#define EMBEBIDA_H
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include "gramatica.h"
+#include "lexer.h"
+
+/* ------------------ Tablas constexpr ------------------ */
+// Misma disposición que el buffer de la tabla compacta (gramatica.h):
+// cabecera, filas, gotos por defecto (en número par) y celdas.
+template<int F, int NT, int K>
+struct TablaEmbebida {
+    CabeceraCompacta h;
+    FilaCompacta filas[F];
+    int16_t gotoDefecto[(NT + 1) & ~1];
+    Celda celdas[K];
+};
+
+struct GramaticaEmbebida {
+    int nReglas;
+    const int32_t *idRegla, *lonRegla;
+    const uint32_t *nomRegla;
+    int nTerminales;
+    const uint32_t *termNombre;
+    const int32_t *termCol;
+    const char *cadenas;
+    size_t tamCadenas;
+};
+
+/* ------------------ Validación en compilación ------------------ */
+// Cada regla reduce a un no-terminal, su nombre está en el pool, y su
+// longitud es menor que el número de estados (el lado derecho recorre
+// estados distintos).
+template<class T>
+constexpr bool reglasValidas(const GramaticaEmbebida &g, const T &t){
+    for(int r=0;r<g.nReglas;r++)
+        if(g.idRegla[r] < (int)t.h.nColsTerm || g.idRegla[r] >= (int)t.h.nCols || g.lonRegla[r] < 0 ||
+           g.lonRegla[r] >= (int)t.h.nFilas || g.nomRegla[r] >= g.tamCadenas) return false;
+    return true;
+}
+
+// Toda acción (por defecto o en celda) desplaza a un estado existente,
+// reduce por una regla existente o acepta; todo goto va a un estado
+// existente; ninguna fila se sale del arreglo de celdas.
+template<class T>
+constexpr bool tablaValida(const GramaticaEmbebida &g, const T &t){
+    constexpr int F = sizeof(t.filas) / sizeof(t.filas[0]), K = sizeof(t.celdas) / sizeof(t.celdas[0]);
+    if((int)t.h.nFilas != F || (int)t.h.nCeldas != K || t.h.nColsTerm > t.h.nCols) return false;
+    auto accionValida = [&](int a){ return a < F && a >= -(g.nReglas + 1); };
+    for(int e=0;e<F;e++)
+        if(t.filas[e].base < 0 || t.filas[e].base + (int)t.h.nCols > K || !accionValida(t.filas[e].defecto)) return false;
+    for(uint32_t nt=0;nt<t.h.nCols-t.h.nColsTerm;nt++)
+        if(t.gotoDefecto[nt] < 0 || t.gotoDefecto[nt] >= F) return false;
+    for(int k=0;k<K;k++){
+        const Celda &c = t.celdas[k];
+        if(c.chequeo == CELDA_LIBRE) continue;
+        if(c.chequeo >= F) return false;
+        int col = k - t.filas[c.chequeo].base;
+        if(col < 0 || col >= (int)t.h.nCols) return false;
+        if(col >= (int)t.h.nColsTerm ? (c.valor < 0 || c.valor >= F) : !accionValida(c.valor)) return false;
+    }
+    return true;
+}
+
+// Todo tipo de token del lexer (salvo DESCONOCIDO) tiene clave en el mapeo
+// y su columna es terminal.
+constexpr bool mismaCadena(const char *a, const char *b){
+    while(*a && *a == *b){ a++; b++; }
+    return *a == *b;
+}
+template<class T>
+constexpr bool mapeoCompleto(const GramaticaEmbebida &g, const T &t){
+    for(int i=0;i<g.nTerminales;i++)
+        if(g.termNombre[i] >= g.tamCadenas || g.termCol[i] < 0 || g.termCol[i] >= (int)t.h.nColsTerm) return false;
+    for(int tipo=0;tipo<=(int)TokenType::FIN;tipo++){
+        if(tipo == (int)TokenType::DESCONOCIDO) continue;
+        bool hallado = false;
+        for(int i=0;i<g.nTerminales && !hallado;i++) hallado = mismaCadena(g.cadenas + g.termNombre[i], tokenToKey((TokenType)tipo));
+        if(!hallado) return false;
+    }
+    return true;
+}
+
+/* ------------------ Enlace ------------------ */
+template<class T>
+inline void enlazarEmbebida(LRGram &G, const GramaticaEmbebida &g, const T &t){
+    static_assert(offsetof(T, filas) == sizeof(CabeceraCompacta) &&
+                  offsetof(T, gotoDefecto) == offsetof(T, filas) + sizeof(t.filas) &&
+                  offsetof(T, celdas) == offsetof(T, gotoDefecto) + sizeof(t.gotoDefecto) &&
+                  sizeof(T) == offsetof(T, celdas) + sizeof(t.celdas), "TablaEmbebida no tiene la disposición del buffer compacto");
+    G.liberarMapa();
+    G.nReglas = g.nReglas;
+    G.idRegla = g.idRegla;
+    G.lonRegla = g.lonRegla;
+    G.nomRegla = g.nomRegla;
+    G.nFilas = (int)t.h.nFilas;
+    G.nCols = (int)t.h.nCols;
+    G.enlazarCompacta(&t.h);
+    G.nTerminales = g.nTerminales;
+    G.termNombre = g.termNombre;
+    G.termCol = g.termCol;
+    G.cadenas = g.cadenas;
+}
+
+/* ------------------ Generación de la cabecera ------------------ */
+// Escribe gramatica_embebida.h para la gramática G ya cargada.
+inline void escribirCabeceraEmbebida(const LRGram &G, const std::string &origen, std::ostream &os){
+    const CabeceraCompacta &h = *G.compacta;
+    int nNoTerm = (int)(h.nCols - h.nColsTerm);
+    size_t tamCadenas = 0;
+    for(int r=0;r<G.nReglas;r++) tamCadenas = std::max(tamCadenas, G.nomRegla[r] + std::strlen(G.nombreRegla(r)) + 1);
+    for(int t=0;t<G.nTerminales;t++) tamCadenas = std::max(tamCadenas, G.termNombre[t] + std::strlen(G.cadenas + G.termNombre[t]) + 1);
+    auto lista = [&os](const char *tipo, const char *nombre, size_t n, auto valor){
+        os << "constexpr " << tipo << " " << nombre << "[] = {";
+        for(size_t i=0;i<n;i++) os << (i % 16 ? " " : "\n    ") << valor(i) << ",";
+        os << "\n};\n";
+    };
+
+    os << "// gramatica_embebida.h\n"
+       << "// GENERADO por compilartabla --embebida a partir de " << origen << "; no editar.\n"
+       << "#ifndef GRAMATICA_EMBEBIDA_H\n#define GRAMATICA_EMBEBIDA_H\n\n"
+       << "#include \"embebida.h\"\n\n"
+       << "namespace gramatica_embebida {\n\n";
+    lista("int32_t", "ID_REGLA", G.nReglas, [&](size_t i){ return std::to_string(G.idRegla[i]); });
+    lista("int32_t", "LON_REGLA", G.nReglas, [&](size_t i){ return std::to_string(G.lonRegla[i]); });
+    lista("uint32_t", "NOM_REGLA", G.nReglas, [&](size_t i){ return std::to_string(G.nomRegla[i]); });
+    lista("uint32_t", "TERM_NOMBRE", G.nTerminales, [&](size_t i){ return std::to_string(G.termNombre[i]); });
+    lista("int32_t", "TERM_COL", G.nTerminales, [&](size_t i){ return std::to_string(G.termCol[i]); });
+    // Un literal por cadena del pool, para que "\0" nunca se junte con un dígito.
+    os << "constexpr char CADENAS[] =";
+    for(size_t i=0;i<tamCadenas;){
+        size_t n = std::strlen(G.cadenas + i);
+        std::string lit;
+        for(char c : std::string(G.cadenas + i, n)){ if(c == '"' || c == '\\') lit += '\\'; lit += c; }
+        os << "\n    \"" << lit << "\\0\"";
+        i += n + 1;
+    }
+    os << ";\n\n";
+
+    os << "constexpr TablaEmbebida<" << h.nFilas << ", " << nNoTerm << ", " << h.nCeldas << "> TABLA = {\n"
+       << "    {" << h.nFilas << ", " << h.nCols << ", " << h.nColsTerm << ", " << h.nCeldas << "},\n    {";
+    for(uint32_t e=0;e<h.nFilas;e++) os << (e % 8 ? " " : "\n        ") << "{" << G.filas[e].base << ", " << G.filas[e].defecto << ", 0},";
+    os << "\n    },\n    {";
+    for(int nt=0;nt<((nNoTerm + 1) & ~1);nt++) os << (nt % 16 ? " " : "\n        ") << (nt < nNoTerm ? G.gotoDefecto[nt] : 0) << ",";
+    os << "\n    },\n    {";
+    for(uint32_t k=0;k<h.nCeldas;k++) os << (k % 8 ? " " : "\n        ") << "{" << G.celdas[k].valor << ", " << G.celdas[k].chequeo << "},";
+    os << "\n    },\n};\n\n"
+       << "constexpr GramaticaEmbebida GRAMATICA = {\n"
+       << "    " << G.nReglas << ", ID_REGLA, LON_REGLA, NOM_REGLA,\n"
+       << "    " << G.nTerminales << ", TERM_NOMBRE, TERM_COL, CADENAS, sizeof CADENAS,\n"
+       << "};\n\n"
+       << "static_assert(reglasValidas(GRAMATICA, TABLA), \"tabla embebida: regla con no-terminal, longitud o nombre inválido\");\n"
+       << "static_assert(tablaValida(GRAMATICA, TABLA), \"tabla embebida: acción o goto fuera de rango\");\n"
+       << "static_assert(mapeoCompleto(GRAMATICA, TABLA), \"tabla embebida: hay tipos de token sin columna terminal\");\n\n"
+       << "inline void cargar(LRGram &G){ enlazarEmbebida(G, GRAMATICA, TABLA); }\n\n"
+       << "} // namespace gramatica_embebida\n\n#endif\n";
+}
+
+#endif
@@ -0,0 +1,144 @@
+// flujo.h
+// Lectura de la entrada sin cargarla completa en memoria. Si la entrada es un
+// archivo regular se proyecta con mmap; si no (tubería, terminal) se lee en
+// bloques de tamaño fijo y LexerRapido trabaja sobre el bloque actual. Un
+// token que toca el final del bloque (identificador, número, cadena u
+// operador de dos caracteres partido) se vuelve a analizar después de leer
+// el siguiente bloque, así que la secuencia de tokens es la misma que con la
+// entrada completa. La memoria usada es un bloque más el token más largo.
+// Con un AutomataLexico (automata_lexico.h) los tokens los da LexerDFA en
+// lugar de LexerRapido.
+#ifndef FLUJO_H
+#define FLUJO_H
+
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <vector>
+#include "automata_lexico.h"
+#include "gramatica.h" // LRB_MMAP y cabeceras POSIX
+#include "lexer.h"
+#include "lexer_rapido.h"
+
+class LexerFlujo {
+public:
+    static const size_t BLOQUE_DEFECTO = 1 << 20;
+
+    explicit LexerFlujo(std::FILE *f, size_t tamBloque = BLOQUE_DEFECTO, const AutomataLexico *automata = nullptr)
+        : archivo(f), tamBloque(tamBloque ? tamBloque : BLOQUE_DEFECTO), lx(std::string_view()),
+          dfa(automata ? *automata : AutomataLexico()), conDFA(automata != nullptr) {
+#ifdef LRB_MMAP
+        struct stat st;
+        int fd = fileno(f);
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            off_t desde = lseek(fd, 0, SEEK_CUR); // respeta lo ya consumido (p. ej. "< archivo")
+            if (desde < 0) desde = 0;
+            void *m = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (m != MAP_FAILED && desde < st.st_size) {
+                madvise(m, (size_t)st.st_size, MADV_SEQUENTIAL);
+                mapa = m;
+                tamMapa = (size_t)st.st_size;
+                p = (const char*)m + desde;
+                n = tamMapa - (size_t)desde;
+                fin = true;
+                reiniciar();
+                return;
+            }
+            if (m != MAP_FAILED) munmap(m, (size_t)st.st_size);
+        }
+#endif
+        rellenar(0);
+    }
+    ~LexerFlujo() {
+#ifdef LRB_MMAP
+        if (mapa) munmap(mapa, tamMapa);
+#endif
+    }
+    LexerFlujo(const LexerFlujo&) = delete;
+    LexerFlujo& operator=(const LexerFlujo&) = delete;
+
+    // El lexema devuelto es válido hasta la siguiente llamada.
+    Token next() {
+        while (true) {
+            size_t antes = posicion();
+            Token tk = conDFA ? dfa.next() : lx.next();
+            // LexerRapido mira hasta dos caracteres después del token ("1." + dígito).
+            size_t alcance = conDFA ? dfa.alcance() : lx.posicion() + 2;
+            if (fin || alcance <= n) {
+#ifdef LRB_MMAP
+                if (mapa && posicion() >= liberado + tamBloque) soltarPaginas(antes);
+#endif
+                tk.pos += base;
+                return tk;
+            }
+            rellenar(antes);
+        }
+    }
+
+    // Toda la entrada restante como una sola vista: si no está proyectada se
+    // lee completa (y deja de valer la cota de memoria). Sólo antes del
+    // primer next().
+    std::string_view completa() {
+        while (!fin) rellenar(0);
+        return std::string_view(p, n);
+    }
+
+    bool proyectado() const { return mapa != nullptr; }
+    size_t bytesBuffer() const { return buf.capacity(); }
+    bool errorLectura() const { return error; }
+
+private:
+    std::FILE *archivo;
+    size_t tamBloque;
+    std::vector<char> buf;
+    const char *p = nullptr;
+    size_t n = 0;        // bytes válidos en p
+    size_t base = 0;     // posición global de p[0]
+    bool fin = false;    // ya no queda nada por leer
+    bool error = false;
+    void *mapa = nullptr;
+    size_t tamMapa = 0;
+    size_t liberado = 0; // bytes de p ya devueltos al sistema
+    LexerRapido lx;
+    LexerDFA dfa;
+    bool conDFA;
+
+    size_t posicion() const { return conDFA ? dfa.posicion() : lx.posicion(); }
+    void reiniciar() {
+        if (conDFA) dfa.reiniciar(std::string_view(p, n));
+        else lx = LexerRapido(std::string_view(p, n));
+    }
+
+#ifdef LRB_MMAP
+    // Las páginas ya analizadas de la proyección se descartan para que la
+    // memoria residente no crezca con el archivo (si se vuelven a tocar, el
+    // sistema las relee del archivo).
+    void soltarPaginas(size_t hasta) {
+        static const size_t PAGINA = 4096;
+        size_t ini = (size_t)(p - (const char*)mapa);
+        size_t finPag = (ini + hasta) & ~(PAGINA - 1);
+        size_t desde = (ini + liberado + PAGINA - 1) & ~(PAGINA - 1);
+        if (finPag > desde) madvise((char*)mapa + desde, finPag - desde, MADV_DONTNEED);
+        liberado = hasta;
+    }
+#endif
+
+    // Descarta lo anterior a 'desde', lee un bloque más y reinicia el lexer en
+    // el primer byte conservado.
+    void rellenar(size_t desde) {
+        size_t resto = n - desde;
+        if (resto && desde) std::memmove(buf.data(), buf.data() + desde, resto);
+        base += desde;
+        if (buf.size() < resto + tamBloque) buf.resize(resto + tamBloque);
+        size_t leidos = std::fread(buf.data() + resto, 1, tamBloque, archivo);
+        if (leidos < tamBloque) {
+            fin = true;
+            error = std::ferror(archivo) != 0;
+        }
+        p = buf.data();
+        n = resto + leidos;
+        reiniciar();
+    }
+};
+
+#endif
@@ -0,0 +1,197 @@
+// generador.h
+// Generador de programas aleatorios válidos a partir de las producciones del
+// .inf (leerProducciones, lalr.h). Se deriva desde el primer no-terminal
+// eligiendo producciones al azar con tres controles:
+//   - tamaño: la lista de primer nivel (p. ej. <Definiciones>) se repite
+//     hasta llegar a 'tokens';
+//   - anidamiento: cuántas veces puede aparecer un no-terminal dentro de sí
+//     mismo (sentencias dentro de bloques, llamadas dentro de argumentos...);
+//   - complejidad: lo mismo, sólo para el no-terminal de expresiones.
+// Las listas (A ::= \e | ... A) se generan iterando, así que su largo no
+// cuenta como anidamiento.
+#ifndef GENERADOR_H
+#define GENERADOR_H
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "lalr.h"
+
+struct OpcionesGenerador {
+    size_t tokens = 10000;                 // tamaño aproximado del programa
+    int anidamiento = 3;
+    int complejidad = 3;
+    int lista = 4;                         // largo máximo de las listas internas
+    std::string expresion = "Expresion";   // no-terminal al que se aplica 'complejidad'
+    uint32_t semilla = 1;
+};
+
+class GeneradorProgramas {
+public:
+    explicit GeneradorProgramas(const GramaticaBNF &g) : g(g) {
+        int S = g.nSimbolos();
+        porLhs.assign(S, {});
+        for(int r=0;r<(int)g.reglas.size();r++) porLhs[g.reglas[r].lhs].push_back(r);
+        for(int t=0;t<g.nTerminales;t++) if(g.nombres[t] == "else") tElse = t;
+        // Altura mínima de derivación de cada símbolo (punto fijo).
+        const int INF = 1 << 29;
+        altura.assign(S, INF);
+        for(int t=0;t<g.nTerminales;t++) altura[t] = 0;
+        for(bool cambio = true; cambio;){
+            cambio = false;
+            for(int r=0;r<(int)g.reglas.size();r++){
+                int h = alturaRegla(r);
+                if(h < altura[g.reglas[r].lhs]){ altura[g.reglas[r].lhs] = h; cambio = true; }
+            }
+        }
+        // alcanza[X*S + A]: X deriva una forma que contiene A.
+        alcanza.assign((size_t)S * S, 0);
+        for(const Produccion &p : g.reglas)
+            for(int x : p.rhs) if(!g.esTerminal(x)) alcanza[(size_t)p.lhs*S + x] = 1;
+        for(int k=g.nTerminales;k<S;k++)
+            for(int i=g.nTerminales;i<S;i++)
+                if(alcanza[(size_t)i*S + k])
+                    for(int j=g.nTerminales;j<S;j++) alcanza[(size_t)i*S + j] |= alcanza[(size_t)k*S + j];
+        // Listas: A con una producción vacía y otra que termina en A (única aparición).
+        esLista.assign(S, 0);
+        for(int A=g.nTerminales;A<S;A++){
+            bool vacia = false, cola = false;
+            for(int r : porLhs[A]){
+                const auto &rhs = g.reglas[r].rhs;
+                vacia |= rhs.empty();
+                cola |= !rhs.empty() && rhs.back() == A && std::count(rhs.begin(), rhs.end(), A) == 1;
+            }
+            esLista[A] = vacia && cola;
+        }
+    }
+
+    std::string generar(const OpcionesGenerador &op){
+        this->op = &op;
+        x = op.semilla ? op.semilla : 1;
+        expr = -1;
+        for(int A=g.nTerminales;A<g.nSimbolos();A++) if(g.nombres[A] == op.expresion) expr = A;
+        nivel.assign(g.nSimbolos(), 0);
+        listas = 0;
+        emitidos = 0;
+        llaves = 0;
+        trasElse = false;
+        salida.clear();
+        salida.reserve(op.tokens * 6);
+        derivar(g.reglas.empty() ? 0 : g.reglas[0].lhs, 0);
+        salida += '\n';
+        return std::move(salida);
+    }
+
+    // Tokens del último programa generado.
+    size_t tokens() const { return emitidos; }
+
+private:
+    const GramaticaBNF &g;
+    const OpcionesGenerador *op = nullptr;
+    std::vector<std::vector<int>> porLhs;
+    std::vector<int> altura, nivel;
+    std::vector<char> alcanza, esLista;
+    int expr = -1, listas = 0, llaves = 0, tElse = -1;
+    bool trasElse = false; // lo último emitido cierra una rama else
+    size_t emitidos = 0;
+    uint32_t x = 1;
+    std::string salida;
+
+    uint32_t azar(){ x ^= x << 13; x ^= x >> 17; x ^= x << 5; return x; }
+
+    int alturaRegla(int r) const {
+        int h = 0;
+        for(int s : g.reglas[r].rhs) h = std::max(h, altura[s]);
+        return h >= (1 << 29) ? h : h + 1;
+    }
+    bool alcanzaA(int X, int A) const { return X == A || (!g.esTerminal(X) && alcanza[(size_t)X*g.nSimbolos() + A]); }
+
+    void derivar(int A, int prof){
+        if(g.esTerminal(A)){ emitir(A); return; }
+        if(esLista[A]){ derivarLista(A, prof); return; }
+        const std::vector<int> &ps = porLhs[A];
+        int limite = A == expr ? op->complejidad : op->anidamiento;
+        int r = ps[azar() % ps.size()];
+        if(nivel[A] >= limite || prof > 256){
+            // En el límite: una producción que no vuelva a A, o la más corta.
+            std::vector<int> cand;
+            for(int q : ps){
+                bool vuelve = false;
+                for(int s : g.reglas[q].rhs) vuelve |= alcanzaA(s, A);
+                if(!vuelve) cand.push_back(q);
+            }
+            if(cand.empty() || prof > 256){
+                cand.clear();
+                int hMin = altura[A];
+                for(int q : ps) if(alturaRegla(q) == hMin) cand.push_back(q);
+            }
+            r = cand[azar() % cand.size()];
+        }
+        // La tabla del .lr no acepta un else justo después de un if-else
+        // completo (if (a) if (b) x; else y; else z;): ahí va otra producción.
+        if(trasElse && empiezaConElse(r))
+            for(int q : ps) if(!empiezaConElse(q)){ r = q; break; }
+        nivel[A]++;
+        for(int s : g.reglas[r].rhs) derivar(s, prof + 1);
+        nivel[A]--;
+        if(empiezaConElse(r)) trasElse = true;
+    }
+    bool empiezaConElse(int r) const { return tElse >= 0 && !g.reglas[r].rhs.empty() && g.reglas[r].rhs[0] == tElse; }
+
+    // A ::= \e | alfa A: se emite alfa k veces. La lista más externa crece
+    // hasta el tamaño pedido; las internas tienen de 0 a 'lista' elementos.
+    void derivarLista(int A, int prof){
+        int rCola = -1;
+        for(int r : porLhs[A]){
+            const auto &rhs = g.reglas[r].rhs;
+            if(!rhs.empty() && rhs.back() == A) rCola = r;
+        }
+        const auto &rhs = g.reglas[rCola].rhs;
+        bool externa = listas == 0;
+        int k = nivel[A] >= op->anidamiento ? 0 : (int)(azar() % (op->lista + 1));
+        listas++;
+        nivel[A]++;
+        for(int i=0; externa ? emitidos < op->tokens : i < k; i++)
+            for(size_t j=0;j+1<rhs.size();j++) derivar(rhs[j], prof + 1);
+        nivel[A]--;
+        listas--;
+    }
+
+    void emitir(int t){
+        const std::string &clave = g.nombres[t];
+        trasElse = false;
+        if(clave == "}"){ llaves = std::max(0, llaves - 1); salto(); }
+        else if(!salida.empty() && salida.back() != '\n' && salida.back() != ' ') salida += ' ';
+        salida += lexema(clave);
+        emitidos++;
+        if(clave == "{"){ llaves++; salto(); }
+        else if(clave == ";" || clave == "}") salto();
+    }
+    void salto(){
+        while(!salida.empty() && salida.back() == ' ') salida.pop_back();
+        if(!salida.empty() && salida.back() != '\n') salida += '\n';
+        salida.append(2 * llaves, ' ');
+    }
+
+    // Lexema concreto de cada clave del .inf (lexer.h); las claves que no
+    // son categorías se escriben tal cual.
+    std::string lexema(const std::string &clave){
+        static const char *const NOMBRES[] = {"a", "b", "x", "y", "i", "n", "suma", "total", "valor", "f", "g", "h"};
+        if(clave == "identificador") return std::string(NOMBRES[azar() % 12]) + (azar() % 2 ? std::to_string(azar() % 100) : "");
+        if(clave == "entero") return std::to_string(azar() % 1000);
+        if(clave == "real") return std::to_string(azar() % 100) + "." + std::to_string(azar() % 100);
+        if(clave == "cadena") return azar() % 2 ? "\"hola\"" : "\"texto de prueba\"";
+        if(clave == "tipo") return azar() % 2 ? "int" : "float";
+        if(clave == "opSuma") return azar() % 2 ? "+" : "-";
+        if(clave == "opMul") return azar() % 2 ? "*" : "/";
+        if(clave == "opRelac"){ static const char *const R[] = {"<", ">", "<=", ">="}; return R[azar() % 4]; }
+        if(clave == "opIgualdad") return azar() % 2 ? "==" : "!=";
+        if(clave == "opAnd") return "&&";
+        if(clave == "opOr") return "||";
+        if(clave == "opNot") return "!";
+        return clave;
+    }
+};
+
+#endif
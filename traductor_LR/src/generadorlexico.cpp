@@ -1,116 +1,56 @@
+// generadorlexico.cpp
+// Genera el analizador léxico a partir de las definiciones de tokens (.lex):
+// AFN de Thompson, AFD por subconjuntos sobre clases de bytes y AFD mínimo
+// de Hopcroft (automata_lexico.h). Escribe las tablas como arreglos
+// constexpr en lexer_generado.h; LexerDFA(lexer_generado::AUTOMATA, texto)
+// devuelve los mismos tokens que LexerRapido.
+// Con --tokens no escribe nada: analiza stdin con el autómata y lista los
+// tokens (TIPO<tab>lexema), como hacía la versión escrita a mano.
+// Compilar: g++ -std=c++17 -O2 generadorlexico.cpp -o generadorlexico
+// Ejecutar: ./generadorlexico compilador.lex lexer_generado.h
+//           ./generadorlexico --tokens compilador.lex < entrada.txt
+// benchmark.cpp compara lexer_generado.h con LexerRapido si al compilar
+// estaba presente (--verificar-lexer).
+
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <string>
-#include <cctype>
 #include <vector>
+#include "automata_lexico.h"
 
-enum class TokenType {
-    IDENT,   // identificador
-    REAL,    // numero real: entero '.' entero+
-    DESCONOCIDO,
-    FIN
-};
-
-struct Token {
-    TokenType type;
-    std::string lexeme;
-    size_t pos;
-};
-
-class Lexer {
-public:
-    explicit Lexer(const std::string& src) : s(src), n(src.size()), i(0) {}
-
-    Token next() {
-        saltarBlancos();
-
-        if (i >= n) return {TokenType::FIN, "", i};
-
-        char c = s[i];
-
-        // identificador: letra (letra | digito)*
-        if (esLetra(c)) {
-            size_t start = i++;
-            while (i < n && (esLetra(s[i]) || std::isdigit(static_cast<unsigned char>(s[i])))) {
-                ++i;
-            }
-            return {TokenType::IDENT, s.substr(start, i - start), start};
-        }
-
-        // Real: entero '.' entero+
-        if (std::isdigit(static_cast<unsigned char>(c))) {
-            size_t start = i;
-            // parte entera (>=1 dígito)
-            while (i < n && std::isdigit(static_cast<unsigned char>(s[i]))) ++i;
-
-            if (i < n && s[i] == '.') {
-                size_t punto = i++;
-                size_t afterDot = i;
-                // al menos 1 dígito después del punto
-                if (i < n && std::isdigit(static_cast<unsigned char>(s[i]))) {
-                    while (i < n && std::isdigit(static_cast<unsigned char>(s[i]))) ++i;
-                    return {TokenType::REAL, s.substr(start, i - start), start};
-                } else {
-                    // retrocede si no hubo dígitos tras el punto, para no “consumir” el '.'
-                    i = punto; // dejamos el '.' para que se marque como desconocido abajo
-                }
-            }
-
-            // Si llegamos aquí, eran solo dígitos (entero) o algo invalida el real
-            // Como no se pidió token ENTERO, lo reportamos como desconocido completo.
-            // Consumimos un carácter para no quedarnos estancados.
-            ++i;
-            return {TokenType::DESCONOCIDO, s.substr(start, 1), start};
-        }
-
-        // Cualquier otro símbolo: DESCONOCIDO (consume 1 char)
-        size_t start = i++;
-        return {TokenType::DESCONOCIDO, s.substr(start, 1), start};
-    }
-
-private:
-    const std::string& s;
-    size_t n;
-    size_t i;
-
-    static bool esLetra(char c) {
-        // Solo letras ASCII como “letra”; si quieres permitir '_', cámbialo aquí.
-        return std::isalpha(static_cast<unsigned char>(c)) != 0;
-    }
-
-    void saltarBlancos() {
-        while (i < n && std::isspace(static_cast<unsigned char>(s[i]))) ++i;
-    }
-};
-
-int main() {
+int main(int argc, char **argv){
     std::ios::sync_with_stdio(false);
     std::cin.tie(nullptr);
 
-    std::string entrada, linea;
-    // Lee todo stdin (múltiples líneas) en un solo string
-    while (std::getline(std::cin, linea)) {
-        if (!entrada.empty()) entrada.push_back('\n');
-        entrada += linea;
+    bool listar = argc >= 2 && std::string(argv[1]) == "--tokens";
+    if(argc < 3){
+        std::cerr << "Uso: " << argv[0] << " <tokens.lex> <lexer_generado.h>\n";
+        std::cerr << "     " << argv[0] << " --tokens <tokens.lex> < entrada.txt\n";
+        return 1;
+    }
+    std::string rutaLex = argv[listar ? 2 : 1], error;
+    TablaLexica t;
+    if(!cargarLexico(rutaLex, t, error)){
+        std::cerr << "Error: " << error << "\n";
+        return 1;
     }
 
-    Lexer lx(entrada);
-    for (;;) {
-        Token t = lx.next();
-        if (t.type == TokenType::FIN) break;
+    if(listar){
+        std::string entrada((std::istreambuf_iterator<char>(std::cin)), std::istreambuf_iterator<char>());
+        LexerDFA lx(t.vista(), entrada);
+        for(Token tk = lx.next(); tk.type != TokenType::FIN; tk = lx.next())
+            std::cout << nombreTipoToken(tk.type) << "\t" << tk.lexeme << "\n";
+        return 0;
+    }
 
-        switch (t.type) {
-            case TokenType::IDENT:
-                std::cout << "IDENT\t" << t.lexeme << "\n";
-                break;
-            case TokenType::REAL:
-                std::cout << "REAL\t" << t.lexeme << "\n";
-                break;
-            case TokenType::DESCONOCIDO:
-                std::cout << "DESCONOCIDO\t" << t.lexeme << "\n";
-                break;
-            default:
-                break;
-        }
+    std::ofstream out(argv[2]);
+    if(!out){
+        std::cerr << "Error: no se puede escribir " << argv[2] << "\n";
+        return 1;
     }
+    escribirLexerGenerado(out, t, rutaLex);
+    reporteLexico(t, std::cerr);
+    std::cerr << "Escrito " << argv[2] << "\n";
     return 0;
 }
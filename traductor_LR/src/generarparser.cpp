@@ -0,0 +1,224 @@
+// generarparser.cpp
+// Genera un parser directo (parser_generado.h) para una gramática fija: cada
+// estado LR es un bloque de código con un switch sobre el tipo de token, y
+// las longitudes de regla y los destinos de goto quedan como constantes. El
+// parser resultante construye el mismo árbol y da los mismos diagnósticos
+// que analizarLR (parser.h) sobre la tabla de la que se generó, sin leer la
+// tabla en tiempo de ejecución.
+// Compilar: g++ -std=c++17 -O2 generarparser.cpp -o generarparser
+// Ejecutar: ./generarparser compilador.lr compilador.inf parser_generado.h
+// Después se recompilan traductor.cpp y benchmark.cpp: si encuentran
+// parser_generado.h lo incluyen (opción --directo / comparación en el benchmark).
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "gramatica.h"
+#include "parser.h"
+
+static std::string literalC(const std::string &s){
+    std::string r = "\"";
+    for(char c : s){
+        if(c == '"' || c == '\\') r += '\\';
+        r += c;
+    }
+    return r + "\"";
+}
+
+/* ------------------ Generación ------------------ */
+// Escribe el parser directo para G (con resolverTokens() ya aplicado).
+static bool generarParser(const LRGram &G, const std::string &origen, std::ostream &os, std::string &error){
+    const int nTipos = (int)TokenType::FIN + 1;
+    const int nNoTerm = G.nCols - G.nColsTerm;
+    for(int r=0;r<G.nReglas;r++)
+        if(G.idRegla[r] < G.nColsTerm || G.idRegla[r] >= G.nCols || G.lonRegla[r] < 0){
+            error = "la regla " + std::to_string(r+1) + " no tiene un no-terminal o una longitud válidos";
+            return false;
+        }
+
+    // Estados que alguna vez quedan en la cima: el inicial, los destinos de
+    // desplazamiento y los de goto. Sólo ésos necesitan etiqueta.
+    std::vector<char> alcanzable(G.nFilas, 0);
+    alcanzable[0] = 1;
+    for(int e=0;e<G.nFilas;e++)
+        for(int c=0;c<G.nCols;c++){
+            int a = G.accion(e, c);
+            if(a >= G.nFilas || a < -(G.nReglas+1)){
+                error = "acción fuera de rango en el estado " + std::to_string(e) + ", columna " + std::to_string(c);
+                return false;
+            }
+            if(a > 0) alcanzable[a] = 1;
+        }
+
+    os << "// parser_generado.h\n"
+       << "// GENERADO por generarparser a partir de " << origen << "; no editar.\n"
+       << "// Parser directo: un bloque por estado, sin tabla en tiempo de ejecución.\n"
+       << "#ifndef PARSER_GENERADO_H\n#define PARSER_GENERADO_H\n\n"
+       << "#include \"parser.h\"\n\n"
+       << "namespace parser_generado {\n\n"
+       << "// huellaGramatica() de la tabla de origen\n"
+       << "constexpr uint32_t HUELLA = " << huellaGramatica(G) << "u;\n"
+       << "constexpr int N_REGLAS = " << G.nReglas << ", N_ESTADOS = " << G.nFilas << ";\n\n";
+
+    os << "inline const char *const NOMBRE_REGLA[N_REGLAS] = {";
+    for(int r=0;r<G.nReglas;r++) os << (r % 8 ? " " : "\n    ") << literalC(G.nombreRegla(r)) << ",";
+    os << "\n};\n\n";
+    // Columna de cada tipo de token; -1 sin mapeo en el .inf.
+    os << "constexpr int16_t COL_TOKEN[" << nTipos << "] = {";
+    for(int t=0;t<nTipos;t++) os << (t ? ", " : "") << G.colToken[t];
+    os << "};\n\n";
+
+    os << "template<class Constructor, class Fuente>\n"
+       << "Diagnostico analizar(Fuente &lx, Constructor &cons){\n"
+       << "    std::vector<int> estados;\n"
+       << "    estados.reserve(256);\n"
+       << "    estados.push_back(0);\n"
+       << "    Diagnostico d;\n"
+       << "    auto error = [&d](size_t pos, auto&&... partes){\n"
+       << "        std::ostringstream os;\n"
+       << "        (os << ... << partes);\n"
+       << "        d.pos = pos;\n"
+       << "        d.mensaje = os.str();\n"
+       << "        return d;\n"
+       << "    };\n"
+       << "    int regla = 0, lon = 0;\n"
+       << "    Token tk = lx.next();\n"
+       << "    // Un token desconocido o sin mapeo falla en cuanto se lee, como en analizarLR.\n"
+       << "    if(tk.type == TokenType::DESCONOCIDO || COL_TOKEN[(int)tk.type] < 0) goto token_invalido;\n"
+       << "    goto e0;\n\n";
+
+    // Acción de un estado para un terminal, como sentencias con sangría 'sg'.
+    auto sentencia = [&](int e, int a, const std::string &sg) -> std::string {
+        std::ostringstream s;
+        s << sg;
+        if(a > 0){
+            s << "estados.push_back(" << a << ");\n" << sg << "cons.desplazar(tk);\n" << sg << "tk = lx.next();\n"
+              << sg << "if(tk.type == TokenType::DESCONOCIDO || COL_TOKEN[(int)tk.type] < 0) goto token_invalido;\n"
+              << sg << "goto e" << a << ";";
+        } else if(a == -1){
+            s << "cons.aceptar(); d.aceptada = true; return d;";
+        } else if(a < 0){
+            int r = -a - 1;
+            if(r <= 0 || r > G.nReglas){
+                s << "return error(tk.pos, \"Error sintáctico: Regla inválida " << r << " en estado " << e
+                  << " con token '\", tokenToKey(tk.type), \"'\");";
+                return s.str();
+            }
+            int L = G.lonRegla[r-1];
+            if(L > 0)
+                s << "if(estados.size() <= " << L << ") return error(tk.pos, \"Error interno del parser: Pila vacía durante reducción de la regla "
+                  << r << "\");\n" << sg << "estados.resize(estados.size() - " << L << ");\n" << sg;
+            s << "regla = " << r << "; lon = " << L << "; goto ir" << G.idRegla[r-1] << ";";
+        } else {
+            s << "goto error" << e << ";";
+        }
+        return s.str();
+    };
+
+    for(int e=0;e<G.nFilas;e++){
+        if(!alcanzable[e]) continue;
+        // Tipos de token mapeados agrupados por acción.
+        std::map<int, std::vector<int>> porAccion;
+        for(int t=0;t<nTipos;t++){
+            if(t == (int)TokenType::DESCONOCIDO || G.colToken[t] < 0) continue;
+            porAccion[G.accion(e, G.colToken[t])].push_back(t);
+        }
+        os << "e" << e << ":\n";
+        if(porAccion.size() == 1){ // reducción por defecto o estado de una sola acción
+            os << sentencia(e, porAccion.begin()->first, "    ") << "\n";
+        } else {
+            os << "    switch(tk.type){\n";
+            for(const auto &pa : porAccion){
+                if(pa.first == 0) continue;
+                for(size_t i=0;i<pa.second.size();i++) os << (i ? " " : "    ") << "case TokenType::" << nombreTipoToken((TokenType)pa.second[i]) << ":";
+                os << "\n" << sentencia(e, pa.first, "        ") << "\n";
+            }
+            os << "    default: goto error" << e << ";\n    }\n";
+        }
+        bool conError = porAccion.count(0) || porAccion.size() > 1;
+        if(conError)
+            os << "error" << e << ":\n    return error(tk.pos, \"Error sintáctico: No se esperaba el token '\", tokenToKey(tk.type), \"' (lexeme='\", tk.lexeme,\n"
+               << "                 \"') en estado " << e << " en la posición \", tk.pos, \".\");\n";
+    }
+
+    // Un bloque de goto por no-terminal: el destino depende sólo del estado
+    // que quedó en la cima; el caso más frecuente va en default.
+    for(int nt=0;nt<nNoTerm;nt++){
+        int col = G.nColsTerm + nt;
+        bool usado = false;
+        for(int r=0;r<G.nReglas;r++) usado |= G.idRegla[r] == col;
+        if(!usado) continue;
+        std::map<int, std::vector<int>> porDestino;
+        for(int e=0;e<G.nFilas;e++) porDestino[G.accion(e, col)].push_back(e);
+        int defecto = 0;
+        size_t maxN = 0;
+        for(const auto &pd : porDestino) if(pd.second.size() > maxN){ maxN = pd.second.size(); defecto = pd.first; }
+        auto salto = [&](int g){
+            std::ostringstream s;
+            if(g > 0) s << "estados.push_back(" << g << ");\n        cons.reducir(regla, lon);\n        goto e" << g << ";";
+            else s << "return error(tk.pos, \"Error sintáctico: Goto inválido (0) después de reducción de la regla \", NOMBRE_REGLA[regla-1],\n"
+                   << "                     \" en estado \", estados.back(), \" con no-terminal " << col << "\");";
+            return s.str();
+        };
+        os << "ir" << col << ":\n    switch(estados.back()){\n";
+        for(const auto &pd : porDestino){
+            if(pd.first == defecto) continue;
+            for(size_t i=0;i<pd.second.size();i++) os << (i % 12 ? " " : i ? "\n    " : "    ") << "case " << pd.second[i] << ":";
+            os << "\n        " << salto(pd.first) << "\n";
+        }
+        os << "    default:\n        " << salto(defecto) << "\n    }\n";
+    }
+    os << "token_invalido:\n"
+       << "    if(tk.type == TokenType::DESCONOCIDO)\n"
+       << "        return error(tk.pos, \"Error léxico: Carácter desconocido '\", tk.lexeme, \"' en posición \", tk.pos);\n"
+       << "    return error(tk.pos, \"Error sintáctico: Token '\", tokenToKey(tk.type), \"' (lexeme='\", tk.lexeme, \"') en posición \", tk.pos,\n"
+       << "                 \" no tiene mapeo en el archivo .inf. Esto puede indicar un token inesperado o una configuración incorrecta.\");\n"
+       << "}\n\n";
+
+    os << "inline Diagnostico parseLR(std::string_view entrada, Arbol &arbol){\n"
+       << "    ConstruirArbol cons(arbol);\n"
+       << "    LexerRapido lx(entrada);\n"
+       << "    return analizar(lx, cons);\n"
+       << "}\n\n"
+       << "inline Diagnostico reconocerLR(std::string_view entrada){\n"
+       << "    SoloReconocer cons;\n"
+       << "    LexerRapido lx(entrada);\n"
+       << "    return analizar(lx, cons);\n"
+       << "}\n\n"
+       << "} // namespace parser_generado\n\n#endif\n";
+    return true;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 4) {
+        std::cerr << "Uso: " << argv[0] << " <archivo_gramatica.lr> <archivo_mapeo.inf> <salida.h>\n";
+        return 1;
+    }
+    LRGram G;
+    if (!cargarLR(argv[1], G)) return 1;
+    if (!leerInf(argv[2], G)) {
+        std::cerr << "Error: El archivo .inf está vacío o no se pudo leer.\n";
+        return 1;
+    }
+    resolverTokens(G);
+
+    std::string origen = argv[1], error;
+    origen = origen.substr(origen.find_last_of('/') + 1);
+    std::ostringstream os;
+    if (!generarParser(G, origen, os, error)) {
+        std::cerr << "Error: " << error << "\n";
+        return 1;
+    }
+    std::ofstream f(argv[3], std::ios::binary);
+    if (!(f << os.str())) {
+        std::cerr << "Error: no se pudo escribir " << argv[3] << "\n";
+        return 1;
+    }
+    std::cout << argv[3] << ": " << G.nFilas << " estados, " << G.nReglas << " reglas, huella "
+              << huellaGramatica(G) << ", " << os.str().size() << " bytes\n";
+    return 0;
+}
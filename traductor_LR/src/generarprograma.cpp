@@ -0,0 +1,42 @@
+// generarprograma.cpp
+// Escribe en stdout un programa aleatorio válido para la gramática del .inf
+// (ver generador.h).
+// Compilar: g++ -std=c++17 -O2 generarprograma.cpp -o generarprograma
+// Ejecutar: ./generarprograma compilador.inf [--tokens N] [--anidamiento D] [--complejidad C]
+//               [--lista L] [--expresion <no-terminal>] [--semilla S] > programa.txt
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "generador.h"
+
+int main(int argc, char **argv) {
+    OpcionesGenerador op;
+    std::string rutaInf;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hayValor = i + 1 < argc;
+        if (arg == "--tokens" && hayValor) op.tokens = (size_t)std::atoll(argv[++i]);
+        else if (arg == "--anidamiento" && hayValor) op.anidamiento = std::atoi(argv[++i]);
+        else if (arg == "--complejidad" && hayValor) op.complejidad = std::atoi(argv[++i]);
+        else if (arg == "--lista" && hayValor) op.lista = std::atoi(argv[++i]);
+        else if (arg == "--expresion" && hayValor) op.expresion = argv[++i];
+        else if (arg == "--semilla" && hayValor) op.semilla = (uint32_t)std::atoll(argv[++i]);
+        else rutaInf = arg;
+    }
+    if (rutaInf.empty()) {
+        std::cerr << "Uso: " << argv[0] << " <archivo_mapeo.inf> [--tokens N] [--anidamiento D] [--complejidad C]"
+                     " [--lista L] [--expresion <no-terminal>] [--semilla S]\n";
+        return 1;
+    }
+    GramaticaBNF g;
+    std::string error;
+    if (!leerProducciones(rutaInf, g, error)) {
+        std::cerr << "Error: " << error << "\n";
+        return 1;
+    }
+    GeneradorProgramas gen(g);
+    std::cout << gen.generar(op);
+    std::cerr << gen.tokens() << " tokens\n";
+    return 0;
+}
@@ -0,0 +1,61 @@
+// generartabla.cpp
+// Genera la tabla LALR(1) (.lr) a partir de las producciones del .inf
+// (ver lalr.h), en lugar de depender de una herramienta externa.
+// Compilar: g++ -std=c++17 -O2 generartabla.cpp -o generartabla
+// Ejecutar: ./generartabla compilador.inf compilador.lr [--sin-precedencia] [--conflictos]
+//           --conflictos: lista también los conflictos resueltos por precedencia
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "gramatica.h"
+#include "lalr.h"
+
+int main(int argc, char **argv) {
+    bool conPrecedencia = true, todos = false;
+    std::vector<std::string> rutas;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--sin-precedencia") conPrecedencia = false;
+        else if (arg == "--conflictos") todos = true;
+        else rutas.push_back(arg);
+    }
+    if (rutas.size() < 2) {
+        std::cerr << "Uso: " << argv[0] << " <archivo_mapeo.inf> <salida.lr> [--sin-precedencia] [--conflictos]\n";
+        return 1;
+    }
+
+    GramaticaBNF g;
+    TablaLALR t;
+    std::string error;
+    auto t0 = std::chrono::steady_clock::now();
+    if (!leerProducciones(rutas[0], g, error) || !generarLALR(g, t, error, conPrecedencia)) {
+        std::cerr << "Error: " << error << "\n";
+        return 1;
+    }
+    double ms = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count() * 1e3;
+    reportarConflictos(g, t, std::cerr, todos);
+
+    std::ostringstream os;
+    escribirLR(g, t, os);
+    std::ofstream f(rutas[1], std::ios::binary);
+    if (!(f << os.str())) {
+        std::cerr << "Error: no se pudo escribir " << rutas[1] << "\n";
+        return 1;
+    }
+    f.close();
+
+    // Se vuelve a cargar para comprobar que cargarLR acepta la tabla generada.
+    LRGram G;
+    std::istringstream is(os.str());
+    if (!cargarLR(is, G) || !leerInf(rutas[0], G)) return 1;
+    size_t porPrecedencia = 0;
+    for (const Conflicto &c : t.conflictos) porPrecedencia += c.porPrecedencia;
+    std::cout << rutas[1] << ": " << g.reglas.size() << " reglas, " << g.nTerminales << " terminales, "
+              << g.nSimbolos() - g.nTerminales << " no-terminales; " << t.nEstados << " estados, " << t.nItems << " ítems, "
+              << t.nTransNoTerm << " transiciones con no-terminal; " << t.conflictos.size() << " conflictos ("
+              << porPrecedencia << " resueltos por precedencia); " << ms << " ms\n";
+    return 0;
+}
@@ -0,0 +1,558 @@
+// gramatica.h
+// Tablas del parser LR. Se cargan de dos formas:
+//   - ruta de texto: compilador.lr + compilador.inf (cargarLR / leerInf)
+//   - binario precompilado (.lrb, ver compilartabla.cpp): se proyecta con mmap
+//     y se usa en sitio, sin interpretar texto ni reservar memoria.
+// En ambos casos LRGram sólo expone punteros; la ruta de texto los hace
+// apuntar a su almacenamiento propio.
+//
+// La tabla acción/goto no se guarda densa (casi todas las celdas son 0): se
+// empaqueta por desplazamiento de filas (comb-vector) en un solo buffer de
+// enteros de 16 bits, con una reducción por defecto por estado y un goto por
+// defecto por no-terminal. accion(estado, col) devuelve lo mismo que la
+// tabla densa salvo en los estados con reducción por defecto, donde toda
+// columna terminal reduce, y en los goto vacíos que ninguna reducción puede
+// consultar, que devuelven el goto por defecto. Un estado sólo recibe
+// reducción por defecto si, para cada terminal que la tabla densa rechaza
+// en él, las reducciones que siguen terminan en error sin desplazar ni
+// aceptar ese terminal: reducir antes no cambia qué se acepta. Con el else
+// colgante no siempre es así (if(1) if(2){ } else { } else ...: reducir el
+// if interno deja al else desplazable en el externo) y esos estados
+// conservan sus celdas. Los goto vacíos que sí se pueden consultar (esta
+// tabla tiene reducciones cuyo goto está vacío en algunos contextos) se
+// guardan como celdas explícitas con 0.
+#ifndef GRAMATICA_H
+#define GRAMATICA_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define LRB_MMAP 1
+#endif
+
+/* ------------------ Tabla compacta ------------------ */
+// Buffer = CabeceraCompacta + FilaCompacta[nFilas] + int16 gotoDefecto[] +
+// Celda[nCeldas], alineado a 4 bytes.
+struct CabeceraCompacta {
+    uint32_t nFilas, nCols, nColsTerm, nCeldas;
+};
+struct FilaCompacta {
+    int32_t base;     // desplazamiento de la fila dentro de 'celdas'
+    int16_t defecto;  // reducción por defecto (codificada como acción), 0 = ninguna
+    int16_t reservado;
+};
+struct Celda {
+    int16_t valor;
+    uint16_t chequeo; // estado dueño de la celda; CELDA_LIBRE si no tiene
+};
+const uint16_t CELDA_LIBRE = 0xFFFF;
+
+constexpr size_t bytesCompacta(uint32_t nFilas, uint32_t nCols, uint32_t nColsTerm, uint32_t nCeldas){
+    size_t nGoto = ((size_t)(nCols - nColsTerm) + 1) & ~(size_t)1; // int16 -> múltiplo de 4 bytes
+    return sizeof(CabeceraCompacta) + nFilas*sizeof(FilaCompacta) + nGoto*sizeof(int16_t) + (size_t)nCeldas*sizeof(Celda);
+}
+
+// Empaqueta la tabla densa (nFilas x nCols, por filas). Las columnas
+// [0, nColsTerm) son terminales y el resto no-terminales; idRegla y lonRegla
+// (por regla) dicen qué gotos puede consultar cada reducción.
+inline bool compactarTabla(const std::vector<int32_t> &densa, int nFilas, int nCols, int nColsTerm,
+                           const std::vector<int32_t> &idRegla, const std::vector<int32_t> &lonRegla, std::vector<uint32_t> &buf){
+    if(nFilas >= CELDA_LIBRE) { std::cerr<<"Error: demasiados estados para la tabla compacta\n"; return false; }
+    for(int32_t a : densa)
+        if(a > INT16_MAX || a < INT16_MIN){ std::cerr<<"Error: acción fuera del rango de 16 bits\n"; return false; }
+    auto celda = [&](int e, int c){ return densa[(size_t)e*nCols + c]; };
+
+    // Goto por defecto: el destino más frecuente de cada no-terminal.
+    int nNoTerm = nCols - nColsTerm;
+    std::vector<int16_t> gotoDef(nNoTerm, 0);
+    for(int nt=0;nt<nNoTerm;nt++){
+        std::map<int,int> frec;
+        for(int e=0;e<nFilas;e++) if(int g = celda(e, nColsTerm+nt)) frec[g]++;
+        int mejor = 0;
+        for(auto &kv : frec) if(kv.second > mejor){ mejor = kv.second; gotoDef[nt] = (int16_t)kv.first; }
+    }
+
+    // Gotos que se pueden consultar: tras reducir por A -> alfa en el estado t
+    // se consulta goto(s, A) para todo s desde el que se llega a t en
+    // |alfa| transiciones (se sobreestima sin mirar los símbolos de alfa).
+    std::vector<std::vector<int>> previos(nFilas);
+    for(int e=0;e<nFilas;e++)
+        for(int c=0;c<nCols;c++){
+            int a = celda(e, c);
+            if(a > 0 && a < nFilas) previos[a].push_back(e);
+        }
+    std::vector<char> consultado((size_t)nFilas * nNoTerm, 0);
+    std::vector<char> marca(nFilas), sigMarca(nFilas);
+    for(int r=0;r<(int)idRegla.size();r++){
+        int nt = idRegla[r] - nColsTerm;
+        if(nt < 0 || nt >= nNoTerm) continue;
+        std::fill(marca.begin(), marca.end(), 0);
+        bool alguno = false;
+        for(int e=0;e<nFilas;e++)
+            for(int c=0;c<nColsTerm && !marca[e];c++) if(celda(e, c) == -(r+2)) marca[e] = alguno = true;
+        for(int paso=0; alguno && paso<lonRegla[r]; paso++){
+            std::fill(sigMarca.begin(), sigMarca.end(), 0);
+            for(int e=0;e<nFilas;e++) if(marca[e]) for(int p : previos[e]) sigMarca[p] = 1;
+            marca.swap(sigMarca);
+        }
+        for(int e=0;e<nFilas;e++) if(marca[e]) consultado[(size_t)e*nNoTerm + nt] = 1;
+    }
+
+    // Reducción por defecto: candidatas las filas cuyo único movimiento con
+    // terminales es una misma reducción.
+    std::vector<int> defecto(nFilas, 0);
+    for(int e=0;e<nFilas;e++){
+        int red = 0; bool consistente = true;
+        for(int c=0;c<nColsTerm;c++){
+            int a = celda(e, c);
+            if(a == 0) continue;
+            if(a >= -1 || (red && a != red)) { consistente = false; break; }
+            red = a;
+        }
+        if(consistente) defecto[e] = red;
+    }
+    // rechaza(e, c): con el terminal c (error en la tabla densa) la reducción
+    // por defecto de e lleva, por reducciones con c o por defecto, sólo a
+    // estados que dan error; ninguno desplaza ni acepta c. Los estados bajo
+    // la reducción se sobreestiman con 'previos', como arriba.
+    std::vector<char> visto(nFilas);
+    auto rechaza = [&](int e, int c){
+        std::fill(visto.begin(), visto.end(), 0);
+        std::vector<int> pendientes{e};
+        visto[e] = 1;
+        while(!pendientes.empty()){
+            int t = pendientes.back(); pendientes.pop_back();
+            int a = celda(t, c);
+            if(a == 0) a = defecto[t];
+            if(a == 0) continue;
+            if(a >= -1) return false;
+            int r = -a - 2, nt = idRegla[r] - nColsTerm;
+            if(nt < 0 || nt >= nNoTerm) return false;
+            std::fill(marca.begin(), marca.end(), 0);
+            marca[t] = 1;
+            for(int paso=0; paso<lonRegla[r]; paso++){
+                std::fill(sigMarca.begin(), sigMarca.end(), 0);
+                for(int s=0;s<nFilas;s++) if(marca[s]) for(int p : previos[s]) sigMarca[p] = 1;
+                marca.swap(sigMarca);
+            }
+            for(int s=0;s<nFilas;s++){
+                int g = marca[s] ? celda(s, nColsTerm+nt) : 0;
+                if(g > 0 && g < nFilas && !visto[g]){ visto[g] = 1; pendientes.push_back(g); }
+            }
+        }
+        return true;
+    };
+    // Quitar un defecto sólo hace que otros estados den error antes, así que
+    // se descartan los inseguros hasta que no quede ninguno.
+    for(bool cambio = true; cambio; ){
+        cambio = false;
+        for(int e=0;e<nFilas;e++)
+            for(int c=0;c<nColsTerm && defecto[e];c++)
+                if(celda(e, c) == 0 && !rechaza(e, c)){ defecto[e] = 0; cambio = true; }
+    }
+
+    // Entradas explícitas de cada fila; las que tienen defecto no guardan
+    // sus terminales.
+    std::vector<FilaCompacta> filas(nFilas, FilaCompacta{0, 0, 0});
+    std::vector<std::vector<std::pair<int,int16_t>>> entradas(nFilas);
+    for(int e=0;e<nFilas;e++){
+        if(defecto[e]) filas[e].defecto = (int16_t)defecto[e];
+        else for(int c=0;c<nColsTerm;c++) if(int a = celda(e, c)) entradas[e].push_back({c, (int16_t)a});
+        for(int nt=0;nt<nNoTerm;nt++){
+            int g = celda(e, nColsTerm+nt);
+            if(g != gotoDef[nt] && (g != 0 || consultado[(size_t)e*nNoTerm + nt])) entradas[e].push_back({nColsTerm+nt, (int16_t)g});
+        }
+    }
+
+    // Primer ajuste, filas más pobladas primero.
+    std::vector<int> orden(nFilas);
+    for(int e=0;e<nFilas;e++) orden[e] = e;
+    std::stable_sort(orden.begin(), orden.end(), [&](int a, int b){ return entradas[a].size() > entradas[b].size(); });
+    std::vector<Celda> celdas;
+    for(int e : orden){
+        if(entradas[e].empty()) continue;
+        int32_t b = 0;
+        for(;; b++){
+            bool libre = true;
+            for(auto &en : entradas[e]){
+                size_t k = (size_t)(b + en.first);
+                if(k < celdas.size() && celdas[k].chequeo != CELDA_LIBRE){ libre = false; break; }
+            }
+            if(libre) break;
+        }
+        filas[e].base = b;
+        for(auto &en : entradas[e]){
+            size_t k = (size_t)(b + en.first);
+            if(k >= celdas.size()) celdas.resize(k+1, Celda{0, CELDA_LIBRE});
+            celdas[k] = Celda{en.second, (uint16_t)e};
+        }
+    }
+    // Relleno para que base+col quede siempre dentro del arreglo.
+    int32_t maxBase = 0;
+    for(auto &f : filas) maxBase = std::max(maxBase, f.base);
+    celdas.resize(std::max<size_t>(celdas.size(), (size_t)(maxBase + nCols)), Celda{0, CELDA_LIBRE});
+
+    CabeceraCompacta h{(uint32_t)nFilas, (uint32_t)nCols, (uint32_t)nColsTerm, (uint32_t)celdas.size()};
+    buf.assign((bytesCompacta(h.nFilas, h.nCols, h.nColsTerm, h.nCeldas) + 3) / 4, 0);
+    char *p = (char*)buf.data();
+    std::memcpy(p, &h, sizeof h); p += sizeof h;
+    std::memcpy(p, filas.data(), filas.size()*sizeof(FilaCompacta)); p += filas.size()*sizeof(FilaCompacta);
+    std::memcpy(p, gotoDef.data(), gotoDef.size()*sizeof(int16_t)); p += (((size_t)nNoTerm + 1) & ~(size_t)1)*sizeof(int16_t);
+    std::memcpy(p, celdas.data(), celdas.size()*sizeof(Celda));
+    return true;
+}
+
+/* ------------------ LR Loader ------------------ */
+const int MAX_TIPOS_TOKEN = 32;
+
+struct LRGram {
+    int nReglas = 0;
+    const int32_t *idRegla = nullptr;   // columna del no-terminal de cada regla
+    const int32_t *lonRegla = nullptr;  // símbolos del lado derecho
+    const uint32_t *nomRegla = nullptr; // desplazamiento del nombre en 'cadenas'
+    int nFilas = 0, nCols = 0;
+    int nColsTerm = 0;                  // columnas [0, nColsTerm) son terminales
+    const CabeceraCompacta *compacta = nullptr; // buffer completo de la tabla
+    const FilaCompacta *filas = nullptr;
+    const int16_t *gotoDefecto = nullptr;
+    const Celda *celdas = nullptr;
+    int nTerminales = 0;
+    const uint32_t *termNombre = nullptr; // claves del .inf, ordenadas
+    const int32_t *termCol = nullptr;
+    const char *cadenas = nullptr;
+    // Columna de cada tipo de token del lexer (-1 sin mapeo); la llena
+    // resolverTokens() una sola vez, después de cargar.
+    int16_t colToken[MAX_TIPOS_TOKEN] = {};
+    // Cadenas de reducciones que siguen a un goto sin leer otro token
+    // (construirAtajos, parser.h). Vacíos: el ciclo LR consulta paso a paso.
+    std::vector<int16_t> filaAtajo;     // [estado*(nCols-nColsTerm) + nt] -> fila de 'atajo', -1 si no hay
+    std::vector<uint16_t> atajo;        // [fila*nColsTerm + col] -> inicio en 'cadenaAtajo', 0 si no hay
+    std::vector<int16_t> cadenaAtajo;   // n, (regla, estado que decide) x n, m, estados que quedan x m
+
+    // Codificación de la tabla: >0 desplazar a ese estado, -1 aceptar,
+    // -(r+1) reducir por la regla r (1..nReglas), 0 error.
+    int accion(int estado, int col) const {
+        const FilaCompacta &f = filas[estado];
+        if(col < nColsTerm && f.defecto) return f.defecto;
+        const Celda &c = celdas[f.base + col];
+        if(c.chequeo == estado) return c.valor;
+        return col < nColsTerm ? 0 : gotoDefecto[col - nColsTerm];
+    }
+    int reduccionPorDefecto(int estado) const { return filas[estado].defecto; }
+    const char* nombreRegla(int r) const { return cadenas + nomRegla[r]; }
+
+    // Columna de un terminal del .inf, o -1 si no tiene mapeo.
+    int columnaTerminal(std::string_view clave) const {
+        const uint32_t *ini = termNombre, *fin = termNombre + nTerminales;
+        const uint32_t *it = std::lower_bound(ini, fin, clave,
+            [this](uint32_t off, std::string_view k){ return std::string_view(cadenas + off) < k; });
+        if (it == fin || std::string_view(cadenas + *it) != clave) return -1;
+        return termCol[it - ini];
+    }
+
+    LRGram() = default;
+    LRGram(const LRGram&) = delete;
+    LRGram& operator=(const LRGram&) = delete;
+    ~LRGram() { liberarMapa(); }
+
+    // Almacenamiento de la ruta de texto (vacío si la tabla está proyectada)
+    std::vector<int32_t> almIdRegla, almLonRegla, almTermCol;
+    std::vector<uint32_t> almCompacta;
+    std::vector<uint32_t> almNomRegla, almTermNombre;
+    std::string almCadenas;
+
+    // Proyección del .lrb
+    const void *mapa = nullptr;
+    size_t tamMapa = 0;
+    std::vector<char> almArchivo; // sólo donde no hay mmap
+
+    void enlazarAlmacen() {
+        idRegla = almIdRegla.data();
+        lonRegla = almLonRegla.data();
+        nomRegla = almNomRegla.data();
+        enlazarCompacta((const CabeceraCompacta*)almCompacta.data());
+        termNombre = almTermNombre.data();
+        termCol = almTermCol.data();
+        cadenas = almCadenas.data();
+        nTerminales = (int)almTermCol.size();
+    }
+
+    void enlazarCompacta(const CabeceraCompacta *h) {
+        compacta = h;
+        if(!h) return;
+        nColsTerm = h->nColsTerm;
+        filas = (const FilaCompacta*)(h + 1);
+        gotoDefecto = (const int16_t*)(filas + h->nFilas);
+        celdas = (const Celda*)(gotoDefecto + (((size_t)(h->nCols - h->nColsTerm) + 1) & ~(size_t)1));
+    }
+    size_t bytesTabla() const { return compacta ? bytesCompacta(compacta->nFilas, compacta->nCols, compacta->nColsTerm, compacta->nCeldas) : 0; }
+
+    void liberarMapa() {
+#ifdef LRB_MMAP
+        if (mapa) munmap(const_cast<void*>(mapa), tamMapa);
+#endif
+        mapa = nullptr;
+        tamMapa = 0;
+        almArchivo.clear();
+    }
+};
+
+// Lee el formato .lr de cualquier flujo (archivo o tabla generada en memoria).
+// Con 'densaSalida' también devuelve la tabla tal como está en el archivo.
+inline bool cargarLR(std::istream &f, LRGram &G, std::vector<int32_t> *densaSalida = nullptr){
+    if(!(f >> G.nReglas)){ std::cerr<<"Error de formato .lr: nReglas\n"; return false; }
+    G.almIdRegla.resize(G.nReglas);
+    G.almLonRegla.resize(G.nReglas);
+    G.almNomRegla.resize(G.nReglas);
+    for(int i=0;i<G.nReglas;i++){
+        int id, lon; std::string nombre;
+        f >> id >> lon >> nombre;
+        G.almIdRegla[i] = id;
+        G.almLonRegla[i] = lon;
+        G.almNomRegla[i] = (uint32_t)G.almCadenas.size();
+        G.almCadenas += nombre;
+        G.almCadenas += '\0';
+    }
+    if(!(f >> G.nFilas >> G.nCols)){ std::cerr<<"Error de formato .lr: dimensiones de tabla\n"; return false; }
+    std::vector<int32_t> densa((size_t)G.nFilas * G.nCols, 0);
+    for(size_t k=0;k<densa.size();k++)
+        f >> densa[k];
+    int nColsTerm = G.nCols;
+    for(int r=0;r<G.nReglas;r++) nColsTerm = std::min(nColsTerm, (int)G.almIdRegla[r]);
+    if(!compactarTabla(densa, G.nFilas, G.nCols, nColsTerm, G.almIdRegla, G.almLonRegla, G.almCompacta)) return false;
+    G.enlazarAlmacen();
+    if(densaSalida) densaSalida->swap(densa);
+    return true;
+}
+
+inline bool cargarLR(const std::string &path, LRGram &G, std::vector<int32_t> *densaSalida = nullptr){
+    std::ifstream f(path);
+    if(!f) { std::cerr<<"Error: No se puede abrir el archivo LR: "<<path<<"\n"; return false; }
+    return cargarLR(f, G, densaSalida);
+}
+
+// Lee el mapeo terminal -> columna del .inf dentro de G.
+inline bool leerInf(const std::string &path, LRGram &G){
+    std::ifstream f(path);
+    if(!f) { std::cerr<<"Error: No se puede abrir el archivo INF: "<<path<<"\n"; return false; }
+    std::map<std::string,int> mapa;
+    std::string key; int val;
+    while(f >> key >> val){
+        mapa[key] = val;
+    }
+    G.almTermNombre.clear();
+    G.almTermCol.clear();
+    for(const auto &kv : mapa){ // std::map ya entrega las claves ordenadas
+        G.almTermNombre.push_back((uint32_t)G.almCadenas.size());
+        G.almTermCol.push_back(kv.second);
+        G.almCadenas += kv.first;
+        G.almCadenas += '\0';
+    }
+    G.enlazarAlmacen();
+    return !mapa.empty();
+}
+
+// Reporte de carga: tamaño de la tabla compacta frente a la densa y costo
+// medido de una consulta en cada representación.
+inline void reporteTabla(const LRGram &G, std::ostream &os){
+    size_t densa = (size_t)G.nFilas * G.nCols * sizeof(int);
+    size_t densaVec = densa + (size_t)(G.nFilas + 1) * sizeof(std::vector<int>);
+    size_t comp = G.bytesTabla();
+    uint32_t usadas = 0;
+    for(uint32_t k=0;k<G.compacta->nCeldas;k++) usadas += G.celdas[k].chequeo != CELDA_LIBRE;
+    int conDefecto = 0;
+    for(int e=0;e<G.nFilas;e++) conDefecto += G.filas[e].defecto != 0;
+
+    // Consultas sobre celdas no vacías, en orden pseudoaleatorio fijo.
+    std::vector<std::vector<int>> tabla(G.nFilas, std::vector<int>(G.nCols));
+    std::vector<std::pair<int,int>> pares;
+    for(int e=0;e<G.nFilas;e++)
+        for(int c=0;c<G.nCols;c++)
+            if((tabla[e][c] = G.accion(e, c)) != 0) pares.push_back({e, c});
+    uint32_t x = 12345;
+    for(size_t i=pares.size(); i>1; i--){ x = x*1103515245u + 12345u; std::swap(pares[i-1], pares[(x>>8) % i]); }
+    const size_t N = 2000000;
+    auto medir = [&](auto consulta){
+        long suma = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for(size_t i=0, j=0;i<N;i++){ suma += consulta(pares[j].first, pares[j].second); if(++j == pares.size()) j = 0; }
+        auto t1 = std::chrono::steady_clock::now();
+        volatile long sumidero = suma; (void)sumidero;
+        return std::chrono::duration<double, std::nano>(t1 - t0).count() / N;
+    };
+    double nsDensa = pares.empty() ? 0 : medir([&](int e, int c){ return tabla[e][c]; });
+    double nsComp = pares.empty() ? 0 : medir([&](int e, int c){ return G.accion(e, c); });
+
+    os << "Tabla LR: " << G.nFilas << " estados x " << G.nCols << " columnas (" << G.nColsTerm << " terminales)\n";
+    os << "  densa:    " << densa << " bytes (" << densaVec << " como vector<vector<int>>)\n";
+    os << "  compacta: " << comp << " bytes, " << usadas << "/" << G.compacta->nCeldas << " celdas ocupadas, "
+       << conDefecto << " estados con reducción por defecto\n";
+    os << "  compresión: " << (comp ? (double)densaVec / comp : 0) << "x"
+       << (comp <= 32*1024 ? " (cabe en L1 de 32 KiB)" : comp <= 1024*1024 ? " (cabe en L2 de 1 MiB)" : "") << "\n";
+    os << "  consulta: densa " << nsDensa << " ns, compacta " << nsComp << " ns"
+       << " (1 acceso con reducción por defecto, 2 en el resto)\n";
+}
+
+/* ------------------ Formato binario .lrb ------------------ */
+// Archivo = CabeceraLRB + secciones alineadas a 4 bytes. Todos los
+// desplazamientos son relativos al inicio del archivo; los enteros se
+// guardan en el orden de bytes de la máquina que lo generó (la magia y
+// 'orden' detectan un archivo de otra arquitectura).
+const char LRB_MAGIA[8] = {'L','R','B','I','N','\r','\n','\x1a'};
+const uint32_t LRB_VERSION = 4; // 2: tabla compacta en lugar de densa; 3: gotos vacíos consultables explícitos;
+                                // 4: sólo reducciones por defecto que no cambian lo aceptado
+const uint32_t LRB_ORDEN = 0x01020304;
+
+struct CabeceraLRB {
+    char magia[8];
+    uint32_t version;
+    uint32_t orden;
+    uint32_t tamTotal;
+    uint32_t checksum;      // FNV-1a de los bytes que siguen a la cabecera
+    uint32_t nReglas, nFilas, nCols, nTerminales;
+    uint32_t offIdRegla, offLonRegla, offNomRegla, offTabla, tamTabla;
+    uint32_t offTermNombre, offTermCol, offCadenas, tamCadenas;
+};
+
+inline uint32_t fnv1a(const unsigned char *p, size_t n){
+    uint32_t h = 2166136261u;
+    for(size_t i=0;i<n;i++){ h ^= p[i]; h *= 16777619u; }
+    return h;
+}
+
+inline bool escribirLRB(const LRGram &G, const std::string &path){
+    std::vector<char> buf(sizeof(CabeceraLRB), 0);
+    auto seccion = [&buf](const void *datos, size_t bytes) -> uint32_t {
+        while(buf.size() % 4) buf.push_back(0);
+        uint32_t off = (uint32_t)buf.size();
+        buf.insert(buf.end(), (const char*)datos, (const char*)datos + bytes);
+        return off;
+    };
+    CabeceraLRB h{};
+    std::memcpy(h.magia, LRB_MAGIA, sizeof h.magia);
+    h.version = LRB_VERSION;
+    h.orden = LRB_ORDEN;
+    h.nReglas = G.nReglas;
+    h.nFilas = G.nFilas;
+    h.nCols = G.nCols;
+    h.nTerminales = G.nTerminales;
+    h.offIdRegla = seccion(G.idRegla, G.nReglas * sizeof(int32_t));
+    h.offLonRegla = seccion(G.lonRegla, G.nReglas * sizeof(int32_t));
+    h.offNomRegla = seccion(G.nomRegla, G.nReglas * sizeof(uint32_t));
+    h.tamTabla = (uint32_t)G.bytesTabla();
+    h.offTabla = seccion(G.compacta, h.tamTabla);
+    h.offTermNombre = seccion(G.termNombre, G.nTerminales * sizeof(uint32_t));
+    h.offTermCol = seccion(G.termCol, G.nTerminales * sizeof(int32_t));
+    // El pool de nombres es el último bloque; basta con su tamaño.
+    size_t tamCadenas = 0;
+    for(int r=0;r<G.nReglas;r++) tamCadenas = std::max(tamCadenas, G.nomRegla[r] + std::strlen(G.nombreRegla(r)) + 1);
+    for(int t=0;t<G.nTerminales;t++) tamCadenas = std::max(tamCadenas, G.termNombre[t] + std::strlen(G.cadenas + G.termNombre[t]) + 1);
+    h.offCadenas = seccion(G.cadenas, tamCadenas);
+    h.tamCadenas = (uint32_t)tamCadenas;
+    while(buf.size() % 4) buf.push_back(0);
+    h.tamTotal = (uint32_t)buf.size();
+    h.checksum = fnv1a((const unsigned char*)buf.data() + sizeof h, buf.size() - sizeof h);
+    std::memcpy(buf.data(), &h, sizeof h);
+
+    std::ofstream f(path, std::ios::binary);
+    if(!f){ std::cerr<<"Error: No se puede crear el archivo LRB: "<<path<<"\n"; return false; }
+    f.write(buf.data(), buf.size());
+    return (bool)f;
+}
+
+// Valida la cabecera y el contenido de una imagen .lrb y enlaza G a ella.
+inline bool enlazarLRB(const char *base, size_t tam, LRGram &G, const std::string &path){
+    auto falla = [&path](const char *motivo){
+        std::cerr<<"Error de formato .lrb ("<<path<<"): "<<motivo<<"\n";
+        return false;
+    };
+    if(tam < sizeof(CabeceraLRB)) return falla("archivo truncado");
+    CabeceraLRB h;
+    std::memcpy(&h, base, sizeof h);
+    if(std::memcmp(h.magia, LRB_MAGIA, sizeof h.magia) != 0) return falla("firma inválida");
+    if(h.orden != LRB_ORDEN) return falla("orden de bytes distinto al de esta máquina");
+    if(h.version != LRB_VERSION) return falla("versión no soportada");
+    if(h.tamTotal != tam) return falla("tamaño incorrecto");
+    if(fnv1a((const unsigned char*)base + sizeof h, tam - sizeof h) != h.checksum) return falla("checksum incorrecto");
+    auto dentro = [tam](uint32_t off, uint64_t bytes){ return off % 4 == 0 && off >= sizeof(CabeceraLRB) && off + bytes <= tam; };
+    if(!dentro(h.offIdRegla, h.nReglas*4ull) || !dentro(h.offLonRegla, h.nReglas*4ull) ||
+       !dentro(h.offNomRegla, h.nReglas*4ull) || !dentro(h.offTabla, h.tamTabla) || h.tamTabla < sizeof(CabeceraCompacta) ||
+       !dentro(h.offTermNombre, h.nTerminales*4ull) || !dentro(h.offTermCol, h.nTerminales*4ull) ||
+       !dentro(h.offCadenas, h.tamCadenas) || h.tamCadenas == 0 || base[h.offCadenas + h.tamCadenas - 1] != '\0')
+        return falla("sección fuera de rango");
+
+    G.liberarMapa();
+    G.nReglas = h.nReglas;
+    G.nFilas = h.nFilas;
+    G.nCols = h.nCols;
+    G.nTerminales = h.nTerminales;
+    G.idRegla = (const int32_t*)(base + h.offIdRegla);
+    G.lonRegla = (const int32_t*)(base + h.offLonRegla);
+    G.nomRegla = (const uint32_t*)(base + h.offNomRegla);
+    const CabeceraCompacta *tc = (const CabeceraCompacta*)(base + h.offTabla);
+    if(tc->nFilas != h.nFilas || tc->nCols != h.nCols || tc->nColsTerm > tc->nCols ||
+       bytesCompacta(tc->nFilas, tc->nCols, tc->nColsTerm, tc->nCeldas) != h.tamTabla)
+        return falla("tabla compacta inconsistente");
+    G.enlazarCompacta(tc);
+    G.termNombre = (const uint32_t*)(base + h.offTermNombre);
+    G.termCol = (const int32_t*)(base + h.offTermCol);
+    G.cadenas = base + h.offCadenas;
+
+    // Una tabla corrupta no debe poder sacar al parser de sus arreglos.
+    for(int r=0;r<G.nReglas;r++)
+        if(G.idRegla[r] < 0 || G.idRegla[r] >= G.nCols || G.lonRegla[r] < 0 || G.nomRegla[r] >= h.tamCadenas)
+            return falla("regla inválida");
+    auto accionValida = [&G](int a){ return a < G.nFilas && a >= -(G.nReglas+1); };
+    for(int e=0;e<G.nFilas;e++)
+        if(G.filas[e].base < 0 || (uint64_t)G.filas[e].base + G.nCols > tc->nCeldas || !accionValida(G.filas[e].defecto))
+            return falla("fila fuera de rango");
+    for(int nt=0;nt<G.nCols-G.nColsTerm;nt++)
+        if(G.gotoDefecto[nt] < 0 || G.gotoDefecto[nt] >= G.nFilas) return falla("goto fuera de rango");
+    for(uint32_t k=0;k<tc->nCeldas;k++){
+        const Celda &c = G.celdas[k];
+        if((c.chequeo != CELDA_LIBRE && c.chequeo >= G.nFilas) || !accionValida(c.valor)) return falla("acción fuera de rango");
+    }
+    for(int t=0;t<G.nTerminales;t++)
+        if(G.termNombre[t] >= h.tamCadenas || G.termCol[t] < 0 || G.termCol[t] >= G.nCols)
+            return falla("terminal inválido");
+    return true;
+}
+
+inline bool cargarLRB(const std::string &path, LRGram &G){
+#ifdef LRB_MMAP
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0){ std::cerr<<"Error: No se puede abrir el archivo LRB: "<<path<<"\n"; return false; }
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size <= 0){ close(fd); std::cerr<<"Error: archivo LRB vacío: "<<path<<"\n"; return false; }
+    size_t tam = (size_t)st.st_size;
+    void *p = mmap(nullptr, tam, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(p == MAP_FAILED){ std::cerr<<"Error: mmap falló para "<<path<<"\n"; return false; }
+    if(!enlazarLRB((const char*)p, tam, G, path)){ munmap(p, tam); return false; }
+    G.mapa = p;
+    G.tamMapa = tam;
+    return true;
+#else
+    std::ifstream f(path, std::ios::binary);
+    if(!f){ std::cerr<<"Error: No se puede abrir el archivo LRB: "<<path<<"\n"; return false; }
+    std::vector<char> datos((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    if(!enlazarLRB(datos.data(), datos.size(), G, path)) return false;
+    G.almArchivo.swap(datos); // el buffer del vector no cambia de dirección
+    return true;
+#endif
+}
+
+#endif
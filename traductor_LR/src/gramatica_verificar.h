@@ -0,0 +1,92 @@
+// gramatica_verificar.h
+// Prueba diferencial de la tabla compacta (benchmark --verificar-tabla):
+// accion() frente a la tabla densa del .lr, celda por celda. Sólo puede
+// diferir en errores de estados con reducción por defecto y en gotos vacíos
+// que devuelven el goto por defecto. Además la tabla densa y la compacta
+// (reconocerLR y parseLR) deben aceptar lo mismo: else colgantes con uno de
+// más y mutaciones de programas aleatorios.
+#ifndef GRAMATICA_VERIFICAR_H
+#define GRAMATICA_VERIFICAR_H
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "gramatica.h"
+#include "lexer_rapido.h"
+#include "parser.h"
+#include "verificacion.h"
+
+// Reconocedor sobre la tabla densa, sin defectos: la referencia.
+inline bool reconocerDensa(const LRGram &G, const std::vector<int32_t> &densa, std::string_view entrada){
+    LexerRapido lx(entrada);
+    std::vector<int> estados{0};
+    Token tk = lx.next();
+    while(true){
+        int col = G.colToken[(int)tk.type];
+        if(col < 0) return false;
+        int a = densa[(size_t)estados.back()*G.nCols + col];
+        if(a > 0){ estados.push_back(a); tk = lx.next(); }
+        else if(a == -1) return true;
+        else if(a < 0){
+            int r = -a - 2;
+            estados.resize(estados.size() - G.lonRegla[r]);
+            estados.push_back(densa[(size_t)estados.back()*G.nCols + G.idRegla[r]]);
+            if(estados.back() <= 0) return false;
+        } else return false;
+    }
+}
+
+inline int verificarTabla(ContextoVerificacion &c){
+    const LRGram &G = c.G;
+    const std::vector<int32_t> &densa = c.densa;
+    PruebaDiferencial prueba;
+    int porDefecto = 0, gotoDefecto = 0;
+    for(int e=0;e<G.nFilas;e++)
+        for(int col=0;col<G.nCols;col++){
+            int a = G.accion(e, col), d = densa[(size_t)e*G.nCols + col];
+            if(a == d) continue;
+            if(col < G.nColsTerm && d == 0 && a == G.reduccionPorDefecto(e)) porDefecto++;
+            else if(col >= G.nColsTerm && d == 0 && a == G.gotoDefecto[col - G.nColsTerm]) gotoDefecto++;
+            else prueba.fallo([&]{ std::fprintf(stderr, "FALLO celda (%d, %d): densa %d, compacta %d\n", e, col, d, a); });
+        }
+
+    auto caso = [&](const std::string &s){
+        Arbol arbol;
+        bool d = reconocerDensa(G, densa, s), r = reconocerLR(G, s).aceptada, p = parseLR(G, s, arbol).aceptada;
+        prueba.aceptados += d;
+        prueba.comprobar(d == r && d == p, [&]{
+            std::fprintf(stderr, "FALLO densa %d, reconocerLR %d, parseLR %d:\n<<%s>>\n", d, r, p, s.c_str());
+        });
+    };
+    caso("int main(){ if(1) if(2){ } else { } else x = 1; }");
+    // if anidados con 0..n+1 else: el último de más debe rechazarse.
+    for(int n=1;n<=4;n++)
+        for(int k=0;k<=n+1;k++){
+            std::string s = "int main(){ ";
+            for(int i=0;i<n;i++) s += "if(" + std::to_string(i) + ") ";
+            s += "{ }";
+            for(int i=0;i<k;i++) s += i % 2 ? " else x = 1;" : " else { }";
+            caso(s + " }");
+        }
+    // Mutaciones con varios else, bloques y sentencias insertados.
+    const char *trozos[] = {"else ", "else { } ", "else x = 1; ", "if (a) ", "{ ", "} ", ";", "x", "(", ")", "+", "return "};
+    Azar azar(7654321u);
+    for(int k=0;k<3000;k++){
+        std::string s = programaAleatorio(azar, 1 + azar() % 4);
+        caso(s);
+        for(int m=0;m<4;m++){
+            std::string u = s;
+            for(int j=azar()%3; j>=0; j--){
+                size_t p = azar() % (u.size() + 1);
+                u.insert(p, trozos[azar() % (sizeof trozos / sizeof *trozos)]);
+            }
+            caso(u);
+        }
+    }
+    std::printf("Tabla compacta frente a la densa: %d celdas distintas por reducción por defecto, %d por goto por defecto; "
+                "%d casos (%d aceptados), %d fallos\n", porDefecto, gotoDefecto, prueba.casos, prueba.aceptados, prueba.fallos);
+    return prueba.codigo();
+}
+
+#endif
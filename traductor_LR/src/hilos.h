@@ -0,0 +1,128 @@
+// hilos.h
+// Pool de hilos fijo con robo de trabajo. paraCada(n, f) reparte los índices
+// [0, n) en un rango contiguo por hilo; cada hilo consume el suyo desde el
+// principio y, cuando se le acaba, roba la mitad final del rango de otro
+// hilo. Así los archivos grandes o lentos no dejan hilos ociosos y el orden
+// de los resultados lo decide el índice, no el hilo que lo procesó.
+// Compilar con -pthread.
+#ifndef HILOS_H
+#define HILOS_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class PoolTrabajo {
+public:
+    explicit PoolTrabajo(unsigned n = 0) {
+        if (n == 0) n = std::max(1u, std::thread::hardware_concurrency());
+        colas = std::vector<Rango>(n);
+        for (unsigned h = 0; h < n; h++) hilos.emplace_back([this, h] { ciclo(h); });
+    }
+    ~PoolTrabajo() {
+        {
+            std::lock_guard<std::mutex> g(mtx);
+            terminar = true;
+        }
+        hayTrabajo.notify_all();
+        for (auto &t : hilos) t.join();
+    }
+    PoolTrabajo(const PoolTrabajo&) = delete;
+    PoolTrabajo& operator=(const PoolTrabajo&) = delete;
+
+    unsigned size() const { return (unsigned)hilos.size(); }
+
+    // Ejecuta f(i, hilo) para cada i en [0, n) y espera a que terminen todas.
+    // 'hilo' está en [0, size()) y sirve para indexar estado por hilo.
+    // No es reentrante: una sola llamada a la vez.
+    void paraCada(size_t n, std::function<void(size_t, unsigned)> f) {
+        if (n == 0) return;
+        unsigned H = size();
+        std::unique_lock<std::mutex> g(mtx);
+        terminado.wait(g, [this] { return activos == 0; }); // nadie sigue en la ronda anterior
+        for (unsigned h = 0; h < H; h++) {
+            std::lock_guard<std::mutex> gc(colas[h].mtx);
+            colas[h].ini = n * h / H;
+            colas[h].fin = n * (h + 1) / H;
+        }
+        tarea = std::move(f);
+        pendientes = n;
+        generacion++;
+        g.unlock();
+        hayTrabajo.notify_all();
+        g.lock();
+        terminado.wait(g, [this] { return pendientes == 0 && activos == 0; });
+        tarea = nullptr;
+    }
+
+private:
+    struct Rango {
+        std::mutex mtx;
+        size_t ini = 0, fin = 0;
+    };
+
+    std::vector<std::thread> hilos;
+    std::vector<Rango> colas;
+    std::mutex mtx;
+    std::condition_variable hayTrabajo, terminado;
+    std::function<void(size_t, unsigned)> tarea;
+    size_t pendientes = 0;
+    unsigned activos = 0; // hilos dentro de una ronda
+    unsigned generacion = 0;
+    bool terminar = false;
+
+    bool tomarPropio(unsigned h, size_t &i) {
+        std::lock_guard<std::mutex> g(colas[h].mtx);
+        if (colas[h].ini >= colas[h].fin) return false;
+        i = colas[h].ini++;
+        return true;
+    }
+
+    // Roba la mitad final del rango de otro hilo y la deja como rango propio.
+    bool robar(unsigned h) {
+        unsigned H = size();
+        for (unsigned k = 1; k < H; k++) {
+            Rango &v = colas[(h + k) % H];
+            size_t ini, fin;
+            {
+                std::lock_guard<std::mutex> g(v.mtx);
+                if (v.ini >= v.fin) continue;
+                size_t quedan = v.fin - v.ini;
+                fin = v.fin;
+                ini = v.fin - (quedan + 1) / 2;
+                v.fin = ini;
+            }
+            std::lock_guard<std::mutex> g(colas[h].mtx);
+            colas[h].ini = ini;
+            colas[h].fin = fin;
+            return true;
+        }
+        return false;
+    }
+
+    void ciclo(unsigned h) {
+        unsigned vista = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> g(mtx);
+                hayTrabajo.wait(g, [&] { return terminar || generacion != vista; });
+                if (terminar) return;
+                vista = generacion;
+                activos++;
+            }
+            size_t hechos = 0, i;
+            while (tomarPropio(h, i) || (robar(h) && tomarPropio(h, i))) {
+                tarea(i, h);
+                hechos++;
+            }
+            std::lock_guard<std::mutex> g(mtx);
+            pendientes -= hechos;
+            if (--activos == 0) terminado.notify_all();
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,505 @@
+// incremental.h
+// Reanálisis incremental: a partir del árbol anterior y una lista de
+// ediciones de texto se vuelve a lexar sólo la zona dañada y se reutilizan
+// los subárboles que no cambiaron.
+//
+// Cada nodo guarda además (InfoNodo) el estado LR en que empezó, cuántos
+// tokens y bytes abarca y el tipo de su primer token. Al reanalizar:
+//   1. se lexa desde el token cuya decisión pudo depender del texto
+//      editado (el lexer mira hasta dos bytes después de un token) hasta
+//      que un token nuevo empieza, después de la edición, justo donde
+//      empezaba uno viejo con el mismo espacio previo: desde ahí el resto
+//      de los tokens es idéntico al anterior;
+//   2. el ciclo LR recibe como entrada los subárboles viejos anteriores a
+//      la zona, los tokens nuevos y los subárboles viejos posteriores. Un
+//      subárbol se desplaza entero (goto con su no-terminal) si el estado
+//      actual es el mismo en que empezó y el token que lo sigue es del
+//      mismo tipo: las reducciones dentro de él sólo dependen de eso. Si
+//      no, se desarma en sus hijos;
+//   3. los nodos nuevos se agregan a la misma arena; los que quedan sin
+//      referencia se recuperan compactando cuando son más que los vivos.
+// El árbol resultante es igual (forma, reglas, tokens y lexemas) al de un
+// análisis nuevo del texto editado. Si hay un error se devuelve el mismo
+// diagnóstico que reconocerLR y el siguiente análisis es completo.
+//
+// La cadena Definiciones -> Definicion Definiciones es recursiva por la
+// derecha y tan profunda como definiciones haya. Para que el costo no
+// dependa de eso se lleva un índice de las definiciones de primer nivel
+// (búsquedas binarias en vez de bajar por la cadena): las definiciones
+// anteriores a la edición quedan representadas por una sola entrada de la
+// pila, y cuando la reducción de la cadena llega a ella el resultado se
+// empalma en el nodo de la cadena vieja. Por eso los nodos de esa cadena y
+// la raíz sólo mantienen estado, primerTipo y espacio; sus tamaños están en
+// el índice. Lo único lineal en la cantidad de definiciones es copiar el
+// índice (arreglos contiguos) y mover el texto.
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "arbol.h"
+#include "gramatica.h"
+#include "lexer.h"
+#include "lexer_rapido.h"
+#include "parser.h"
+
+struct Edicion {
+    size_t pos;            // en el texto anterior a todas las ediciones
+    size_t borrados;
+    std::string insertado;
+};
+
+struct InfoNodo {
+    int16_t estado;      // estado LR antes de desplazar su primer token
+    uint8_t primerTipo;  // TokenType de su primer token
+    uint8_t libre;
+    uint32_t nTokens;
+    uint32_t nBytes;     // incluye el espacio previo a cada token
+    uint32_t espacio;    // espacio previo a su primer token
+    uint32_t nNodos;     // tamaño del subárbol
+};
+
+class ParserIncremental {
+public:
+    struct Estadisticas {
+        size_t tokensRelexados = 0, nodosReusados = 0, nodosNuevos = 0;
+        bool completo = false; // sin árbol anterior válido
+    };
+
+    // Análisis completo de 'texto'.
+    Diagnostico analizar(const LRGram &G, std::string texto){
+        txt = std::move(texto);
+        valido = false;
+        return reanalizar(G, 0, 0, 0);
+    }
+
+    // Aplica las ediciones (posiciones del texto anterior, sin solaparse) y
+    // reanaliza.
+    Diagnostico editar(const LRGram &G, std::vector<Edicion> ediciones){
+        std::sort(ediciones.begin(), ediciones.end(), [](const Edicion &x, const Edicion &y){ return x.pos < y.pos; });
+        size_t a = ediciones.empty() ? 0 : ediciones.front().pos, b = a, previo = 0;
+        for(const Edicion &e : ediciones){
+            if(e.pos < previo || e.pos + e.borrados > txt.size()){
+                Diagnostico d;
+                d.mensaje = "Error: edición fuera de rango o solapada en la posición " + std::to_string(e.pos);
+                return d;
+            }
+            previo = b = e.pos + e.borrados;
+        }
+        size_t antes = txt.size();
+        if(ediciones.size() == 1){
+            txt.replace(a, ediciones[0].borrados, ediciones[0].insertado);
+        } else if(!ediciones.empty()){
+            std::string nuevo;
+            nuevo.reserve(txt.size());
+            previo = 0;
+            for(const Edicion &e : ediciones){
+                nuevo.append(txt, previo, e.pos - previo);
+                nuevo += e.insertado;
+                previo = e.pos + e.borrados;
+            }
+            nuevo.append(txt, previo, std::string::npos);
+            txt.swap(nuevo);
+        }
+        return reanalizar(G, a, b, (long long)txt.size() - (long long)antes);
+    }
+
+    const Arbol& arbol() const { return A; }
+    const std::string& texto() const { return txt; }
+    const Estadisticas& ultima() const { return est; }
+
+private:
+    // indice: posición entre los hijos del padre; cad: j si el nodo es
+    // cadena[j], NINGUNO si no es de la cadena de primer nivel.
+    struct Marco { uint32_t nodo, indice, cad; size_t primero; };
+
+    std::string txt;
+    Arbol A;
+    std::vector<InfoNodo> infos; // paralelo a A.nodos
+    bool valido = false;
+    Estadisticas est;
+    std::vector<Marco> cursor;
+
+    // Índice de las definiciones de primer nivel: defs[j] es la raíz de la
+    // j-ésima Definicion y cadena[j] el nodo Definiciones que empieza en ella
+    // (cadena[nDefs] es el vacío); bytesAntes, tokensAntes y nodosAntes[j]
+    // suman las definiciones anteriores (el último elemento es el total).
+    std::vector<uint32_t> defs, cadena, bytesAntes, tokensAntes, nodosAntes;
+
+    size_t defConToken(size_t idx) const {
+        return std::upper_bound(tokensAntes.begin(), tokensAntes.end(), (uint32_t)idx) - tokensAntes.begin() - 1;
+    }
+    size_t vivos() const { return nodosAntes.back() + defs.size() + 2; } // + cadena, vacío y raíz
+
+    /* ---------- Índice ---------- */
+    void agregarDef(uint32_t d){
+        defs.push_back(d);
+        bytesAntes.push_back(bytesAntes.back() + infos[d].nBytes);
+        tokensAntes.push_back(tokensAntes.back() + infos[d].nTokens);
+        nodosAntes.push_back(nodosAntes.back() + infos[d].nNodos);
+    }
+
+    // Recorre la cadena completa y deja exactos los tamaños de sus nodos.
+    bool indexar(){
+        defs.clear(); cadena.clear();
+        bytesAntes.assign(1, 0); tokensAntes.assign(1, 0); nodosAntes.assign(1, 0);
+        if(A.raiz == Arbol::NINGUNO || A[A.raiz].nHijos != 1) return false;
+        uint32_t D = A.hijo(A[A.raiz], 0);
+        while(A[D].nHijos == 2){
+            cadena.push_back(D);
+            agregarDef(A.hijo(A[D], 0));
+            D = A.hijo(A[D], 1);
+        }
+        cadena.push_back(D);
+        if(A[D].nHijos != 0) return false;
+        for(size_t j=defs.size(); j-- > 0;){
+            InfoNodo &c = infos[cadena[j]];
+            const InfoNodo &d = infos[defs[j]], &r = infos[cadena[j+1]];
+            c.nTokens = d.nTokens + r.nTokens;
+            c.nBytes = d.nBytes + r.nBytes;
+            c.nNodos = 1 + d.nNodos + r.nNodos;
+        }
+        InfoNodo &r = infos[A.raiz];
+        const InfoNodo &c = infos[cadena[0]];
+        r.nTokens = c.nTokens; r.nBytes = c.nBytes; r.nNodos = 1 + c.nNodos;
+        return true;
+    }
+
+    // Tras un reanálisis que dejó las primeras dPre definiciones en su lugar
+    // y empalmó 'cola': se leen sólo los nodos nuevos de la cadena; las
+    // definiciones desde tReuso siguen colgando de su nodo viejo.
+    bool reindexar(size_t dPre, uint32_t cola, uint32_t primerNuevo, size_t tReuso){
+        size_t nDefs = defs.size();
+        std::vector<uint32_t> medio, medioCadena;
+        uint32_t D = cola;
+        while(D >= primerNuevo && A[D].nHijos == 2){
+            medioCadena.push_back(D);
+            medio.push_back(A.hijo(A[D], 0));
+            D = A.hijo(A[D], 1);
+        }
+        size_t t = nDefs;
+        if(A[D].nHijos == 2){
+            if(tReuso >= nDefs || cadena[tReuso] != D) return indexar();
+            t = tReuso;
+        } else if(A[D].nHijos != 0) {
+            return indexar();
+        }
+        std::vector<uint32_t> viejosDefs, viejaCadena, b, k, n;
+        viejosDefs.swap(defs); viejaCadena.swap(cadena);
+        b.swap(bytesAntes); k.swap(tokensAntes); n.swap(nodosAntes);
+        defs.assign(viejosDefs.begin(), viejosDefs.begin() + dPre);
+        bytesAntes.assign(b.begin(), b.begin() + dPre + 1);
+        tokensAntes.assign(k.begin(), k.begin() + dPre + 1);
+        nodosAntes.assign(n.begin(), n.begin() + dPre + 1);
+        for(uint32_t d : medio) agregarDef(d);
+        uint32_t dB = bytesAntes.back() - b[t], dK = tokensAntes.back() - k[t], dN = nodosAntes.back() - n[t];
+        for(size_t u=t;u<nDefs;u++){
+            defs.push_back(viejosDefs[u]);
+            bytesAntes.push_back(b[u+1] + dB);
+            tokensAntes.push_back(k[u+1] + dK);
+            nodosAntes.push_back(n[u+1] + dN);
+        }
+        cadena.assign(viejaCadena.begin(), viejaCadena.begin() + dPre);
+        cadena.insert(cadena.end(), medioCadena.begin(), medioCadena.end());
+        if(t < nDefs) cadena.insert(cadena.end(), viejaCadena.begin() + t, viejaCadena.end());
+        else cadena.push_back(D);
+        return true;
+    }
+
+    /* ---------- Consultas sobre el árbol anterior ---------- */
+    // Hoja que contiene el byte x (contando su espacio previo): su índice de
+    // token y el byte donde empieza su espacio previo.
+    uint32_t hojaEnByte(size_t x, size_t &token, size_t &inicio) const {
+        size_t j = std::upper_bound(bytesAntes.begin(), bytesAntes.end(), (uint32_t)x) - bytesAntes.begin() - 1;
+        if(j >= defs.size()) return Arbol::NINGUNO;
+        uint32_t n = defs[j];
+        token = tokensAntes[j]; inicio = bytesAntes[j];
+        while(!A[n].esHoja()){
+            const NodoAst &p = A[n];
+            uint32_t sig = Arbol::NINGUNO;
+            for(uint32_t k=0;k<p.nHijos;k++){
+                uint32_t h = A.hijo(p, k);
+                if(x < inicio + infos[h].nBytes && infos[h].nTokens){ sig = h; break; }
+                inicio += infos[h].nBytes;
+                token += infos[h].nTokens;
+            }
+            if(sig == Arbol::NINGUNO) return Arbol::NINGUNO;
+            n = sig;
+        }
+        return n;
+    }
+
+    TokenType tipoToken(size_t idx) const {
+        if(idx >= tokensAntes.back()) return TokenType::FIN;
+        size_t j = defConToken(idx);
+        uint32_t n = defs[j];
+        idx -= tokensAntes[j];
+        while(!A[n].esHoja()){
+            const NodoAst &p = A[n];
+            for(uint32_t k=0;k<p.nHijos;k++){
+                uint32_t h = A.hijo(p, k);
+                if(idx < infos[h].nTokens){ n = h; break; }
+                idx -= infos[h].nTokens;
+            }
+        }
+        return A[n].tipoToken();
+    }
+
+    /* ---------- Cursor sobre el árbol anterior ---------- */
+    // Los ancestros de cadena[j] no tienen nada después de ella, así que el
+    // cursor puede empezar ahí sin apilarlos.
+    void avanzar(){
+        while(!cursor.empty()){
+            Marco m = cursor.back();
+            cursor.pop_back();
+            if(cursor.empty()) return;
+            const Marco &padre = cursor.back();
+            const NodoAst &p = A[padre.nodo];
+            if(m.indice + 1 < p.nHijos){
+                uint32_t cad = Arbol::NINGUNO;
+                if(padre.cad != Arbol::NINGUNO && m.indice == 0) cad = padre.cad + 1;
+                cursor.push_back({A.hijo(p, m.indice + 1), m.indice + 1, cad, m.primero + infos[m.nodo].nTokens});
+                return;
+            }
+        }
+    }
+    void bajar(){
+        Marco m = cursor.back();
+        cursor.push_back({A.hijo(A[m.nodo], 0), 0, Arbol::NINGUNO, m.primero});
+    }
+    // Deja arriba el nodo más grande que empieza en el token j.
+    void posicionar(size_t j){
+        cursor.clear();
+        if(j >= tokensAntes.back()) return;
+        size_t d = defConToken(j);
+        cursor.push_back({cadena[d], 1, (uint32_t)d, tokensAntes[d]});
+        while(cursor.back().primero != j){
+            const Marco m = cursor.back();
+            const NodoAst &p = A[m.nodo];
+            size_t acc = m.primero;
+            for(uint32_t k=0;k<p.nHijos;k++){
+                uint32_t h = A.hijo(p, k);
+                if(infos[h].nTokens && j < acc + infos[h].nTokens){ cursor.push_back({h, k, Arbol::NINGUNO, acc}); break; }
+                acc += infos[h].nTokens;
+            }
+        }
+    }
+
+    /* ---------- Construcción ---------- */
+    uint32_t nuevaHoja(TokenType t, uint32_t lexema, int estado, uint32_t espacio, uint32_t nBytes){
+        uint32_t k = A.hoja(t, lexema);
+        infos.push_back(InfoNodo{(int16_t)estado, (uint8_t)t, 0, 1, nBytes, espacio, 1});
+        est.nodosNuevos++;
+        return k;
+    }
+    uint32_t nuevoInterno(int regla, const uint32_t *h, uint32_t n, int estadoActual, TokenType siguiente){
+        InfoNodo in{(int16_t)estadoActual, (uint8_t)siguiente, 0, 0, 0, 0, 1};
+        bool primero = true;
+        for(uint32_t k=0;k<n;k++){
+            const InfoNodo &c = infos[h[k]];
+            if(primero && c.nTokens){ in.estado = c.estado; in.primerTipo = c.primerTipo; in.espacio = c.espacio; primero = false; }
+            in.nTokens += c.nTokens;
+            in.nBytes += c.nBytes;
+            in.nNodos += c.nNodos;
+        }
+        uint32_t k = A.interno(regla, h, n);
+        infos.push_back(in);
+        est.nodosNuevos++;
+        return k;
+    }
+
+    Diagnostico fallar(const LRGram &G, bool reintentar){
+        valido = false;
+        A.limpiar();
+        infos.clear();
+        Diagnostico d = reconocerLR(G, txt);
+        if(d.aceptada && reintentar) return reanalizar(G, 0, 0, 0); // no debería pasar: análisis completo
+        return d;
+    }
+
+    /* ---------- Reanálisis ---------- */
+    Diagnostico reanalizar(const LRGram &G, size_t a, size_t b, long long delta){
+        est = Estadisticas();
+        bool hayViejo = valido;
+        est.completo = !hayViejo;
+        if(!hayViejo){ A.limpiar(); infos.clear(); }
+        uint32_t primerNuevo = (uint32_t)A.nodos.size();
+        size_t nDefs = hayViejo ? defs.size() : 0, totalViejo = hayViejo ? tokensAntes.back() : 0;
+
+        // 1. Tokens nuevos: desde el primer token afectado hasta sincronizar.
+        size_t i0 = 0, desde = 0, j0 = totalViejo;
+        if(hayViejo && hojaEnByte(a >= 2 ? a - 2 : 0, i0, desde) == Arbol::NINGUNO){ i0 = totalViejo; desde = bytesAntes.back(); }
+        std::vector<Token> medio;
+        std::vector<uint32_t> espacioMedio;
+        LexerRapido lx(txt, desde);
+        size_t finAnterior = desde;
+        while(true){
+            Token tk = lx.next();
+            if(tk.type == TokenType::FIN) break;
+            uint32_t esp = (uint32_t)(tk.pos - finAnterior);
+            if(hayViejo && (long long)tk.pos >= (long long)b + delta){
+                size_t pv = (size_t)((long long)tk.pos - delta), idx, ini;
+                uint32_t h = hojaEnByte(pv, idx, ini);
+                if(h != Arbol::NINGUNO && ini + infos[h].espacio == pv && infos[h].espacio == esp){ j0 = idx; break; }
+            }
+            medio.push_back(tk);
+            espacioMedio.push_back(esp);
+            finAnterior = tk.pos + tk.lexeme.size();
+        }
+        est.tokensRelexados = medio.size();
+        bool seguimientoIgual = false;
+        if(hayViejo) seguimientoIgual = (!medio.empty() ? medio[0].type : tipoToken(j0)) == tipoToken(i0);
+
+        // 2. Ciclo LR sobre subárboles viejos y tokens nuevos. Las primeras
+        // dPre definiciones son una sola entrada de la pila.
+        enum { PREFIJO, MEDIO, SUFIJO, FINAL } fase = PREFIJO;
+        cursor.clear();
+        std::vector<int> estados{0};
+        std::vector<uint32_t> pila;
+        size_t dPre = 0, tReuso = nDefs;
+        if(hayViejo){
+            dPre = i0 >= totalViejo ? nDefs : defConToken(i0);
+            if(dPre > 0 && tokensAntes[dPre] == i0 && !seguimientoIgual) dPre--;
+            if(dPre > 0){
+                int col = G.idRegla[A[defs[0]].regla() - 1], s = 0;
+                for(size_t j=0;j<dPre;j++){
+                    int g = G.accion(s, col);
+                    if(g <= 0) return fallar(G, true);
+                    if(g == s) break;
+                    s = g;
+                }
+                estados.push_back(s);
+                pila.push_back(uint32_t(Arbol::NINGUNO));
+            }
+            cursor.push_back({cadena[dPre], 1, (uint32_t)dPre, tokensAntes[dPre]});
+        }
+        uint32_t cola = Arbol::NINGUNO; // nueva cadena desde la definición dPre
+        size_t im = 0;
+        while(cola == Arbol::NINGUNO){
+            uint32_t X = Arbol::NINGUNO;
+            TokenType t = TokenType::FIN;
+            if(fase == PREFIJO || fase == SUFIJO){
+                if(cursor.empty() || (fase == PREFIJO && cursor.back().primero >= i0)){
+                    if(fase == PREFIJO) fase = MEDIO;
+                    else fase = FINAL;
+                    continue;
+                }
+                X = cursor.back().nodo;
+                if(infos[X].nTokens == 0){ avanzar(); continue; } // los vacíos los rehacen las reducciones
+                t = (TokenType)infos[X].primerTipo;
+            } else if(fase == MEDIO){
+                if(im == medio.size()){ fase = SUFIJO; if(hayViejo) posicionar(j0); continue; }
+                t = medio[im].type;
+            }
+
+            int col = G.colToken[(int)t];
+            if(col < 0) return fallar(G, hayViejo);
+            int estado = estados.back();
+            int accion = G.accion(estado, col);
+            if(accion > 0){ // Shift: subárbol completo, hoja vieja o token nuevo
+                if(X != Arbol::NINGUNO){
+                    const Marco &m = cursor.back();
+                    const NodoAst &n = A[X];
+                    size_t fin = m.cad != Arbol::NINGUNO ? totalViejo : m.primero + infos[X].nTokens;
+                    bool limite = fase == SUFIJO || fin < i0 || (fin == i0 && seguimientoIgual);
+                    if(!n.esHoja() && infos[X].estado == estado && limite){
+                        int g = G.accion(estado, G.idRegla[n.regla() - 1]);
+                        if(g <= 0) return fallar(G, hayViejo);
+                        if(m.cad != Arbol::NINGUNO) tReuso = m.cad;
+                        estados.push_back(g);
+                        pila.push_back(X);
+                        avanzar();
+                    } else if(n.esHoja()){
+                        estados.push_back(accion);
+                        pila.push_back(nuevaHoja(n.tipoToken(), n.lexema, estado, infos[X].espacio, infos[X].nBytes));
+                        avanzar();
+                    } else {
+                        bajar();
+                    }
+                } else if(fase == MEDIO){
+                    const Token &tk = medio[im];
+                    uint32_t lex = TablaLexemas::NINGUNO;
+                    if(tk.type==TokenType::IDENT || tk.type==TokenType::ENTERO || tk.type==TokenType::REAL || tk.type==TokenType::CADENA)
+                        lex = A.lexemas.intern(tk.lexeme);
+                    estados.push_back(accion);
+                    pila.push_back(nuevaHoja(tk.type, lex, estado, espacioMedio[im], espacioMedio[im] + (uint32_t)tk.lexeme.size()));
+                    im++;
+                } else {
+                    return fallar(G, hayViejo);
+                }
+            } else if(accion == -1){ // Aceptación
+                if(pila.size() != 1 || pila[0] == Arbol::NINGUNO || A[pila[0]].nHijos != 1) return fallar(G, hayViejo);
+                A.raiz = pila[0];
+                cola = A.hijo(A[A.raiz], 0);
+            } else if(accion < 0){ // Reduce
+                int regla = -accion - 1;
+                if(regla <= 0 || regla > G.nReglas) return fallar(G, hayViejo);
+                int lon = G.lonRegla[regla-1];
+                if(estados.size() <= (size_t)lon) return fallar(G, hayViejo);
+                size_t base = pila.size() - lon;
+                if(dPre > 0 && base == 0){ // llegó a las definiciones anteriores: empalmar
+                    if(lon != 2 || regla != A[cadena[0]].regla()) return fallar(G, hayViejo);
+                    cola = pila[1];
+                    A.hijos[A[cadena[dPre-1]].primerHijo + 1] = cola;
+                    break;
+                }
+                estados.resize(estados.size() - lon);
+                int g = G.accion(estados.back(), G.idRegla[regla-1]);
+                if(g == 0) return fallar(G, hayViejo);
+                uint32_t padre = nuevoInterno(regla, pila.data() + base, lon, estados.back(), t);
+                estados.push_back(g);
+                pila.resize(base);
+                pila.push_back(padre);
+            } else {
+                return fallar(G, hayViejo);
+            }
+        }
+        valido = hayViejo ? reindexar(dPre, cola, primerNuevo, tReuso) : indexar();
+        if(!valido) return fallar(G, true);
+        est.nodosReusados = vivos() - std::min(vivos(), est.nodosNuevos);
+        if(A.nodos.size() > 2 * vivos() + 4096){ compactar(); indexar(); }
+        Diagnostico d;
+        d.aceptada = true;
+        return d;
+    }
+
+    // Copia el árbol vivo en orden posfijo, que es el orden en que lo crea
+    // el análisis completo, y vuelve a internar los lexemas en orden de
+    // aparición.
+    void compactar(){
+        Arbol B;
+        std::vector<InfoNodo> infosB;
+        infosB.reserve(vivos());
+        B.nodos.reserve(vivos());
+        std::vector<std::pair<uint32_t, uint32_t>> pilaDfs{{A.raiz, 0}}; // nodo, siguiente hijo
+        std::vector<uint32_t> hechos;                                   // índices nuevos de los hijos ya copiados
+        while(!pilaDfs.empty()){
+            auto &[n, k] = pilaDfs.back();
+            const NodoAst &p = A[n];
+            if(k < p.nHijos){
+                uint32_t h = A.hijo(p, k++);
+                pilaDfs.push_back({h, 0});
+                continue;
+            }
+            uint32_t nuevo;
+            if(p.esHoja()){
+                uint32_t lex = p.lexema == TablaLexemas::NINGUNO ? TablaLexemas::NINGUNO : B.lexemas.intern(A.lexemas.texto(p.lexema));
+                nuevo = B.hoja(p.tipoToken(), lex);
+            } else {
+                nuevo = B.interno(p.regla(), hechos.data() + hechos.size() - p.nHijos, p.nHijos);
+                hechos.resize(hechos.size() - p.nHijos);
+            }
+            infosB.push_back(infos[n]);
+            hechos.push_back(nuevo);
+            pilaDfs.pop_back();
+        }
+        B.raiz = hechos.back();
+        A = std::move(B);
+        infos.swap(infosB);
+    }
+};
+
+#endif
@@ -0,0 +1,71 @@
+// incremental_verificar.h
+// Prueba diferencial del reanálisis incremental (benchmark
+// --verificar-incremental): ediciones aleatorias sobre un programa válido;
+// después de cada una el resultado debe ser igual al de parseLR sobre el
+// texto completo.
+#ifndef INCREMENTAL_VERIFICAR_H
+#define INCREMENTAL_VERIFICAR_H
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+#include "incremental.h"
+#include "parser.h"
+#include "verificacion.h"
+
+inline int verificarIncremental(ContextoVerificacion &c){
+    const LRGram &G = c.G;
+    const char *trozos[] = {"x", "1", "2.5", " ", "\n", ";", ",", "(", ")", "{", "}", "+", "*", "=", "==", "&&", "\"",
+        "int ", "float ", "if ", "else ", "return ", "while ", "int q;", "float g(int a) { return a; }", "r = r + 1;", "@"};
+    Azar azar(88172645u);
+    PruebaDiferencial prueba;
+    size_t completos = 0;
+    for(int ronda=0; ronda<40; ronda++){
+        ParserIncremental inc;
+        std::string ultimoValido = generarEntrada(500 + azar() % (ronda % 4 == 3 ? 60000 : 4000));
+        inc.analizar(G, ultimoValido);
+        for(int k=0;k<150;k++){
+            const std::string &t = inc.texto();
+            std::vector<Edicion> ed;
+            if(azar() % 4){
+                // Cambios que conservan un programa válido.
+                static const std::pair<const char*, const char*> cambios[] = {
+                    {"r = 0;", "r = 0; r = r + 1;"}, {"a + b", "a * b"}, {"2.5", "(2.5 + 1)"}, {"int v", "float v"},
+                    {"\n", "\n\n  "}, {"return r;", "return r + 1;"}, {"hola", "chau"}, {"int v", "int q;\nint v"},
+                    {"r = r + 1;", ""}, {"a * b", "a + b"}, {"(2.5 + 1)", "2.5"}, {"\n\n  ", "\n"}, {"x", "xy"}, {"r < 100", "r"},
+                };
+                auto [de, a] = cambios[azar() % (sizeof cambios / sizeof *cambios)];
+                size_t p = t.find(de, azar() % (t.size() + 1));
+                if(p == std::string::npos) p = t.find(de);
+                if(p != std::string::npos) ed.push_back({p, std::strlen(de), a});
+            } else {
+                size_t n = 1 + azar() % 3, pos = 0;
+                for(size_t e=0;e<n && pos <= t.size();e++){
+                    size_t p = pos + azar() % (t.size() - pos + 1);
+                    size_t borrar = std::min<size_t>(azar() % 4 == 0 ? 0 : azar() % 6, t.size() - p);
+                    std::string ins = azar() % 3 == 0 ? "" : trozos[azar() % (sizeof trozos / sizeof *trozos)];
+                    ed.push_back({p, borrar, ins});
+                    pos = p + borrar;
+                }
+            }
+            Diagnostico d = inc.editar(G, ed);
+            Arbol ref;
+            Diagnostico r = parseLR(G, inc.texto(), ref);
+            completos += inc.ultima().completo;
+            prueba.aceptados += d.aceptada;
+            prueba.comprobar(d.aceptada == r.aceptada && d.mensaje == r.mensaje && (!d.aceptada || mismoArbol(inc.arbol(), ref)), [&]{
+                std::fprintf(stderr, "FALLO incremental (ronda %d, edición %d): %s | %s\n", ronda, k, d.mensaje.c_str(), r.mensaje.c_str());
+            });
+            if(d.aceptada) ultimoValido = inc.texto();
+            else if(azar() % 8) inc.analizar(G, ultimoValido); // casi siempre se vuelve a un texto válido
+        }
+    }
+    std::printf("Reanálisis incremental frente a parseLR: %d casos (%d aceptados, %zu completos), %d fallos\n",
+                prueba.casos, prueba.aceptados, completos, prueba.fallos);
+    return prueba.codigo();
+}
+
+#endif
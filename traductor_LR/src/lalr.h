@@ -0,0 +1,477 @@
+// lalr.h
+// Generador de tablas LALR(1) a partir de las producciones R1..Rn del .inf.
+// El .inf ya trae el mapeo terminal -> columna; los no-terminales reciben
+// las columnas siguientes en el orden en que aparecen por primera vez como
+// lado izquierdo, y la regla Rk es la regla k del .lr.
+//
+// Construcción:
+//   1. autómata LR(0) (cerradura en profundidad, estados numerados en orden
+//      de descubrimiento) sobre la gramática aumentada S' -> <inicial> $;
+//   2. lookaheads LALR(1) con las relaciones de DeRemer y Pennello: DR,
+//      reads, includes y lookback sobre las transiciones con no-terminal,
+//      resueltas con el algoritmo Digraph (componentes fuertemente conexas)
+//      sobre conjuntos de terminales en bitsets de 64 bits. No se propaga
+//      ningún ítem LR(1), así que el costo es casi lineal en el tamaño del
+//      autómata;
+//   3. tabla densa con la codificación de cargarLR: >0 desplazar/goto, -1
+//      aceptar, -(r+1) reducir por Rr, 0 error.
+// Los conflictos se resuelven y se reportan (ver precedenciaImplicita).
+#ifndef LALR_H
+#define LALR_H
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* ------------------ Gramática ------------------ */
+struct Produccion {
+    int lhs;              // columna del no-terminal
+    std::vector<int> rhs; // columnas de los símbolos (vacío = \e)
+};
+
+// Los símbolos se identifican por su columna en la tabla: terminales en
+// [0, nTerminales) y no-terminales en [nTerminales, nTerminales + nNoTerm).
+struct GramaticaBNF {
+    std::vector<std::string> nombres; // por columna; los no-terminales sin <>
+    int nTerminales = 0;
+    int fin = -1;                     // columna de '$'
+    std::vector<Produccion> reglas;   // reglas[k] es R(k+1)
+
+    int nSimbolos() const { return (int)nombres.size(); }
+    bool esTerminal(int s) const { return s < nTerminales; }
+    std::string textoRegla(int r) const {
+        const Produccion &p = reglas[r];
+        std::string s = "R" + std::to_string(r + 1) + " <" + nombres[p.lhs] + "> ::=";
+        if(p.rhs.empty()) s += " \\e";
+        for(int x : p.rhs) s += esTerminal(x) ? " " + nombres[x] : " <" + nombres[x] + ">";
+        return s;
+    }
+};
+
+// Lee el mapeo de terminales y las líneas "Rk <A> ::= ..." del .inf.
+inline bool leerProducciones(const std::string &ruta, GramaticaBNF &g, std::string &error){
+    std::ifstream f(ruta);
+    if(!f){ error = "No se puede abrir el archivo INF: " + ruta; return false; }
+    std::map<std::string, int> terminales;
+    std::vector<std::vector<std::string>> lineas;
+    std::string linea;
+    int nLinea = 0;
+    std::vector<int> numeroLinea;
+    while(std::getline(f, linea)){
+        nLinea++;
+        std::istringstream is(linea);
+        std::vector<std::string> pal;
+        for(std::string p; is >> p;) pal.push_back(p);
+        if(pal.empty()) continue;
+        if(pal.size() >= 3 && pal[2] == "::=" && pal[0].size() > 1 && pal[0][0] == 'R'){
+            lineas.push_back(pal);
+            numeroLinea.push_back(nLinea);
+        } else if(pal.size() == 2 && lineas.empty()){
+            terminales[pal[0]] = std::atoi(pal[1].c_str());
+        } else {
+            error = "línea " + std::to_string(nLinea) + " no reconocida: " + linea;
+            return false;
+        }
+    }
+    int T = 0;
+    for(const auto &kv : terminales) T = std::max(T, kv.second + 1);
+    if(terminales.empty() || lineas.empty()){ error = "el .inf no tiene terminales o producciones"; return false; }
+    g = GramaticaBNF();
+    g.nTerminales = T;
+    g.nombres.assign(T, "");
+    for(const auto &kv : terminales){
+        if(kv.second < 0 || !g.nombres[kv.second].empty()){ error = "columna de terminal repetida o negativa: " + kv.first; return false; }
+        g.nombres[kv.second] = kv.first;
+    }
+    if(!terminales.count("$")){ error = "falta el terminal $"; return false; }
+    g.fin = terminales["$"];
+
+    auto esNoTerminal = [](const std::string &p){ return p.size() > 2 && p.front() == '<' && p.back() == '>'; };
+    std::map<std::string, int> noTerm;
+    for(const auto &pal : lineas){ // columnas en orden de aparición como lado izquierdo
+        if(!esNoTerminal(pal[1])){ error = "lado izquierdo inválido: " + pal[1]; return false; }
+        std::string A = pal[1].substr(1, pal[1].size() - 2);
+        if(!noTerm.count(A)){ noTerm[A] = g.nSimbolos(); g.nombres.push_back(A); }
+    }
+    for(size_t k=0;k<lineas.size();k++){
+        const auto &pal = lineas[k];
+        if(pal[0] != "R" + std::to_string(k + 1)){ error = "se esperaba R" + std::to_string(k + 1) + " en la línea " + std::to_string(numeroLinea[k]); return false; }
+        Produccion p;
+        p.lhs = noTerm[pal[1].substr(1, pal[1].size() - 2)];
+        for(size_t i=3;i<pal.size();i++){
+            const std::string &x = pal[i];
+            if(x == "\\e") continue;
+            if(esNoTerminal(x)){
+                auto it = noTerm.find(x.substr(1, x.size() - 2));
+                if(it == noTerm.end()){ error = "no-terminal sin producciones: " + x; return false; }
+                p.rhs.push_back(it->second);
+            } else {
+                auto it = terminales.find(x);
+                if(it == terminales.end()){ error = "terminal sin columna en el .inf: " + x + " (línea " + std::to_string(numeroLinea[k]) + ")"; return false; }
+                if(it->second == g.fin){ error = "$ no puede aparecer en una producción"; return false; }
+                p.rhs.push_back(it->second);
+            }
+        }
+        g.reglas.push_back(p);
+    }
+    return true;
+}
+
+/* ------------------ Resultado ------------------ */
+struct Conflicto {
+    int estado, terminal;
+    int desplazar;           // estado destino, o 0 si es reducir/reducir
+    int regla, otraRegla;    // 0-based; otraRegla = -1 si es desplazar/reducir
+    bool porPrecedencia;     // resuelto por precedencia/asociatividad
+    int elegido;             // valor que quedó en la celda
+};
+
+struct TablaLALR {
+    int nEstados = 0, nCols = 0;
+    std::vector<int32_t> celdas; // nEstados x nCols
+    std::vector<Conflicto> conflictos;
+    size_t nItems = 0, nTransNoTerm = 0;
+    int32_t at(int e, int c) const { return celdas[(size_t)e * nCols + c]; }
+};
+
+/* ------------------ Precedencia ------------------ */
+// El .inf no declara precedencias, así que se deducen de la forma de las
+// reglas, como lo hacía la tabla original:
+//   - <A> ::= op <A> (prefijo) liga más fuerte que cualquier binario;
+//   - <A> ::= <A> op <A> (binario): cada operador liga más fuerte que los
+//     que aparecen después en el .inf, y todos asocian a la izquierda.
+// La precedencia de un terminal es la de la regla binaria donde aparece como
+// operador. Nivel menor = liga más fuerte; 0 = sin precedencia.
+struct Precedencias {
+    std::vector<int> terminal, regla;
+};
+
+inline Precedencias precedenciaImplicita(const GramaticaBNF &g){
+    Precedencias p;
+    p.terminal.assign(g.nTerminales, 0);
+    p.regla.assign(g.reglas.size(), 0);
+    int nivel = 1;
+    for(size_t r=0;r<g.reglas.size();r++){
+        const Produccion &q = g.reglas[r];
+        if(q.rhs.size() == 3 && q.rhs[0] == q.lhs && q.rhs[2] == q.lhs && g.esTerminal(q.rhs[1])){
+            if(!p.terminal[q.rhs[1]]) p.terminal[q.rhs[1]] = ++nivel;
+            p.regla[r] = p.terminal[q.rhs[1]];
+        }
+    }
+    for(size_t r=0;r<g.reglas.size();r++){
+        const Produccion &q = g.reglas[r];
+        if(q.rhs.size() == 2 && g.esTerminal(q.rhs[0]) && q.rhs[1] == q.lhs) p.regla[r] = 1;
+    }
+    return p;
+}
+
+/* ------------------ Construcción ------------------ */
+namespace lalr_detalle {
+
+// Índice del bit menos significativo (bits != 0).
+inline int bajo(uint64_t bits){
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(bits);
+#else
+    int i = 0;
+    while(!(bits & 1)){ bits >>= 1; i++; }
+    return i;
+#endif
+}
+
+// Algoritmo Digraph de DeRemer y Pennello: F(x) = F'(x) ∪ ⋃{F(y) | x R y},
+// con los ciclos (componentes fuertes) compartiendo el mismo conjunto. F
+// trae F' al entrar; iterativo para no depender de la profundidad de pila.
+inline void digraph(size_t n, const std::vector<uint32_t> &inicioR, const std::vector<uint32_t> &R,
+                    std::vector<uint64_t> &F, size_t W){
+    const uint32_t INF = UINT32_MAX;
+    std::vector<uint32_t> N(n, 0), pila;
+    struct Marco { uint32_t x, k, d; };
+    std::vector<Marco> llamadas;
+    auto unir = [&F, W](size_t a, size_t b){ for(size_t w=0;w<W;w++) F[a*W+w] |= F[b*W+w]; };
+    for(uint32_t x0=0;x0<n;x0++){
+        if(N[x0]) continue;
+        pila.push_back(x0);
+        N[x0] = (uint32_t)pila.size();
+        llamadas.push_back({x0, inicioR[x0], N[x0]});
+        while(!llamadas.empty()){
+            Marco &m = llamadas.back();
+            uint32_t x = m.x;
+            if(m.k < inicioR[x + 1]){
+                uint32_t y = R[m.k];
+                if(N[y] == 0){ // entrar en y; al volver se completa este mismo paso
+                    pila.push_back(y);
+                    N[y] = (uint32_t)pila.size();
+                    llamadas.push_back({y, inicioR[y], N[y]});
+                    continue;
+                }
+                N[x] = std::min(N[x], N[y]);
+                unir(x, y);
+                m.k++;
+                continue;
+            }
+            if(N[x] == m.d){ // x es la raíz de su componente
+                while(true){
+                    uint32_t t = pila.back();
+                    pila.pop_back();
+                    N[t] = INF;
+                    if(t == x) break;
+                    for(size_t w=0;w<W;w++) F[t*W+w] = F[x*W+w];
+                }
+            }
+            llamadas.pop_back();
+            if(!llamadas.empty()){ // paso pendiente del padre sobre x
+                Marco &p = llamadas.back();
+                N[p.x] = std::min(N[p.x], N[x]);
+                unir(p.x, x);
+                p.k++;
+            }
+        }
+    }
+}
+
+} // namespace lalr_detalle
+
+// Conflictos: desplazar/reducir se decide por precedencia si ambos la
+// tienen (igual nivel: reducir, asociativo a la izquierda) y si no se
+// desplaza; reducir/reducir elige la regla que aparece primero. Todos quedan
+// en t.conflictos.
+inline bool generarLALR(const GramaticaBNF &g, TablaLALR &t, std::string &error, bool conPrecedencia = true){
+    using namespace lalr_detalle;
+    const int T = g.nTerminales, S = g.nSimbolos(), R = (int)g.reglas.size();
+    const size_t W = ((size_t)T + 63) / 64;
+    const int inicial = g.reglas[0].lhs;
+
+    // Regla aumentada R = S' -> <inicial> $. Ítem = primerItem[r] + punto.
+    std::vector<const std::vector<int>*> rhs(R + 1);
+    std::vector<int> aumentada{inicial, g.fin};
+    for(int r=0;r<R;r++) rhs[r] = &g.reglas[r].rhs;
+    rhs[R] = &aumentada;
+    std::vector<uint32_t> primerItem(R + 2, 0);
+    for(int r=0;r<=R;r++) primerItem[r + 1] = primerItem[r] + (uint32_t)rhs[r]->size() + 1;
+    std::vector<int> reglaDeItem(primerItem[R + 1]);
+    for(int r=0;r<=R;r++) for(uint32_t i=primerItem[r];i<primerItem[r + 1];i++) reglaDeItem[i] = r;
+    auto siguiente = [&](uint32_t it){ // símbolo después del punto, o -1
+        int r = reglaDeItem[it];
+        size_t punto = it - primerItem[r];
+        return punto < rhs[r]->size() ? (*rhs[r])[punto] : -1;
+    };
+    std::vector<std::vector<int>> reglasDe(S);
+    for(int r=0;r<R;r++) reglasDe[g.reglas[r].lhs].push_back(r);
+
+    // 1. Autómata LR(0).
+    std::vector<uint32_t> inicioKernel{0}, kernels;
+    std::vector<uint32_t> inicioTrans, transSimbolo, transDestino; // por estado, en orden de aparición
+    std::vector<uint32_t> inicioRed, redRegla;                     // reducciones de cada estado
+    std::unordered_map<std::string, uint32_t> porKernel;
+    auto clave = [](std::vector<uint32_t> k){
+        std::sort(k.begin(), k.end());
+        return std::string((const char*)k.data(), k.size() * sizeof(uint32_t));
+    };
+    kernels.push_back(primerItem[R]);
+    inicioKernel.push_back(1);
+    porKernel[clave({primerItem[R]})] = 0;
+    int estadoAceptar = -1;
+    std::vector<uint32_t> cerradura, marca(S, UINT32_MAX), grupoDe(S, UINT32_MAX);
+    std::vector<std::vector<uint32_t>> grupos;
+    std::vector<int> ordenSimbolos;
+    size_t nItems = 0;
+    for(uint32_t e=0; e + 1 < inicioKernel.size(); e++){
+        // Cerradura en profundidad: cada no-terminal se expande al aparecer.
+        cerradura.clear();
+        std::vector<uint32_t> pendientes;
+        for(uint32_t k=inicioKernel[e + 1]; k-- > inicioKernel[e];) pendientes.push_back(kernels[k]);
+        while(!pendientes.empty()){
+            uint32_t it = pendientes.back();
+            pendientes.pop_back();
+            cerradura.push_back(it);
+            int X = siguiente(it);
+            if(X >= T && marca[X] != e){
+                marca[X] = e;
+                const std::vector<int> &rs = reglasDe[X];
+                for(size_t k=rs.size(); k-- > 0;) pendientes.push_back(primerItem[rs[k]]);
+            }
+        }
+        nItems += cerradura.size();
+        // Transiciones agrupadas por símbolo, en orden de primera aparición.
+        ordenSimbolos.clear();
+        inicioRed.push_back((uint32_t)redRegla.size());
+        for(uint32_t it : cerradura){
+            int X = siguiente(it);
+            if(X < 0){ redRegla.push_back((uint32_t)reglaDeItem[it]); continue; }
+            if(X == g.fin){ estadoAceptar = (int)e; continue; } // S' -> inicial . $
+            if(grupoDe[X] == UINT32_MAX){
+                grupoDe[X] = (uint32_t)ordenSimbolos.size();
+                ordenSimbolos.push_back(X);
+                if(grupos.size() < ordenSimbolos.size()) grupos.emplace_back();
+                grupos[grupoDe[X]].clear();
+            }
+            grupos[grupoDe[X]].push_back(it + 1);
+        }
+        inicioTrans.push_back((uint32_t)transSimbolo.size());
+        for(size_t k=0;k<ordenSimbolos.size();k++){
+            int X = ordenSimbolos[k];
+            grupoDe[X] = UINT32_MAX;
+            const std::vector<uint32_t> &kern = grupos[k];
+            auto [pos, nuevo] = porKernel.emplace(clave(kern), (uint32_t)(inicioKernel.size() - 1));
+            if(nuevo){
+                kernels.insert(kernels.end(), kern.begin(), kern.end());
+                inicioKernel.push_back((uint32_t)kernels.size());
+            }
+            transSimbolo.push_back((uint32_t)X);
+            transDestino.push_back(pos->second);
+        }
+    }
+    const uint32_t nEstados = (uint32_t)inicioKernel.size() - 1;
+    inicioTrans.push_back((uint32_t)transSimbolo.size());
+    inicioRed.push_back((uint32_t)redRegla.size());
+    if(nEstados > 32767){ error = "demasiados estados para la tabla (" + std::to_string(nEstados) + ")"; return false; }
+    if(estadoAceptar < 0){ error = "la gramática no deriva ninguna cadena"; return false; }
+
+    // Desplazamientos y gotos van directo a la tabla, que sirve también
+    // para consultar (estado, símbolo) -> destino (0 = sin transición: el
+    // estado 0 nunca es destino). Se numeran las transiciones con no-terminal.
+    t = TablaLALR();
+    t.nEstados = (int)nEstados;
+    t.nCols = S;
+    t.nItems = nItems;
+    t.celdas.assign((size_t)nEstados * S, 0);
+    auto ir = [&t, S](uint32_t e, int X){ return (uint32_t)t.celdas[(size_t)e * S + X]; };
+    std::vector<uint64_t> claveX; // (estado << 32 | no-terminal) ordenadas: la posición es el id de la transición
+    for(uint32_t e=0;e<nEstados;e++)
+        for(uint32_t k=inicioTrans[e];k<inicioTrans[e + 1];k++){
+            t.celdas[(size_t)e * S + transSimbolo[k]] = (int32_t)transDestino[k];
+            if((int)transSimbolo[k] >= T) claveX.push_back((uint64_t)e << 32 | transSimbolo[k]);
+        }
+    std::sort(claveX.begin(), claveX.end());
+    auto idTrans = [&claveX](uint32_t e, int X){
+        return (uint32_t)(std::lower_bound(claveX.begin(), claveX.end(), (uint64_t)e << 32 | (uint32_t)X) - claveX.begin());
+    };
+    std::vector<uint32_t> transEstado, transNT; // transición x = (transEstado[x], transNT[x])
+    for(uint64_t c : claveX){ transEstado.push_back((uint32_t)(c >> 32)); transNT.push_back((uint32_t)c); }
+    const size_t nX = transEstado.size();
+
+    // Anulables y, por regla, desde qué posición el resto es anulable.
+    std::vector<char> anulable(S, 0);
+    for(bool cambio = true; cambio;){
+        cambio = false;
+        for(int r=0;r<R;r++){
+            const Produccion &p = g.reglas[r];
+            if(anulable[p.lhs]) continue;
+            bool todos = true;
+            for(int x : p.rhs) if(!anulable[x]){ todos = false; break; }
+            if(todos){ anulable[p.lhs] = 1; cambio = true; }
+        }
+    }
+
+    // 2. DR y reads -> Read.
+    std::vector<uint64_t> F(nX * W, 0);
+    std::vector<uint32_t> inicioRel(nX + 1, 0), rel;
+    for(size_t x=0;x<nX;x++){
+        uint32_t r = ir(transEstado[x], (int)transNT[x]);
+        for(uint32_t k=inicioTrans[r];k<inicioTrans[r + 1];k++){
+            int C = (int)transSimbolo[k];
+            if(C < T) F[x*W + C/64] |= 1ull << (C % 64);
+            else if(anulable[C]) rel.push_back(idTrans(r, C));
+        }
+        if((int)r == estadoAceptar) F[x*W + g.fin/64] |= 1ull << (g.fin % 64);
+        inicioRel[x + 1] = (uint32_t)rel.size();
+    }
+    digraph(nX, inicioRel, rel, F, W);
+
+    // includes: (p, A) includes (p', B) si B -> β A γ, γ anulable y p' --β--> p.
+    // En el mismo recorrido se anota lookback: (q, B -> ω) con p' --ω--> q.
+    std::vector<std::pair<uint32_t, uint32_t>> incluye; // (x, y)
+    std::vector<std::pair<uint32_t, uint32_t>> lookback; // (índice de reducción, y)
+    for(size_t y=0;y<nX;y++){
+        uint32_t p0 = transEstado[y];
+        for(int r : reglasDe[transNT[y]]){
+            const std::vector<int> &b = g.reglas[r].rhs;
+            size_t anulDesde = b.size();
+            while(anulDesde > 0 && anulable[b[anulDesde - 1]]) anulDesde--;
+            uint32_t p = p0;
+            for(size_t i=0;i<b.size();i++){
+                if(b[i] >= T && i + 1 >= anulDesde) incluye.push_back({idTrans(p, b[i]), (uint32_t)y});
+                p = ir(p, b[i]);
+            }
+            uint32_t k = inicioRed[p];
+            while(redRegla[k] != (uint32_t)r) k++;
+            lookback.push_back({k, (uint32_t)y});
+        }
+    }
+    std::sort(incluye.begin(), incluye.end());
+    incluye.erase(std::unique(incluye.begin(), incluye.end()), incluye.end());
+    inicioRel.assign(nX + 1, 0);
+    rel.clear();
+    for(auto &par : incluye){ inicioRel[par.first + 1]++; rel.push_back(par.second); }
+    for(size_t x=0;x<nX;x++) inicioRel[x + 1] += inicioRel[x];
+    digraph(nX, inicioRel, rel, F, W); // F = Follow
+
+    std::vector<uint64_t> LA(redRegla.size() * W, 0);
+    for(auto &[k, y] : lookback) for(size_t w=0;w<W;w++) LA[k*W + w] |= F[y*W + w];
+
+    // 3. Tabla.
+    Precedencias prec;
+    if(conPrecedencia) prec = precedenciaImplicita(g);
+    t.nTransNoTerm = nX;
+    for(uint32_t e=0;e<nEstados;e++){
+        int32_t *fila = &t.celdas[(size_t)e * S];
+        if((int)e == estadoAceptar) fila[g.fin] = -1;
+        for(uint32_t k=inicioRed[e];k<inicioRed[e + 1];k++){
+            int r = (int)redRegla[k];
+            for(size_t w=0;w<W;w++) for(uint64_t bits = LA[k*W + w]; bits; bits &= bits - 1){
+                int a = (int)(w * 64) + lalr_detalle::bajo(bits);
+                int32_t &c = fila[a];
+                int32_t red = -(r + 2);
+                if(c == 0){ c = red; continue; }
+                Conflicto cf{(int)e, a, c > 0 ? c : 0, r, c > 0 ? -1 : -c - 2, false, 0};
+                if(c > 0){
+                    int pr = prec.regla.empty() ? 0 : prec.regla[r], pt = prec.terminal.empty() ? 0 : prec.terminal[a];
+                    cf.porPrecedencia = pr && pt;
+                    if(cf.porPrecedencia && pr <= pt) c = red;
+                } else {
+                    c = -(std::min(r, cf.otraRegla) + 2);
+                }
+                cf.elegido = c;
+                t.conflictos.push_back(cf);
+            }
+        }
+    }
+    return true;
+}
+
+/* ------------------ Salida ------------------ */
+// Mismo formato que lee cargarLR: número de reglas, "columna longitud
+// nombre" por regla, dimensiones y la tabla densa, separados por tabuladores.
+inline void escribirLR(const GramaticaBNF &g, const TablaLALR &t, std::ostream &os){
+    os << g.reglas.size() << "\n";
+    for(const Produccion &p : g.reglas) os << p.lhs << "\t" << p.rhs.size() << "\t" << g.nombres[p.lhs] << "\n";
+    os << t.nEstados << "\t" << t.nCols << "\n";
+    for(int e=0;e<t.nEstados;e++){
+        for(int c=0;c<t.nCols;c++) os << (c ? "\t" : "") << t.at(e, c);
+        os << "\n";
+    }
+}
+
+// Una línea por conflicto, con la regla, el terminal y cómo se resolvió; los
+// resueltos por precedencia sólo si 'todos'.
+inline void reportarConflictos(const GramaticaBNF &g, const TablaLALR &t, std::ostream &os, bool todos = false){
+    for(const Conflicto &c : t.conflictos){
+        if(c.porPrecedencia && !todos) continue;
+        os << "Conflicto " << (c.otraRegla < 0 ? "desplazar/reducir" : "reducir/reducir") << " en el estado " << c.estado
+           << " con '" << g.nombres[c.terminal] << "': ";
+        if(c.otraRegla < 0) os << "desplazar a " << c.desplazar << " o reducir por " << g.textoRegla(c.regla);
+        else os << g.textoRegla(std::min(c.regla, c.otraRegla)) << " o " << g.textoRegla(std::max(c.regla, c.otraRegla));
+        os << " -> " << (c.elegido > 0 ? "desplazar" : "reducir por R" + std::to_string(-c.elegido - 1));
+        if(c.porPrecedencia) os << " (precedencia)";
+        os << "\n";
+    }
+}
+
+#endif
@@ -0,0 +1,51 @@
+// lalr_verificar.h
+// Prueba diferencial del generador LALR(1) (benchmark --verificar-lalr): la
+// tabla que genera lalr.h desde el .inf debe aceptar lo mismo que la del .lr
+// y dar el mismo árbol; los mensajes de error pueden citar otros estados.
+#ifndef LALR_VERIFICAR_H
+#define LALR_VERIFICAR_H
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include "lalr.h"
+#include "parser.h"
+#include "verificacion.h"
+
+inline int verificarLALR(ContextoVerificacion &c){
+    const LRGram &ref = c.G;
+    GramaticaBNF g;
+    TablaLALR t;
+    std::string error;
+    if(!leerProducciones(c.rutaInf, g, error) || !generarLALR(g, t, error)){ std::fprintf(stderr, "Error: %s\n", error.c_str()); return 1; }
+    std::ostringstream os;
+    escribirLR(g, t, os);
+    std::istringstream is(os.str());
+    LRGram G;
+    if(!cargarLR(is, G) || !leerInf(c.rutaInf, G)) return 1;
+    resolverTokens(G);
+
+    // La tabla del .lr rechaza un else justo después de un if-else completo
+    // (if (a) if (b) x; else y; else z;), que la gramática y la tabla
+    // generada aceptan: esos casos se cuentan aparte.
+    PruebaDiferencial prueba;
+    int elseDeMas = 0;
+    auto caso = [&](const std::string &s){
+        Arbol a, b;
+        Diagnostico d1 = parseLR(ref, s, a), d2 = parseLR(G, s, b);
+        prueba.aceptados += d1.aceptada;
+        bool sobraElse = !d1.aceptada && d2.aceptada && s.compare(d1.pos, 4, "else") == 0;
+        elseDeMas += sobraElse;
+        prueba.comprobar(sobraElse || (d1.aceptada == d2.aceptada && (!d1.aceptada || mismoArbol(a, b))), [&]{
+            std::fprintf(stderr, "FALLO LALR: %s | %s\n<<%s>>\n", d1.mensaje.c_str(), d2.mensaje.c_str(), s.c_str());
+        });
+    };
+    caso(generarEntrada(200000));
+    Azar azar(1234567u);
+    programasMutados(azar, 3000, 3, {"x", "1", "(", ")", "{", "}", "+", "*", "==", "&&", "!", "else ", "if (a) ", "int ", ";", ",", "g(", "return "}, caso);
+    std::printf("Tabla LALR(1) generada (%d estados, %zu conflictos) frente al .lr: %d casos (%d aceptados, %d else de más "
+                "que sólo acepta la generada), %d fallos\n", t.nEstados, t.conflictos.size(), prueba.casos, prueba.aceptados, elseDeMas, prueba.fallos);
+    return prueba.codigo();
+}
+
+#endif
@@ -0,0 +1,101 @@
+// lexemas.h
+// Tabla de internado de lexemas: cada identificador o literal distinto recibe
+// un id entero pequeño la primera vez que aparece. El texto se copia una sola
+// vez a bloques propios, así que los string_view devueltos siguen siendo
+// válidos aunque la entrada original ya no exista.
+#ifndef LEXEMAS_H
+#define LEXEMAS_H
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+class TablaLexemas {
+public:
+    static const uint32_t NINGUNO = UINT32_MAX;
+
+    TablaLexemas() { ranuras.assign(64, 0); }
+
+    // Id del lexema, creándolo si es la primera vez que aparece.
+    uint32_t intern(std::string_view s) {
+        uint32_t h = hash(s);
+        size_t mascara = ranuras.size() - 1;
+        for (size_t k = h & mascara;; k = (k + 1) & mascara) {
+            uint32_t r = ranuras[k];
+            if (r == 0) {
+                uint32_t id = (uint32_t)textos.size();
+                textos.push_back(copiar(s));
+                hashes.push_back(h);
+                ranuras[k] = id + 1;
+                if (textos.size() * 2 > ranuras.size()) crecer();
+                return id;
+            }
+            if (hashes[r - 1] == h && textos[r - 1] == s) return r - 1;
+        }
+    }
+
+    std::string_view texto(uint32_t id) const { return textos[id]; }
+    size_t size() const { return textos.size(); }
+    size_t bytes() const {
+        return bloques.size() * TAM_BLOQUE + bytesGrandes + ranuras.capacity() * sizeof(uint32_t) +
+               textos.capacity() * sizeof(std::string_view) + hashes.capacity() * sizeof(uint32_t);
+    }
+
+    void limpiar() {
+        textos.clear();
+        hashes.clear();
+        ranuras.assign(64, 0);
+        bloques.clear();
+        grandes.clear();
+        bytesGrandes = 0;
+        libre = 0;
+    }
+
+private:
+    static const size_t TAM_BLOQUE = 64 * 1024;
+
+    std::vector<std::string_view> textos; // por id
+    std::vector<uint32_t> hashes;         // por id
+    std::vector<uint32_t> ranuras;        // direccionamiento abierto: id+1, 0 = libre
+    std::vector<std::unique_ptr<char[]>> bloques, grandes;
+    size_t libre = 0;                     // bytes disponibles en el último bloque
+    size_t bytesGrandes = 0;
+
+    static uint32_t hash(std::string_view s) {
+        uint32_t h = 2166136261u;
+        for (unsigned char c : s) { h ^= c; h *= 16777619u; }
+        return h;
+    }
+
+    std::string_view copiar(std::string_view s) {
+        if (s.size() > TAM_BLOQUE / 4) { // los lexemas enormes van en su propio bloque
+            grandes.emplace_back(new char[s.size()]);
+            std::memcpy(grandes.back().get(), s.data(), s.size());
+            bytesGrandes += s.size();
+            return std::string_view(grandes.back().get(), s.size());
+        }
+        if (s.size() > libre) {
+            bloques.emplace_back(new char[TAM_BLOQUE]);
+            libre = TAM_BLOQUE;
+        }
+        char *p = bloques.back().get() + (TAM_BLOQUE - libre);
+        std::memcpy(p, s.data(), s.size());
+        libre -= s.size();
+        return std::string_view(p, s.size());
+    }
+
+    void crecer() {
+        std::vector<uint32_t> nuevas(ranuras.size() * 2, 0);
+        size_t mascara = nuevas.size() - 1;
+        for (uint32_t id = 0; id < textos.size(); id++) {
+            size_t k = hashes[id] & mascara;
+            while (nuevas[k]) k = (k + 1) & mascara;
+            nuevas[k] = id + 1;
+        }
+        ranuras.swap(nuevas);
+    }
+};
+
+#endif
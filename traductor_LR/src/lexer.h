@@ -0,0 +1,173 @@
+// lexer.h
+// Tokens del lenguaje de compilador.inf y analizador léxico escrito a mano.
+#ifndef LEXER_H
+#define LEXER_H
+
+#include <cctype>
+#include <string>
+#include <string_view>
+
+/* ------------------ Definición de Tokens ------------------ */
+enum class TokenType {
+    IDENT, ENTERO, REAL, CADENA,
+    TIPO_INT, TIPO_FLOAT,
+    OP_SUMA, OP_MUL, OP_ASIG,
+    OP_RELAC, OP_AND, OP_OR, OP_NOT, OP_IGUALDAD,
+    PUNTO_Y_COMA, COMA,
+    PARENTESIS_ABRE, PARENTESIS_CIERRA,
+    LLAVE_ABRE, LLAVE_CIERRA,
+    RESERVADA_IF, RESERVADA_WHILE, RESERVADA_RETURN, RESERVADA_ELSE,
+    DESCONOCIDO, FIN
+};
+
+struct Token {
+    TokenType type;
+    std::string_view lexeme; // apunta a la entrada (o a un literal fijo)
+    size_t pos; // Posición inicial del lexema en la cadena de entrada
+    // Podríamos añadir línea y columna para un reporte de errores más preciso
+    // size_t line;
+    // size_t col;
+};
+
+inline bool esLetra(char c){ return isalpha((unsigned char)c)!=0; }
+
+/* ------------------ LEXER ------------------ */
+class Lexer {
+public:
+    explicit Lexer(std::string_view src) : s(src), n(src.size()), i(0) {}
+    Token next(){
+        saltarBlancos();
+        if (i >= n) return {TokenType::FIN, "$", i};
+        char c = s[i];
+
+        // Identificadores y palabras reservadas
+        if (esLetra(c)) {
+            size_t start = i++;
+            while (i < n && (esLetra(s[i]) || isdigit((unsigned char)s[i]))) ++i;
+            std::string_view lex = s.substr(start, i-start);
+            if (lex=="if") return {TokenType::RESERVADA_IF, lex, start};
+            if (lex=="while") return {TokenType::RESERVADA_WHILE, lex, start};
+            if (lex=="return") return {TokenType::RESERVADA_RETURN, lex, start};
+            if (lex=="else") return {TokenType::RESERVADA_ELSE, lex, start};
+            if (lex=="int") return {TokenType::TIPO_INT, lex, start};
+            if (lex=="float") return {TokenType::TIPO_FLOAT, lex, start};
+            return {TokenType::IDENT, lex, start};
+        }
+
+        // Números (Entero y Real)
+        if (isdigit((unsigned char)c)) {
+            size_t start = i++;
+            while (i < n && isdigit((unsigned char)s[i])) ++i;
+            if (i < n && s[i]=='.') {
+                size_t p = i++; // Guarda la posición del punto
+                if (i < n && isdigit((unsigned char)s[i])) {
+                    while (i < n && isdigit((unsigned char)s[i])) ++i;
+                    return {TokenType::REAL, s.substr(start, i-start), start};
+                } else {
+                    // Si hay un punto pero no dígitos después, retrocede y trata como entero
+                    i = p;
+                }
+            }
+            return {TokenType::ENTERO, s.substr(start, i-start), start};
+        }
+
+        // Cadenas
+        if (c=='"') {
+            size_t start = i++;
+            while (i<n && s[i]!='"') i++;
+            if (i<n) i++; // Consumir la comilla de cierre
+            return {TokenType::CADENA, s.substr(start, i-start), start};
+        }
+
+        // Operadores y símbolos
+        if (c=='+'){ i++; return {TokenType::OP_SUMA, "+", i-1}; }
+        if (c=='-'){ i++; return {TokenType::OP_SUMA, "-", i-1}; }
+        if (c=='*'){ i++; return {TokenType::OP_MUL, "*", i-1}; }
+        if (c=='/'){ i++; return {TokenType::OP_MUL, "/", i-1}; }
+        if (c=='='){
+            if (i+1 < n && s[i+1]=='='){ i+=2; return {TokenType::OP_IGUALDAD,"==",i-2}; }
+            i++; return {TokenType::OP_ASIG, "=", i-1};
+        }
+        if (c=='!'){
+            if (i+1<n && s[i+1]=='='){ i+=2; return {TokenType::OP_IGUALDAD,"!=",i-2}; }
+            i++; return {TokenType::OP_NOT,"!",i-1};
+        }
+        if (c=='<' || c=='>'){
+            // Manejo de <= y >=
+            if (i+1 < n && s[i+1]=='='){ i+=2; return {TokenType::OP_RELAC, s.substr(i-2,2), i-2}; }
+            i++; return {TokenType::OP_RELAC, s.substr(i-1,1), i-1};
+        }
+        if (c=='&' && i+1<n && s[i+1]=='&'){ i+=2; return {TokenType::OP_AND,"&&",i-2}; }
+        if (c=='|' && i+1<n && s[i+1]=='|'){ i+=2; return {TokenType::OP_OR,"||",i-2}; }
+
+        if (c==';'){ i++; return {TokenType::PUNTO_Y_COMA, ";", i-1}; }
+        if (c==','){ i++; return {TokenType::COMA, ",", i-1}; }
+        if (c=='('){ i++; return {TokenType::PARENTESIS_ABRE, "(", i-1}; }
+        if (c==')'){ i++; return {TokenType::PARENTESIS_CIERRA, ")", i-1}; }
+        if (c=='{'){ i++; return {TokenType::LLAVE_ABRE, "{", i-1}; }
+        if (c=='}'){ i++; return {TokenType::LLAVE_CIERRA, "}", i-1}; }
+
+        // Desconocido
+        size_t start = i++;
+        return {TokenType::DESCONOCIDO, s.substr(start,1), start};
+    }
+private:
+    std::string_view s;
+    size_t n;
+    size_t i;
+    void saltarBlancos(){
+        while (i<n && isspace((unsigned char)s[i])) ++i;
+    }
+};
+
+/* ------------------ Token -> clave de .inf ------------------ */
+// Nombre del enumerador, para reportes y código generado.
+constexpr const char* nombreTipoToken(TokenType t){
+    constexpr const char *nombres[] = {
+        "IDENT", "ENTERO", "REAL", "CADENA",
+        "TIPO_INT", "TIPO_FLOAT",
+        "OP_SUMA", "OP_MUL", "OP_ASIG",
+        "OP_RELAC", "OP_AND", "OP_OR", "OP_NOT", "OP_IGUALDAD",
+        "PUNTO_Y_COMA", "COMA",
+        "PARENTESIS_ABRE", "PARENTESIS_CIERRA",
+        "LLAVE_ABRE", "LLAVE_CIERRA",
+        "RESERVADA_IF", "RESERVADA_WHILE", "RESERVADA_RETURN", "RESERVADA_ELSE",
+        "DESCONOCIDO", "FIN"
+    };
+    static_assert(sizeof(nombres)/sizeof(nombres[0]) == (size_t)TokenType::FIN + 1, "nombreTipoToken no coincide con TokenType");
+    return nombres[(int)t];
+}
+
+constexpr const char* tokenToKey(TokenType t){
+    switch(t){
+        case TokenType::IDENT: return "identificador";
+        case TokenType::ENTERO: return "entero";
+        case TokenType::REAL: return "real";
+        case TokenType::CADENA: return "cadena";
+        case TokenType::TIPO_INT:
+        case TokenType::TIPO_FLOAT: return "tipo"; // Agrupados como "tipo"
+        case TokenType::OP_SUMA: return "opSuma";
+        case TokenType::OP_MUL: return "opMul";
+        case TokenType::OP_ASIG: return "=";
+        case TokenType::OP_RELAC: return "opRelac";
+        case TokenType::OP_AND: return "opAnd";
+        case TokenType::OP_OR: return "opOr";
+        case TokenType::OP_NOT: return "opNot";
+        case TokenType::OP_IGUALDAD: return "opIgualdad";
+        case TokenType::PUNTO_Y_COMA: return ";";
+        case TokenType::COMA: return ",";
+        case TokenType::PARENTESIS_ABRE: return "(";
+        case TokenType::PARENTESIS_CIERRA: return ")";
+        case TokenType::LLAVE_ABRE: return "{";
+        case TokenType::LLAVE_CIERRA: return "}";
+        case TokenType::RESERVADA_IF: return "if";
+        case TokenType::RESERVADA_WHILE: return "while";
+        case TokenType::RESERVADA_RETURN: return "return";
+        case TokenType::RESERVADA_ELSE: return "else";
+        case TokenType::FIN: return "$";
+        case TokenType::DESCONOCIDO: return "DESCONOCIDO"; // Para errores léxicos
+    }
+    return "DESCONOCIDO";
+}
+
+#endif
@@ -0,0 +1,112 @@
+// lexer_paralelo.h
+// Análisis léxico en paralelo de una entrada completa en memoria.
+//   1. La entrada se divide en trozos y se cuentan las comillas de cada uno
+//      en paralelo. Como las cadenas no tienen escapes, toda comilla abre o
+//      cierra una cadena, y la paridad de las comillas anteriores a una
+//      posición (suma prefija de los conteos) dice si esa posición está
+//      dentro de una cadena.
+//   2. Cada corte se corre hasta el primer espacio fuera de cadena. Ningún
+//      token contiene espacios fuera de las cadenas, así que ahí termina un
+//      token y empieza otro en el análisis secuencial. Si un trozo no tiene
+//      ese espacio se une con el siguiente.
+//   3. Cada segmento se analiza con LexerRapido sobre la entrada completa
+//      (posiciones globales, y los tokens pueden mirar más allá del corte)
+//      y los tokens se concatenan en orden.
+// El resultado es idéntico, token por token, al de LexerRapido secuencial.
+// Compilar con -pthread.
+#ifndef LEXER_PARALELO_H
+#define LEXER_PARALELO_H
+
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "hilos.h"
+#include "lexer.h"
+#include "lexer_rapido.h"
+
+inline size_t contarComillas(const char *p, size_t n){
+    size_t c = 0;
+    for (size_t i = 0; i < n; i++) c += p[i] == '"';
+    return c;
+}
+
+// Inicios de segmento (el primero es 0) para unos 'trozos' segmentos.
+inline std::vector<size_t> cortesLexer(std::string_view s, size_t trozos, PoolTrabajo &pool){
+    size_t n = s.size();
+    trozos = std::max<size_t>(1, std::min(trozos, n));
+    std::vector<size_t> nominal(trozos + 1), comillas(trozos);
+    for (size_t k = 0; k <= trozos; k++) nominal[k] = n * k / trozos;
+    pool.paraCada(trozos, [&](size_t k, unsigned){
+        comillas[k] = contarComillas(s.data() + nominal[k], nominal[k+1] - nominal[k]);
+    });
+    std::vector<size_t> cortes(trozos, SIZE_MAX);
+    cortes[0] = 0;
+    std::vector<bool> dentro(trozos);
+    bool paridad = false;
+    for (size_t k = 0; k < trozos; k++) { dentro[k] = paridad; paridad ^= comillas[k] & 1; }
+    pool.paraCada(trozos - 1, [&](size_t j, unsigned){
+        size_t k = j + 1;
+        bool enCadena = dentro[k];
+        for (size_t i = nominal[k]; i < nominal[k+1]; i++) {
+            unsigned char c = (unsigned char)s[i];
+            if (c == '"') enCadena = !enCadena;
+            else if (!enCadena && TABLAS_LEXER.clase[c] == CC_ESPACIO) { cortes[k] = i; return; }
+        }
+    });
+    cortes.erase(std::remove(cortes.begin(), cortes.end(), SIZE_MAX), cortes.end());
+    return cortes;
+}
+
+// Tokens de cada segmento, en orden; el último segmento termina en FIN.
+// Concatenarlos costaría otra copia de todos los tokens, así que se dejan
+// separados y FuenteTokens los recorre seguidos.
+struct TokensParalelos {
+    std::vector<std::vector<Token>> partes;
+
+    size_t size() const {
+        size_t t = 0;
+        for (auto &v : partes) t += v.size();
+        return t;
+    }
+};
+
+// Todos los tokens de 's', terminando en FIN, como los daría LexerRapido.
+inline TokensParalelos lexerParalelo(std::string_view s, PoolTrabajo &pool, size_t trozos = 0){
+    if (trozos == 0) trozos = std::min((size_t)pool.size() * 4, s.size() / 65536 + 1); // trozos de 64 KB o más
+    std::vector<size_t> cortes = cortesLexer(s, trozos, pool);
+    TokensParalelos r;
+    r.partes.resize(cortes.size());
+    pool.paraCada(cortes.size(), [&](size_t k, unsigned){
+        size_t fin = k + 1 < cortes.size() ? cortes[k+1] : SIZE_MAX;
+        std::vector<Token> &v = r.partes[k];
+        v.reserve((std::min(fin, s.size()) - cortes[k]) / 4 + 1);
+        LexerRapido lx(s, cortes[k]);
+        while (true) {
+            Token tk = lx.next();
+            if (tk.pos >= fin) break; // FIN del segmento intermedio: tk.pos == s.size() >= fin
+            v.push_back(tk);
+            if (tk.type == TokenType::FIN) break;
+        }
+    });
+    return r;
+}
+
+// Fuente de tokens para analizarLR sobre el resultado de lexerParalelo.
+class FuenteTokens {
+public:
+    explicit FuenteTokens(const TokensParalelos &t) : partes(t.partes) {}
+    Token next() {
+        while (i == partes[k].size()) { // segmento agotado (puede haber vacíos)
+            if (k + 1 == partes.size()) return partes[k].back(); // FIN se repite
+            k++;
+            i = 0;
+        }
+        return partes[k][i++];
+    }
+private:
+    const std::vector<std::vector<Token>> &partes;
+    size_t k = 0, i = 0;
+};
+
+#endif
@@ -0,0 +1,252 @@
+// lexer_rapido.h
+// Motor léxico dirigido por tablas. Produce exactamente los mismos tokens
+// que Lexer (lexer.h), que se conserva como implementación de referencia:
+//   - una tabla de 256 clases de carácter reemplaza a isalpha/isdigit/isspace
+//     (que dependen del locale; aquí se fija el comportamiento del locale "C"),
+//   - las corridas de espacios, cuerpos de identificador, dígitos y cuerpos de
+//     cadena se recorren con SSE2 (o AVX2 si se compila con -mavx2),
+//   - las palabras reservadas se reconocen con un switch por longitud.
+#ifndef LEXER_RAPIDO_H
+#define LEXER_RAPIDO_H
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include "lexer.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+/* ------------------ Clases de carácter ------------------ */
+enum ClaseChar : uint8_t {
+    CC_OTRO, CC_ESPACIO, CC_LETRA, CC_DIGITO, CC_COMILLA,
+    CC_SIMPLE,          // operador de un carácter sin variantes: + - * / ; , ( ) { }
+    CC_IGUAL, CC_ADMIRACION, CC_MENOR_MAYOR, CC_AMPERSAND, CC_BARRA
+};
+
+struct TablasLexer {
+    std::array<uint8_t, 256> clase{};
+    std::array<uint8_t, 256> simple{}; // TokenType de los CC_SIMPLE
+};
+
+constexpr TablasLexer construirTablasLexer(){
+    TablasLexer t{};
+    for (int c = 0; c < 256; c++) t.clase[c] = CC_OTRO;
+    for (int c : {' ', '\t', '\n', '\v', '\f', '\r'}) t.clase[c] = CC_ESPACIO;
+    for (int c = 'a'; c <= 'z'; c++) t.clase[c] = CC_LETRA;
+    for (int c = 'A'; c <= 'Z'; c++) t.clase[c] = CC_LETRA;
+    for (int c = '0'; c <= '9'; c++) t.clase[c] = CC_DIGITO;
+    t.clase['"'] = CC_COMILLA;
+    t.clase['='] = CC_IGUAL;
+    t.clase['!'] = CC_ADMIRACION;
+    t.clase['<'] = CC_MENOR_MAYOR;
+    t.clase['>'] = CC_MENOR_MAYOR;
+    t.clase['&'] = CC_AMPERSAND;
+    t.clase['|'] = CC_BARRA;
+    struct { char c; TokenType tipo; } simples[] = {
+        {'+', TokenType::OP_SUMA}, {'-', TokenType::OP_SUMA},
+        {'*', TokenType::OP_MUL}, {'/', TokenType::OP_MUL},
+        {';', TokenType::PUNTO_Y_COMA}, {',', TokenType::COMA},
+        {'(', TokenType::PARENTESIS_ABRE}, {')', TokenType::PARENTESIS_CIERRA},
+        {'{', TokenType::LLAVE_ABRE}, {'}', TokenType::LLAVE_CIERRA},
+    };
+    for (auto s : simples) {
+        t.clase[(unsigned char)s.c] = CC_SIMPLE;
+        t.simple[(unsigned char)s.c] = (uint8_t)s.tipo;
+    }
+    return t;
+}
+
+inline constexpr TablasLexer TABLAS_LEXER = construirTablasLexer();
+
+/* ------------------ Recorridos SIMD ------------------ */
+// Cada función devuelve la primera posición >= i (y <= n) cuyo carácter ya no
+// pertenece a la clase. El bloque vectorial sólo se usa mientras quedan
+// bytes completos; la cola se termina con la tabla.
+#if defined(__AVX2__)
+#define LEXER_SIMD "AVX2"
+typedef __m256i VecLexer;
+const size_t ANCHO_SIMD = 32;
+inline VecLexer cargarVec(const char *p){ return _mm256_loadu_si256((const __m256i*)p); }
+inline VecLexer difundir(char c){ return _mm256_set1_epi8(c); }
+inline VecLexer enRango(VecLexer x, char lo, char hi){
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(_mm256_max_epu8(x, difundir(lo)), difundir(hi)), x);
+}
+inline VecLexer igualA(VecLexer x, char c){ return _mm256_cmpeq_epi8(x, difundir(c)); }
+inline VecLexer unir(VecLexer a, VecLexer b){ return _mm256_or_si256(a, b); }
+inline VecLexer mascaraO(VecLexer a, char c){ return _mm256_or_si256(a, difundir(c)); }
+inline uint32_t bits(VecLexer m){ return (uint32_t)_mm256_movemask_epi8(m); }
+const uint32_t BITS_LLENOS = 0xFFFFFFFFu;
+#elif defined(__SSE2__) || defined(_M_X64)
+#define LEXER_SIMD "SSE2"
+typedef __m128i VecLexer;
+const size_t ANCHO_SIMD = 16;
+inline VecLexer cargarVec(const char *p){ return _mm_loadu_si128((const __m128i*)p); }
+inline VecLexer difundir(char c){ return _mm_set1_epi8(c); }
+inline VecLexer enRango(VecLexer x, char lo, char hi){
+    return _mm_cmpeq_epi8(_mm_min_epu8(_mm_max_epu8(x, difundir(lo)), difundir(hi)), x);
+}
+inline VecLexer igualA(VecLexer x, char c){ return _mm_cmpeq_epi8(x, difundir(c)); }
+inline VecLexer unir(VecLexer a, VecLexer b){ return _mm_or_si128(a, b); }
+inline VecLexer mascaraO(VecLexer a, char c){ return _mm_or_si128(a, difundir(c)); }
+inline uint32_t bits(VecLexer m){ return (uint32_t)_mm_movemask_epi8(m); }
+const uint32_t BITS_LLENOS = 0xFFFFu;
+#else
+#define LEXER_SIMD "escalar"
+#endif
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#define LEXER_SIMD_ACTIVO 1
+inline int primerBit(uint32_t m){
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long k; _BitScanForward(&k, m); return (int)k;
+#else
+    return __builtin_ctz(m);
+#endif
+}
+#endif
+
+// Los primeros caracteres se revisan con la tabla (casi todos los tokens son
+// cortos y no pagan la carga vectorial); después, bloques completos.
+#ifdef LEXER_SIMD_ACTIVO
+#define RECORRER_SIMD(p, i, n, mascara, pertenece)                       \
+    for (size_t fin = (i) + 4 < (n) ? (i) + 4 : (n); (i) < fin; (i)++)   \
+        if (!(pertenece)) return (i);                                    \
+    while ((i) + ANCHO_SIMD <= (n)) {                                    \
+        VecLexer x = cargarVec((p) + (i));                               \
+        uint32_t fuera = ~bits(mascara) & BITS_LLENOS;                   \
+        if (fuera) return (i) + primerBit(fuera);                        \
+        (i) += ANCHO_SIMD;                                               \
+    }
+#else
+#define RECORRER_SIMD(p, i, n, mascara, pertenece)
+#endif
+
+inline bool esAlfanumerico(char c){
+    uint8_t k = TABLAS_LEXER.clase[(unsigned char)c];
+    return k == CC_LETRA || k == CC_DIGITO;
+}
+
+inline size_t saltarEspacios(const char *p, size_t i, size_t n){
+    RECORRER_SIMD(p, i, n, unir(igualA(x, ' '), enRango(x, '\t', '\r')), TABLAS_LEXER.clase[(unsigned char)p[i]] == CC_ESPACIO)
+    while (i < n && TABLAS_LEXER.clase[(unsigned char)p[i]] == CC_ESPACIO) i++;
+    return i;
+}
+
+inline size_t saltarAlfanumericos(const char *p, size_t i, size_t n){
+    RECORRER_SIMD(p, i, n, unir(enRango(x, '0', '9'), enRango(mascaraO(x, 0x20), 'a', 'z')), esAlfanumerico(p[i]))
+    while (i < n && esAlfanumerico(p[i])) i++;
+    return i;
+}
+
+inline size_t saltarDigitos(const char *p, size_t i, size_t n){
+    RECORRER_SIMD(p, i, n, enRango(x, '0', '9'), TABLAS_LEXER.clase[(unsigned char)p[i]] == CC_DIGITO)
+    while (i < n && TABLAS_LEXER.clase[(unsigned char)p[i]] == CC_DIGITO) i++;
+    return i;
+}
+
+// Cuerpo de cadena: todo hasta la siguiente comilla.
+inline size_t saltarHastaComilla(const char *p, size_t i, size_t n){
+#ifdef LEXER_SIMD_ACTIVO
+    while (i + ANCHO_SIMD <= n) {
+        uint32_t m = bits(igualA(cargarVec(p + i), '"'));
+        if (m) return i + primerBit(m);
+        i += ANCHO_SIMD;
+    }
+#endif
+    const void *q = i < n ? std::memchr(p + i, '"', n - i) : nullptr;
+    return q ? (size_t)((const char*)q - p) : n;
+}
+
+/* ------------------ Palabras reservadas ------------------ */
+inline TokenType clasificarPalabra(const char *p, size_t len){
+    switch (len) {
+        case 2:
+            if (p[0]=='i' && p[1]=='f') return TokenType::RESERVADA_IF;
+            break;
+        case 3:
+            if (p[0]=='i' && p[1]=='n' && p[2]=='t') return TokenType::TIPO_INT;
+            break;
+        case 4:
+            if (std::memcmp(p, "else", 4) == 0) return TokenType::RESERVADA_ELSE;
+            break;
+        case 5:
+            if (p[0]=='w') { if (std::memcmp(p, "while", 5) == 0) return TokenType::RESERVADA_WHILE; }
+            else if (std::memcmp(p, "float", 5) == 0) return TokenType::TIPO_FLOAT;
+            break;
+        case 6:
+            if (std::memcmp(p, "return", 6) == 0) return TokenType::RESERVADA_RETURN;
+            break;
+    }
+    return TokenType::IDENT;
+}
+
+/* ------------------ LEXER RÁPIDO ------------------ */
+class LexerRapido {
+public:
+    explicit LexerRapido(std::string_view src, size_t desde = 0) : p(src.data()), n(src.size()), i(desde) {}
+
+    // Primer byte todavía no consumido.
+    size_t posicion() const { return i; }
+
+    Token next(){
+        i = saltarEspacios(p, i, n);
+        if (i >= n) return {TokenType::FIN, "$", i};
+        size_t start = i;
+        unsigned char c = (unsigned char)p[i];
+        switch (TABLAS_LEXER.clase[c]) {
+            case CC_LETRA: {
+                i = saltarAlfanumericos(p, i + 1, n);
+                return {clasificarPalabra(p + start, i - start), vista(start), start};
+            }
+            case CC_DIGITO: {
+                i = saltarDigitos(p, i + 1, n);
+                if (i + 1 < n && p[i] == '.' && TABLAS_LEXER.clase[(unsigned char)p[i+1]] == CC_DIGITO) {
+                    i = saltarDigitos(p, i + 2, n);
+                    return {TokenType::REAL, vista(start), start};
+                }
+                return {TokenType::ENTERO, vista(start), start};
+            }
+            case CC_COMILLA: {
+                i = saltarHastaComilla(p, i + 1, n);
+                if (i < n) i++; // comilla de cierre
+                return {TokenType::CADENA, vista(start), start};
+            }
+            case CC_SIMPLE:
+                i++;
+                return {(TokenType)TABLAS_LEXER.simple[c], vista(start), start};
+            case CC_IGUAL:
+                if (i + 1 < n && p[i+1] == '=') { i += 2; return {TokenType::OP_IGUALDAD, vista(start), start}; }
+                i++; return {TokenType::OP_ASIG, vista(start), start};
+            case CC_ADMIRACION:
+                if (i + 1 < n && p[i+1] == '=') { i += 2; return {TokenType::OP_IGUALDAD, vista(start), start}; }
+                i++; return {TokenType::OP_NOT, vista(start), start};
+            case CC_MENOR_MAYOR:
+                i += (i + 1 < n && p[i+1] == '=') ? 2 : 1;
+                return {TokenType::OP_RELAC, vista(start), start};
+            case CC_AMPERSAND:
+                if (i + 1 < n && p[i+1] == '&') { i += 2; return {TokenType::OP_AND, vista(start), start}; }
+                break;
+            case CC_BARRA:
+                if (i + 1 < n && p[i+1] == '|') { i += 2; return {TokenType::OP_OR, vista(start), start}; }
+                break;
+            default:
+                break;
+        }
+        i++;
+        return {TokenType::DESCONOCIDO, vista(start), start};
+    }
+
+private:
+    const char *p;
+    size_t n;
+    size_t i;
+
+    std::string_view vista(size_t start) const { return std::string_view(p + start, i - start); }
+};
+
+#endif
@@ -0,0 +1,164 @@
+// lexer_verificar.h
+// Prueba diferencial de los lexers (benchmark --verificar-lexer): LexerRapido,
+// LexerFlujo por bloques y lexerParalelo deben dar token por token lo mismo
+// que Lexer. Con un .lex también se comparan LexerDFA con el autómata
+// construido desde él y, si estaba al compilar, con el de lexer_generado.h.
+#ifndef LEXER_VERIFICAR_H
+#define LEXER_VERIFICAR_H
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "automata_lexico.h"
+#include "flujo.h"
+#include "hilos.h"
+#include "lexer.h"
+#include "lexer_paralelo.h"
+#include "lexer_rapido.h"
+#include "verificacion.h"
+#if !defined(HAY_LEXER_GENERADO) && __has_include("lexer_generado.h") // ./generadorlexico compilador.lex lexer_generado.h
+#include "lexer_generado.h"
+#define HAY_LEXER_GENERADO
+#endif
+
+// Devuelve false (y muestra el primer token distinto) si 'lx' (LexerRapido o
+// LexerDFA) no produce exactamente la misma secuencia que Lexer.
+template<class L>
+bool mismosTokensCon(std::string_view entrada, L lx, const char *motor, const char *nombre){
+    Lexer ref(entrada);
+    for(size_t k=0;;k++){
+        Token a = ref.next(), b = lx.next();
+        if(a.type != b.type || a.lexeme != b.lexeme || a.pos != b.pos){
+            std::fprintf(stderr, "Diferencia en %s, token %zu: referencia (%d,'%.*s',%zu) %s (%d,'%.*s',%zu)\n", nombre, k,
+                         (int)a.type, (int)a.lexeme.size(), a.lexeme.data(), a.pos, motor,
+                         (int)b.type, (int)b.lexeme.size(), b.lexeme.data(), b.pos);
+            return false;
+        }
+        if(a.type == TokenType::FIN) return true;
+    }
+}
+
+inline bool mismosTokens(std::string_view entrada, const char *nombre){
+    return mismosTokensCon(entrada, LexerRapido(entrada), "rápido", nombre);
+}
+
+// Lo mismo para LexerFlujo leyendo de a 'bloque' bytes: los tokens partidos
+// entre bloques deben salir iguales y con la misma posición global.
+inline bool mismosTokensFlujo(std::string_view entrada, size_t bloque, const char *nombre, const AutomataLexico *automata = nullptr){
+#ifdef LRB_MMAP
+    std::string copia(entrada);
+    FILE *f = fmemopen(copia.empty() ? nullptr : copia.data(), copia.size(), "r");
+    if(!f) return copia.empty();
+    LexerFlujo flujo(f, bloque, automata);
+    Lexer ref(entrada);
+    bool ok = true;
+    for(size_t k=0;;k++){
+        Token a = ref.next(), b = flujo.next();
+        if(a.type != b.type || a.lexeme != b.lexeme || a.pos != b.pos){
+            std::fprintf(stderr, "Diferencia en %s (bloque %zu), token %zu: referencia (%d,'%.*s',%zu) flujo (%d,'%.*s',%zu)\n", nombre, bloque, k,
+                         (int)a.type, (int)a.lexeme.size(), a.lexeme.data(), a.pos,
+                         (int)b.type, (int)b.lexeme.size(), b.lexeme.data(), b.pos);
+            ok = false;
+            break;
+        }
+        if(a.type == TokenType::FIN) break;
+    }
+    std::fclose(f);
+    return ok;
+#else
+    (void)entrada; (void)bloque; (void)nombre; (void)automata;
+    return true;
+#endif
+}
+
+// Y para lexerParalelo con cortes en 'trozos' puntos.
+inline bool mismosTokensParalelo(std::string_view entrada, PoolTrabajo &pool, size_t trozos, const char *nombre){
+    TokensParalelos par = lexerParalelo(entrada, pool, trozos);
+    FuenteTokens fuente(par);
+    LexerRapido ref(entrada);
+    for(size_t k=0;;k++){
+        Token a = ref.next();
+        if(k >= par.size()){ std::fprintf(stderr, "Diferencia en %s (%zu trozos): faltan tokens desde %zu\n", nombre, trozos, k); return false; }
+        Token b = fuente.next();
+        if(a.type != b.type || a.lexeme != b.lexeme || a.pos != b.pos){
+            std::fprintf(stderr, "Diferencia en %s (%zu trozos), token %zu: secuencial (%d,'%.*s',%zu) paralelo (%d,'%.*s',%zu)\n", nombre, trozos, k,
+                         (int)a.type, (int)a.lexeme.size(), a.lexeme.data(), a.pos,
+                         (int)b.type, (int)b.lexeme.size(), b.lexeme.data(), b.pos);
+            return false;
+        }
+        if(a.type == TokenType::FIN) return k + 1 == par.size();
+    }
+}
+
+// No usa la gramática: 'rutaLex' puede ser vacía. Cada función de arriba ya
+// muestra su diferencia, así que un caso falla si falla cualquiera de ellas.
+inline int verificarLexer(const std::string &rutaLex){
+    PruebaDiferencial prueba;
+    PoolTrabajo pool(3);
+    TablaLexica lexico;
+    std::vector<std::pair<const char*, AutomataLexico>> automatas;
+    if(!rutaLex.empty()){
+        std::string error;
+        if(!cargarLexico(rutaLex, lexico, error)){ std::fprintf(stderr, "Error: %s\n", error.c_str()); return 1; }
+        reporteLexico(lexico, std::cout);
+        automatas.push_back({"autómata", lexico.vista()});
+#ifdef HAY_LEXER_GENERADO
+        automatas.push_back({"generado", lexer_generado::AUTOMATA});
+#endif
+    }
+    auto caso = [&](std::string_view s, const char *nombre){
+        bool ok = mismosTokens(s, nombre);
+        for(size_t bloque : {1, 2, 3, 7, 64}) ok &= mismosTokensFlujo(s, bloque, nombre);
+        for(size_t trozos : {2, 5, 13}) ok &= mismosTokensParalelo(s, pool, trozos, nombre);
+        for(auto &a : automatas){
+            ok &= mismosTokensCon(s, LexerDFA(a.second, s), a.first, nombre);
+            for(size_t bloque : {1, 3, 64}) ok &= mismosTokensFlujo(s, bloque, nombre, &a.second);
+        }
+        prueba.comprobar(ok, []{});
+    };
+
+    const char *bordes[] = {
+        "", " ", "x", "1", "1.", "1.5", "1..2", "12.a", ".5", "\"", "\"abc", "\"abc\"def\"",
+        "==", "=", "!=", "!", "<=", ">=", "<", ">", "&&", "&", "||", "|", "& &", "a&b|c",
+        "if else while return int float iff elsee whilex returns int1 floaT IF",
+        "\t\n\v\f\r x \x85 \xA0 \xC3\xB1 _a a_b $ @ # \\ \x7F \x01",
+        "int main() { x = 3.14 + \"cadena con espacios\"; return -x; }",
+    };
+    for(const char *b : bordes) caso(b, "borde");
+
+    // Corridas largas para cruzar los bloques SIMD en todas las alineaciones.
+    for(size_t lon : {15, 16, 17, 31, 32, 33, 63, 64, 65, 200}){
+        for(size_t desp=0; desp<34; desp++){
+            std::string pre(desp, ' ');
+            caso(pre + std::string(lon, 'a') + "1;", "identificador largo");
+            caso(pre + std::string(lon, '7') + ".5;", "número largo");
+            caso(pre + "\"" + std::string(lon, 'z') + "\" x", "cadena larga");
+            caso(pre + "\"" + std::string(lon, 'z'), "cadena sin cerrar");
+            caso(pre + std::string(lon, ' ') + "\t\r\n" + std::string(lon, '\v') + "y", "espacios largos");
+        }
+    }
+
+    // Entradas aleatorias con un alfabeto sesgado hacia los tokens.
+    const std::string alfabeto = "abcifwhlesrtunoIFXZ0123456789.\"\"   \n\t+-*/=!<>&|;,(){}@#_\x80\xFF";
+    Azar azar(2463534242u);
+    for(int k=0;k<20000;k++){
+        std::string s(azar() % 120, ' ');
+        for(char &c : s) c = alfabeto[azar() % alfabeto.size()];
+        caso(s, "aleatoria");
+    }
+    std::string sintetica = generarEntrada(1000000);
+    bool ok = mismosTokens(sintetica, "sintética") && mismosTokensFlujo(sintetica, 4093, "sintética") &&
+              mismosTokensParalelo(sintetica, pool, 97, "sintética");
+    for(auto &a : automatas) ok &= mismosTokensCon(sintetica, LexerDFA(a.second, sintetica), a.first, "sintética");
+    prueba.comprobar(ok, []{});
+
+    std::printf("Prueba diferencial de lexers (%s, también por bloques y en paralelo%s): %d casos, %d fallos\n", LEXER_SIMD,
+                automatas.empty() ? "" : automatas.size() > 1 ? "; autómata del .lex y lexer_generado.h" : "; autómata del .lex",
+                prueba.casos, prueba.fallos);
+    return prueba.codigo();
+}
+
+#endif
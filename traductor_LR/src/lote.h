@@ -0,0 +1,72 @@
+// lote.h
+// Modo lote: valida muchos archivos con una sola carga de la gramática. LRGram
+// y su mapeo de terminales son de sólo lectura durante el análisis, así que
+// todos los hilos los comparten sin copias ni bloqueos; cada hilo tiene su
+// propio Arbol, que reutiliza de un archivo al siguiente.
+#ifndef LOTE_H
+#define LOTE_H
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "arbol.h"
+#include "flujo.h"
+#include "gramatica.h"
+#include "hilos.h"
+#include "parser.h"
+
+struct ResultadoLote {
+    Diagnostico diag;
+    size_t nodos = 0;     // sólo si se construyó el árbol
+    bool abierto = true;  // false si el archivo no se pudo abrir
+    bool errorLectura = false; // se abrió pero la lectura falló (p. ej. un directorio): 'diag' cubre sólo lo leído
+};
+
+// Archivos de un directorio (recursivo, en orden lexicográfico) o de una
+// lista con una ruta por línea.
+inline bool rutasLote(const std::string &origen, std::vector<std::string> &rutas){
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    if(fs::is_directory(origen, ec)){
+        for(auto it = fs::recursive_directory_iterator(origen, ec); !ec && it != fs::recursive_directory_iterator(); it.increment(ec))
+            if(it->is_regular_file(ec)) rutas.push_back(it->path().string());
+        std::sort(rutas.begin(), rutas.end());
+        return !ec;
+    }
+    std::ifstream f(origen);
+    if(!f){ std::cerr<<"Error: No se puede abrir la lista de archivos: "<<origen<<"\n"; return false; }
+    std::string linea;
+    while(std::getline(f, linea)){
+        if(!linea.empty() && linea.back() == '\r') linea.pop_back();
+        if(!linea.empty()) rutas.push_back(linea);
+    }
+    return true;
+}
+
+// Analiza cada ruta en el pool; res[i] corresponde a rutas[i] sin importar
+// qué hilo lo procesó ni en qué orden terminaron.
+inline std::vector<ResultadoLote> analizarLote(const LRGram &G, const std::vector<std::string> &rutas, PoolTrabajo &pool, bool conArbol){
+    std::vector<ResultadoLote> res(rutas.size());
+    std::vector<Arbol> arboles(conArbol ? pool.size() : 0);
+    pool.paraCada(rutas.size(), [&](size_t i, unsigned h){
+        std::FILE *f = std::fopen(rutas[i].c_str(), "rb");
+        if(!f){ res[i].abierto = false; return; }
+        LexerFlujo lx(f);
+        if(conArbol){
+            ConstruirArbol cons(arboles[h]);
+            res[i].diag = analizarLR(G, lx, cons);
+            res[i].nodos = arboles[h].nodos.size();
+        } else {
+            SoloReconocer cons;
+            res[i].diag = analizarLR(G, lx, cons);
+        }
+        res[i].errorLectura = lx.errorLectura();
+        std::fclose(f);
+    });
+    return res;
+}
+
+#endif
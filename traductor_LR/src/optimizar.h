@@ -0,0 +1,208 @@
+// optimizar.h
+// Pasadas sobre el árbol de parseLR, cada una un solo recorrido lineal:
+//   - compactarArbol: quita los nodos de producciones vacías (Otro, ListaVar,
+//     Argumentos, ... -> \e) y reduce las cadenas de un solo hijo
+//     (Expresion -> Termino -> entero queda en la hoja entero; Definicion ->
+//     DefVar en DefVar; la cola de una lista en su último elemento);
+//   - plegarConstantes: reemplaza por un literal las expresiones opSuma,
+//     opMul, opRelac y opIgualdad (y el signo y los paréntesis) cuyos
+//     operandos son literales entero o real, con la misma aritmética que la
+//     VM (int de 64 bits modular, mezcla promovida a float). No pliega la
+//     división entera entre cero ni resultados inf/nan.
+// El árbol que queda se recorre con vista_ast.h (semantica.h y bytecode.h lo
+// aceptan igual que el completo). Las dos pasadas recorren los nodos por
+// índice y escriben en el mismo arreglo: sólo necesitan que cada nodo esté
+// después de sus hijos y que los rangos de 'hijos' vayan en el orden de sus
+// padres, que es como quedan con Arbol::hoja/interno (parseLR y el parser
+// paralelo). Así no se reserva memoria para un segundo árbol.
+#ifndef OPTIMIZAR_H
+#define OPTIMIZAR_H
+
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "arbol.h"
+#include "gramatica.h"
+#include "lexer.h"
+
+struct ResultadoOptimizacion {
+    uint64_t nodosAntes = 0, nodosCompactos = 0, nodosDespues = 0; // tamaño de la arena antes y después de cada pasada
+    uint64_t vacios = 0, colapsados = 0, plegados = 0;
+    uint64_t sinTexto = 0; // operadores sin texto en el árbol: no se pudo plegar
+    uint64_t nsCompactar = 0, nsPlegar = 0;
+};
+
+class OptimizadorArbol {
+public:
+    OptimizadorArbol(Arbol &A, const LRGram &G) : A(A) {
+        esExpresion.assign(G.nReglas + 1, false);
+        for (int r = 0; r < G.nReglas; r++) esExpresion[r + 1] = std::strcmp(G.nombreRegla(r), "Expresion") == 0;
+    }
+
+    /* ---- Compactar ---- */
+    // Un nodo sin hijos que queden se descarta y uno con un solo hijo se
+    // reemplaza por él (la raíz se conserva aunque quede vacía).
+    void compactar(ResultadoOptimizacion &r) {
+        auto t0 = std::chrono::steady_clock::now();
+        r.nodosAntes = A.nodos.size();
+        nuevo.assign(A.nodos.size(), (uint32_t)Arbol::NINGUNO);
+        uint32_t w = 0, wh = 0;
+        for (uint32_t k = 0; k < A.nodos.size(); k++) {
+            NodoAst n = A.nodos[k];
+            if (n.esHoja()) { A.nodos[w] = n; nuevo[k] = w++; continue; }
+            uint32_t primero = wh;
+            for (uint32_t i = 0; i < n.nHijos; i++) {
+                uint32_t h = nuevo[A.hijos[n.primerHijo + i]];
+                if (h != Arbol::NINGUNO) A.hijos[wh++] = h;
+            }
+            uint32_t quedan = wh - primero;
+            if (quedan == 0 && k != A.raiz) { r.vacios++; continue; }
+            if (quedan == 1) { r.colapsados++; nuevo[k] = A.hijos[--wh]; continue; }
+            A.nodos[w] = NodoAst{n.simbolo, n.lexema, primero, quedan};
+            nuevo[k] = w++;
+        }
+        terminar(w, wh);
+        r.nodosCompactos = r.nodosDespues = w;
+        r.nsCompactar = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    /* ---- Plegar constantes ---- */
+    // Al llegar a una expresión sus operandos ya están plegados. Si se pliega
+    // y sus hijos son los últimos nodos escritos (postorden, como tras
+    // compactar), se descartan; si no, quedan sin referencias en la arena.
+    void plegar(ResultadoOptimizacion &r) {
+        auto t0 = std::chrono::steady_clock::now();
+        nuevo.assign(A.nodos.size(), (uint32_t)Arbol::NINGUNO);
+        uint32_t w = 0, wh = 0, h[3];
+        for (uint32_t k = 0; k < A.nodos.size(); k++) {
+            NodoAst n = A.nodos[k];
+            if (n.esHoja()) { A.nodos[w] = n; nuevo[k] = w++; continue; }
+            for (uint32_t i = 0; i < n.nHijos && i < 3; i++) h[i] = nuevo[A.hijos[n.primerHijo + i]];
+            NodoAst hoja;
+            if (esExpresion[n.regla()] && (n.nHijos == 2 || n.nHijos == 3) && plegarExpresion(h, n.nHijos, hoja, r)) {
+                if (h[0] + n.nHijos == w && h[n.nHijos - 1] + 1 == w) w -= n.nHijos;
+                A.nodos[w] = hoja;
+                r.plegados++;
+            } else {
+                uint32_t primero = wh;
+                for (uint32_t i = 0; i < n.nHijos; i++) A.hijos[wh++] = nuevo[A.hijos[n.primerHijo + i]];
+                A.nodos[w] = NodoAst{n.simbolo, n.lexema, primero, n.nHijos};
+            }
+            nuevo[k] = w++;
+        }
+        terminar(w, wh);
+        r.nodosDespues = w;
+        r.nsPlegar = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+private:
+    struct Valor { bool real; int64_t i; double f; };
+
+    Arbol &A;
+    std::vector<bool> esExpresion;
+    std::vector<uint32_t> nuevo; // índice de cada nodo viejo en el arreglo ya escrito
+
+    void terminar(uint32_t w, uint32_t wh) {
+        if (A.raiz != Arbol::NINGUNO) A.raiz = nuevo[A.raiz];
+        A.nodos.resize(w);
+        A.hijos.resize(wh);
+    }
+
+    bool literal(const NodoAst &n, Valor &v) const {
+        if (!n.esHoja() || n.lexema == TablaLexemas::NINGUNO) return false;
+        if (n.tipoToken() != TokenType::ENTERO && n.tipoToken() != TokenType::REAL) return false;
+        std::string s(A.lexemas.texto(n.lexema));
+        char *fin = nullptr;
+        errno = 0;
+        v.real = n.tipoToken() == TokenType::REAL;
+        if (v.real) v.f = std::strtod(s.c_str(), &fin);
+        else v.i = std::strtoll(s.c_str(), &fin, 10);
+        return !errno && fin && !*fin; // fuera de rango: lo reporta el compilador
+    }
+    static double real(const Valor &v) { return v.real ? v.f : (double)v.i; }
+
+    NodoAst hojaDe(const Valor &v) {
+        std::string s;
+        if (v.real) {
+            char num[32];
+            std::snprintf(num, sizeof num, "%.17g", v.f);
+            s = num;
+            if (s.find_first_of(".e") == std::string::npos) s += ".0";
+        } else s = std::to_string(v.i);
+        TokenType t = v.real ? TokenType::REAL : TokenType::ENTERO;
+        return NodoAst{-1 - (int32_t)t, A.lexemas.intern(s), 0, 0};
+    }
+
+    // h: hijos (ya escritos) de una Expresion de 2 o 3 hijos.
+    bool plegarExpresion(const uint32_t *h, uint32_t n, NodoAst &hoja, ResultadoOptimizacion &r) {
+        const std::vector<NodoAst> &nodos = A.nodos;
+        const NodoAst &a = nodos[h[0]], &op = nodos[h[n == 2 ? 0 : 1]];
+        Valor x{}, y{}, z{};
+        if (n == 3 && a.esHoja() && a.tipoToken() == TokenType::PARENTESIS_ABRE) { // ( literal )
+            if (!literal(nodos[h[1]], x)) return false;
+            hoja = nodos[h[1]];
+            return true;
+        }
+        if (!op.esHoja()) return false;
+        TokenType t = op.tipoToken();
+        if (t != TokenType::OP_SUMA && t != TokenType::OP_MUL && t != TokenType::OP_RELAC && t != TokenType::OP_IGUALDAD) return false;
+        if (n == 2 ? !literal(nodos[h[1]], x) : !literal(a, x) || !literal(nodos[h[2]], y)) return false;
+        if (op.lexema == TablaLexemas::NINGUNO) { r.sinTexto++; return false; }
+        std::string_view s = A.lexemas.texto(op.lexema);
+        if (n == 2) { // signo
+            if (t != TokenType::OP_SUMA) return false;
+            z = x;
+            if (s == "-") { if (x.real) z.f = -x.f; else z.i = (int64_t)(0 - (uint64_t)x.i); }
+        } else if (t == TokenType::OP_RELAC || t == TokenType::OP_IGUALDAD) {
+            double p = real(x), q = real(y);
+            bool enteros = !x.real && !y.real, c;
+            if (s == "<") c = enteros ? x.i < y.i : p < q;
+            else if (s == "<=") c = enteros ? x.i <= y.i : p <= q;
+            else if (s == ">") c = enteros ? x.i > y.i : p > q;
+            else if (s == ">=") c = enteros ? x.i >= y.i : p >= q;
+            else if (s == "==") c = enteros ? x.i == y.i : p == q;
+            else if (s == "!=") c = enteros ? x.i != y.i : p != q;
+            else return false;
+            z.i = c;
+        } else if (x.real || y.real) {
+            double p = real(x), q = real(y);
+            z.real = true;
+            z.f = s == "+" ? p + q : s == "-" ? p - q : s == "*" ? p * q : p / q;
+            if (!std::isfinite(z.f)) return false;
+        } else {
+            uint64_t p = (uint64_t)x.i, q = (uint64_t)y.i;
+            if (s == "+") z.i = (int64_t)(p + q);
+            else if (s == "-") z.i = (int64_t)(p - q);
+            else if (s == "*") z.i = (int64_t)(p * q);
+            else if (y.i == 0) return false; // la VM reporta el error al ejecutar
+            else z.i = y.i == -1 ? (int64_t)(0 - p) : x.i / y.i;
+        }
+        hoja = hojaDe(z);
+        return true;
+    }
+};
+
+inline void compactarArbol(Arbol &A, const LRGram &G, ResultadoOptimizacion &r) {
+    OptimizadorArbol(A, G).compactar(r);
+}
+
+// Conviene después de compactarArbol: sobre el árbol completo las cadenas
+// Expresion -> Termino -> literal esconden los operandos.
+inline void plegarConstantes(Arbol &A, const LRGram &G, ResultadoOptimizacion &r) {
+    OptimizadorArbol(A, G).plegar(r);
+}
+
+// Las dos pasadas; las cuentas y tiempos de cada una quedan en 'r'.
+inline void optimizarArbol(Arbol &A, const LRGram &G, ResultadoOptimizacion &r) {
+    r = ResultadoOptimizacion();
+    OptimizadorArbol o(A, G);
+    o.compactar(r);
+    o.plegar(r);
+}
+
+#endif
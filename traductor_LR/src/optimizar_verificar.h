@@ -0,0 +1,185 @@
+// optimizar_verificar.h
+// Prueba de la optimización del árbol (benchmark --verificar-optimizacion):
+// el árbol compactado y plegado (optimizar.h) debe dar los mismos errores
+// semánticos que el completo y, si el programa es válido, la misma salida y
+// el mismo resultado en la VM.
+#ifndef OPTIMIZAR_VERIFICAR_H
+#define OPTIMIZAR_VERIFICAR_H
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "bytecode.h"
+#include "generador.h"
+#include "lalr.h"
+#include "optimizar.h"
+#include "parser.h"
+#include "semantica.h"
+#include "verificacion.h"
+#include "vista_ast.h"
+#include "vm.h"
+
+inline bool sinNodosTriviales(const Arbol &A){
+    std::vector<uint32_t> pila;
+    if(A.raiz != Arbol::NINGUNO) pila.push_back(A.raiz);
+    while(!pila.empty()){
+        const NodoAst &n = A[pila.back()];
+        bool raiz = pila.back() == A.raiz;
+        pila.pop_back();
+        if(n.esHoja()) continue;
+        if(n.nHijos < 2 && !raiz) return false;
+        for(uint32_t i=0;i<n.nHijos;i++) pila.push_back(A.hijo(n, i));
+    }
+    return true;
+}
+
+// Expresión constante al azar: literales enteros (algunos cerca de los
+// extremos de int) y reales con todos los operadores que se pliegan.
+inline std::string expresionConstante(Azar &azar, int d){
+    const char *ops[] = {"+", "-", "*", "/", "<", ">", "<=", ">=", "==", "!="};
+    const char *literales[] = {"0", "1", "2", "7", "1000000007", "9223372036854775807", "0.5", "2.5", "100000000000000000000.0", "3.0"};
+    switch(d <= 0 ? 0 : azar() % 5){
+        case 0: return literales[azar() % 10];
+        case 1: return "(" + expresionConstante(azar, d - 1) + ")";
+        case 2: return "-" + expresionConstante(azar, d - 1);
+        default: return expresionConstante(azar, d - 1) + " " + ops[azar() % 10] + " " + expresionConstante(azar, d - 1);
+    }
+}
+
+inline int verificarOptimizacion(ContextoVerificacion &c){
+    const LRGram &G = c.G;
+    GramaticaBNF g;
+    std::string error;
+    if(!leerProducciones(c.rutaInf, g, error)){ std::fprintf(stderr, "Error: %s\n", error.c_str()); return 1; }
+    GeneradorProgramas gen(g);
+    PruebaDiferencial prueba;
+    uint64_t antes = 0, despues = 0, plegados = 0;
+
+    // Errores semánticos: programas generados (casi nunca válidos) y los
+    // de expresiones mezcladas de --verificar-lalr.
+    std::vector<std::string> programas;
+    for(uint32_t s=1;s<=40;s++){
+        OpcionesGenerador op;
+        op.tokens = 3000;
+        op.anidamiento = 1 + s % 6;
+        op.complejidad = 1 + s % 5;
+        op.semilla = s;
+        programas.push_back(gen.generar(op));
+    }
+    Azar azar(2463534242u);
+    for(int k=0;k<40;k++) programas.push_back(programaAleatorio(azar, 12));
+    for(size_t k=0;k<programas.size();k++){
+        Arbol A, B;
+        if(!parseLR(G, programas[k], A, true).aceptada || !parseLR(G, programas[k], B, true).aceptada){
+            prueba.comprobar(false, [&]{ std::fprintf(stderr, "FALLO programa %zu: entrada rechazada\n", k); });
+            continue;
+        }
+        ResultadoOptimizacion opt;
+        optimizarArbol(B, G, opt);
+        antes += opt.nodosAntes; despues += opt.nodosDespues; plegados += opt.plegados;
+        ResultadoSemantico ra, rb;
+        analizarSemantica(A, G, ra);
+        analizarSemantica(B, G, rb);
+        bool triviales = !sinNodosTriviales(B);
+        prueba.comprobar(ra.errores == rb.errores && ra.declaraciones == rb.declaraciones && ra.usos == rb.usos && !triviales, [&]{
+            std::fprintf(stderr, "FALLO programa %zu: %llu errores en el árbol completo, %llu en el optimizado%s\n", k,
+                         (unsigned long long)ra.nErrores, (unsigned long long)rb.nErrores, triviales ? " (quedan nodos vacíos o de un hijo)" : "");
+        });
+    }
+    std::printf("Semántica sobre el árbol optimizado: %zu programas, %llu -> %llu nodos (%.1f%%), %llu expresiones plegadas\n", programas.size(),
+                (unsigned long long)antes, (unsigned long long)despues, 100.0 * despues / std::max<uint64_t>(antes, 1), (unsigned long long)plegados);
+
+    // Ejecución: programas válidos con y sin optimizar.
+    std::vector<std::string> validos = {
+        "int g; float h;\nfloat f(int a, float b) { float c; c = a * b + g; return c; }\n"
+        "int main() { int x; x = 2; h = f(x, 1); print(\"h\", h); while (x > 0) { x = x - 1; } return x; }\n",
+        "int fib(int n) { if (n < 2) return n; return fib(n - 1) + fib(n - 2); }\nint main() { return fib(20); }\n",
+        "int main() { int p, d, primo, total; total = 0; p = 2;\n  while (p < 2000) { primo = 1; d = 2;\n"
+        "    while (d * d <= p && primo) { if (p - p / d * d == 0) primo = 0; d = d + 1; }\n    total = total + primo; p = p + 1; }\n  return total; }\n",
+        "int main() { int i; i = 0; while (i < 2 * 5 + 3) { if (i - (4 - 2 * 2) == 3 * 3 - 2) print(i, 1 / 2, 1.0 / 4); i = i - -1; } return i - 9223372036854775807 - 1; }\n",
+    };
+    for(int k=0;k<300;k++){
+        std::string p = "float main() {\n";
+        for(int j=0;j<4;j++) p += "  print(" + expresionConstante(azar, 1 + k % 5) + ");\n";
+        validos.push_back(p + "  return " + expresionConstante(azar, 1 + k % 4) + ";\n}\n");
+    }
+    uint64_t instrA = 0, instrB = 0;
+    for(size_t k=0;k<validos.size();k++){
+        Arbol A, B;
+        ProgramaBC pa, pb;
+        std::string ea, eb;
+        bool aceptada = parseLR(G, validos[k], A, true).aceptada && parseLR(G, validos[k], B, true).aceptada;
+        ResultadoOptimizacion opt;
+        if(aceptada) optimizarArbol(B, G, opt);
+        ResultadoSemantico sem;
+        if(aceptada) analizarSemantica(B, G, sem);
+        if(!aceptada || !sem.ok() || !compilarBytecode(A, G, pa, ea) || !compilarBytecode(B, G, pb, eb)){
+            prueba.comprobar(false, [&]{
+                std::fprintf(stderr, "FALLO válido %zu: %s\n", k, !aceptada ? "entrada rechazada" : !sem.ok() ? sem.errores[0].c_str() : (ea + eb).c_str());
+            });
+            continue;
+        }
+        MaquinaBC va(pa), vb(pb);
+        std::ostringstream sa, sb;
+        ResultadoVM ra = va.ejecutarContando(sa), rb = vb.ejecutarContando(sb);
+        instrA += ra.instrucciones; instrB += rb.instrucciones;
+        prueba.comprobar(sa.str() == sb.str() && ra.ok == rb.ok && ra.error == rb.error && ra.tipo == rb.tipo && ra.valor.i == rb.valor.i, [&]{
+            std::fprintf(stderr, "FALLO válido %zu: la VM da otro resultado con el árbol optimizado\n%s", k, validos[k].c_str());
+        });
+    }
+    std::printf("VM con el árbol optimizado: %zu programas, %llu -> %llu instrucciones ejecutadas\n", validos.size(),
+                (unsigned long long)instrA, (unsigned long long)instrB);
+
+    // Anidamiento profundo: ambas pasadas son iterativas.
+    {
+        const size_t N = 100000;
+        std::string p = "int main() { return " + std::string(N, '(') + "1" + std::string(N, ')') + " + 1";
+        for(size_t i=0;i<N;i++) p += " + 1";
+        p += "; }\n";
+        Arbol A;
+        ResultadoOptimizacion opt;
+        if(!parseLR(G, p, A, true).aceptada) prueba.fallo([]{ std::fprintf(stderr, "FALLO anidamiento: entrada rechazada\n"); });
+        else {
+            optimizarArbol(A, G, opt);
+            VistaAst v(A, G);
+            v.clasificarReglas();
+            std::vector<uint32_t> defs;
+            v.definiciones(defs);
+            uint32_t bloque = defs.empty() ? Arbol::NINGUNO : v.cuerpoFuncion(defs[0]);
+            std::vector<uint32_t> cuerpo;
+            if(bloque != Arbol::NINGUNO) v.contenido(bloque, cuerpo);
+            uint32_t e = cuerpo.size() == 1 ? v.valorRetorno(cuerpo[0]) : Arbol::NINGUNO;
+            if(e == Arbol::NINGUNO || !v.esToken(e, TokenType::ENTERO) || v.texto(e) != std::to_string(N + 2))
+                prueba.fallo([]{ std::fprintf(stderr, "FALLO anidamiento: la expresión no quedó en un literal\n"); });
+            std::printf("Anidamiento de %zu: %llu -> %llu nodos, compactar %.1f ms, plegar %.1f ms\n", N, (unsigned long long)opt.nodosAntes,
+                        (unsigned long long)opt.nodosDespues, opt.nsCompactar / 1e6, opt.nsPlegar / 1e6);
+        }
+    }
+
+    // Costo: un programa generado grande, y la semántica sobre cada árbol.
+    {
+        OpcionesGenerador op;
+        op.tokens = 2000000;
+        op.semilla = 99;
+        std::string p = gen.generar(op);
+        Arbol A;
+        if(!parseLR(G, p, A, true).aceptada){ std::fprintf(stderr, "FALLO programa grande: entrada rechazada\n"); return 1; }
+        ResultadoSemantico ra, rb;
+        analizarSemantica(A, G, ra);
+        ResultadoOptimizacion opt;
+        optimizarArbol(A, G, opt);
+        analizarSemantica(A, G, rb);
+        std::printf("Programa de %.1f MB: %llu -> %llu nodos (%llu vacíos, %llu de un hijo, %llu plegadas); compactar %.1f ms (%.1f ns/nodo), plegar %.1f ms\n",
+                    p.size() / 1e6, (unsigned long long)opt.nodosAntes, (unsigned long long)opt.nodosDespues, (unsigned long long)opt.vacios,
+                    (unsigned long long)opt.colapsados, (unsigned long long)opt.plegados, opt.nsCompactar / 1e6,
+                    (double)opt.nsCompactar / opt.nodosAntes, opt.nsPlegar / 1e6);
+        std::printf("  semántica: árbol completo %.1f ms, optimizado %.1f ms\n", (ra.nsDeclaraciones + ra.nsCuerpos) / 1e6, (rb.nsDeclaraciones + rb.nsCuerpos) / 1e6);
+        if(ra.errores != rb.errores) prueba.fallo([]{ std::fprintf(stderr, "FALLO programa grande: otros errores semánticos\n"); });
+    }
+    std::printf("Optimización: %d fallos\n", prueba.fallos);
+    return prueba.codigo();
+}
+
+#endif
@@ -0,0 +1,327 @@
+// parser.h
+// Parser LR dirigido por la tabla de LRGram. La clave del .inf de cada tipo
+// de token se resuelve una sola vez (resolverTokens); el ciclo principal
+// sólo indexa G.colToken con el tipo del token.
+#ifndef PARSER_H
+#define PARSER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "arbol.h"
+#include "gramatica.h"
+#include "lexemas.h"
+#include "lexer.h"
+#include "lexer_rapido.h"
+
+static_assert((int)TokenType::FIN < MAX_TIPOS_TOKEN, "MAX_TIPOS_TOKEN es menor que el número de tipos de token");
+
+/* ------------------ Atajos de reducción ------------------ */
+// Después de reducir a A con 'p' debajo, el ciclo empuja goto(p, A) y vuelve
+// a consultar la tabla con el mismo token. Muchas veces la acción es otra
+// reducción que no baja de 'p': una regla unitaria (Termino -> entero y
+// luego Expresion -> Termino) o una vacía (Otro -> \e después de un if sin
+// else, ListaArgumentos -> \e al cerrar una llamada), que a su vez puede
+// habilitar otra. Como sólo dependen de (p, A, token), construirAtajos las
+// simula una vez por terna y guarda las reglas y los estados que quedan
+// sobre 'p'; el ciclo las aplica sin consultar la tabla. El árbol, los
+// diagnósticos (los errores se detectan en el mismo estado) y el orden de
+// las llamadas al Constructor son los mismos que paso a paso. Ahorran
+// vueltas del ciclo pero no tiempo medido de forma consistente (la
+// búsqueda de la cadena cuesta casi lo mismo que la consulta), así que no
+// se arman solos: hay que llamar a construirAtajos (traductor --atajos).
+const int ATAJO_MAX_REGLAS = 8;
+
+inline void construirAtajos(LRGram &G){
+    G.filaAtajo.clear();
+    G.atajo.clear();
+    G.cadenaAtajo.assign(1, 0); // el desplazamiento 0 es "sin atajo"
+    int nNoTerm = G.nCols - G.nColsTerm;
+    if(G.nFilas > INT16_MAX || G.nReglas > INT16_MAX) return; // las cadenas guardan estados y reglas en 16 bits
+    for(int r=0;r<G.nReglas;r++)
+        if(G.idRegla[r] < G.nColsTerm || G.idRegla[r] >= G.nCols || G.lonRegla[r] < 0) return; // el ciclo reporta el error
+    G.filaAtajo.assign((size_t)G.nFilas * nNoTerm, -1);
+    std::map<std::vector<int16_t>, uint16_t> cadenas;
+    std::map<std::vector<uint16_t>, int16_t> filas;
+    std::vector<int> pila;
+    std::vector<int16_t> cadena;
+    std::vector<uint16_t> fila(G.nColsTerm);
+    for(int p=0;p<G.nFilas;p++){
+        for(int nt=0;nt<nNoTerm;nt++){
+            int v = G.accion(p, G.nColsTerm + nt);
+            if(v <= 0) continue;
+            bool alguna = false;
+            for(int col=0;col<G.nColsTerm;col++){
+                pila.assign({p, v});
+                cadena.assign(1, 0);
+                for(int paso=0;paso<ATAJO_MAX_REGLAS;paso++){
+                    int a = G.accion(pila.back(), col);
+                    if(a >= -1) break; // desplazar, aceptar o error: lo resuelve el ciclo
+                    int r = -a - 1;
+                    if(r < 1 || r > G.nReglas || (size_t)G.lonRegla[r-1] >= pila.size()) break; // bajaría de 'p'
+                    int g = G.accion(pila[pila.size() - 1 - G.lonRegla[r-1]], G.idRegla[r-1]);
+                    if(g <= 0) break;
+                    cadena.push_back(r);
+                    cadena.push_back(pila.back());
+                    cadena[0]++;
+                    pila.resize(pila.size() - G.lonRegla[r-1]);
+                    pila.push_back(g);
+                }
+                fila[col] = 0;
+                if(!cadena[0]) continue;
+                cadena.push_back((int16_t)(pila.size() - 1));
+                cadena.insert(cadena.end(), pila.begin() + 1, pila.end());
+                if(G.cadenaAtajo.size() + cadena.size() > UINT16_MAX){ G.filaAtajo.clear(); G.atajo.clear(); return; }
+                auto it = cadenas.emplace(cadena, (uint16_t)G.cadenaAtajo.size()).first;
+                if(it->second == G.cadenaAtajo.size()) G.cadenaAtajo.insert(G.cadenaAtajo.end(), cadena.begin(), cadena.end());
+                fila[col] = it->second;
+                alguna = true;
+            }
+            if(!alguna) continue;
+            if(filas.size() >= INT16_MAX){ G.filaAtajo.clear(); G.atajo.clear(); return; }
+            auto it = filas.emplace(fila, (int16_t)filas.size()).first;
+            if((size_t)it->second * G.nColsTerm == G.atajo.size()) G.atajo.insert(G.atajo.end(), fila.begin(), fila.end());
+            G.filaAtajo[(size_t)p * nNoTerm + nt] = it->second;
+        }
+    }
+    if(G.atajo.empty()) G.filaAtajo.clear();
+}
+
+inline void reporteAtajos(const LRGram &G, std::ostream &os){
+    if(G.filaAtajo.empty()){ os << "Atajos: ninguno\n"; return; }
+    size_t entradas = 0, reglas = 0, maximo = 0;
+    for(uint16_t ini : G.atajo){
+        if(!ini) continue;
+        size_t n = (size_t)G.cadenaAtajo[ini];
+        entradas++;
+        reglas += n;
+        maximo = std::max(maximo, n);
+    }
+    size_t bytes = G.filaAtajo.size()*sizeof(int16_t) + G.atajo.size()*sizeof(uint16_t) + G.cadenaAtajo.size()*sizeof(int16_t);
+    os << "Atajos: " << G.atajo.size() / G.nColsTerm << " filas distintas, " << entradas << " entradas (goto, token) con cadena, "
+       << (entradas ? (double)reglas / entradas : 0.0) << " reducciones por cadena (máximo " << maximo << "), " << bytes << " bytes\n";
+}
+
+inline void resolverTokens(LRGram &G){
+    for(int t=0;t<MAX_TIPOS_TOKEN;t++)
+        G.colToken[t] = t <= (int)TokenType::FIN ? (int16_t)G.columnaTerminal(tokenToKey((TokenType)t)) : -1;
+}
+
+// Huella de todo lo que determina el comportamiento del parser: acciones
+// (tal como las entrega accion(), defectos incluidos), reglas y mapeo de
+// tokens. Un parser generado (generarparser.cpp) la lleva grabada para
+// saber si corresponde a la tabla cargada. Requiere resolverTokens().
+inline uint32_t huellaGramatica(const LRGram &G){
+    std::vector<int32_t> v = {G.nReglas, G.nFilas, G.nCols};
+    for(int r=0;r<G.nReglas;r++){ v.push_back(G.idRegla[r]); v.push_back(G.lonRegla[r]); }
+    for(int e=0;e<G.nFilas;e++)
+        for(int c=0;c<G.nCols;c++) v.push_back(G.accion(e, c));
+    for(int t=0;t<=(int)TokenType::FIN;t++) v.push_back(G.colToken[t]);
+    std::string nombres;
+    for(int r=0;r<G.nReglas;r++){ nombres += G.nombreRegla(r); nombres += '\0'; }
+    uint32_t h = fnv1a((const unsigned char*)v.data(), v.size()*sizeof(int32_t));
+    return h ^ fnv1a((const unsigned char*)nombres.data(), nombres.size()) * 31u;
+}
+
+/* ------------------ Diagnóstico ------------------ */
+// Resultado de un análisis. En caso de error 'mensaje' trae el mismo texto
+// que el traductor imprime en stderr y 'pos' la posición del token.
+struct Diagnostico {
+    bool aceptada = false;
+    size_t pos = 0;
+    std::string mensaje;
+};
+
+/* ------------------ Constructores ------------------ */
+// El ciclo LR avisa a su Constructor de cada SHIFT/REDUCE/ACCEPT. Con
+// SoloReconocer las llamadas son vacías y el compilador las elimina: sólo
+// queda la pila de estados.
+struct ConstruirArbol {
+    Arbol &arbol;
+    std::vector<uint32_t> pila; // índices de nodos en 'arbol'
+    bool operadores;            // también guarda el texto de opSuma, opMul, opRelac y opIgualdad (bytecode.h)
+
+    explicit ConstruirArbol(Arbol &a, bool operadores = false) : arbol(a), operadores(operadores) { arbol.limpiar(); pila.reserve(256); }
+
+    void desplazar(const Token &tk){
+        uint32_t lex = TablaLexemas::NINGUNO;
+        if(tk.type==TokenType::IDENT || tk.type==TokenType::ENTERO || tk.type==TokenType::REAL || tk.type==TokenType::CADENA){
+            lex = arbol.lexemas.intern(tk.lexeme);
+        } else if(operadores && (tk.type==TokenType::OP_SUMA || tk.type==TokenType::OP_MUL || tk.type==TokenType::OP_RELAC || tk.type==TokenType::OP_IGUALDAD)){
+            lex = arbol.lexemas.intern(tk.lexeme);
+        }
+        pila.push_back(arbol.hoja(tk.type, lex));
+    }
+    void reducir(int regla, int lon){
+        size_t base = pila.size() - lon;
+        uint32_t padre = arbol.interno(regla, pila.data() + base, lon);
+        pila.resize(base);
+        pila.push_back(padre);
+    }
+    void aceptar(){ arbol.raiz = pila.empty() ? Arbol::NINGUNO : pila.back(); }
+};
+
+struct SoloReconocer {
+    void desplazar(const Token&){}
+    void reducir(int, int){}
+    void aceptar(){}
+};
+
+/* ------------------ Estadísticas ------------------ */
+// Política de instrumentación del ciclo LR. Con SinEstadisticas (la que se
+// usa por omisión) los bloques 'if constexpr' desaparecen y el ciclo es el
+// mismo que sin instrumentar; EstadisticasLR (estadisticas.h) cuenta y mide.
+struct SinEstadisticas {
+    static constexpr bool activo = false;
+};
+
+/* ------------------ Parser LR ------------------ */
+// 'lx' es cualquier fuente de tokens con next(): LexerRapido sobre la entrada
+// completa o LexerFlujo (flujo.h) sobre stdin por bloques.
+template<class Constructor, class Fuente, class Estadisticas>
+Diagnostico analizarLR(const LRGram &G, Fuente &lx, Constructor &cons, Estadisticas &est){
+    std::vector<int> estados;
+    estados.reserve(256);
+    estados.push_back(0); // Estado inicial
+    Diagnostico d;
+    auto error = [&d](size_t pos, auto&&... partes){
+        std::ostringstream os;
+        (os << ... << partes);
+        d.pos = pos;
+        d.mensaje = os.str();
+        return d;
+    };
+    auto siguiente = [&]{
+        if constexpr(Estadisticas::activo){
+            uint64_t t0 = est.reloj();
+            Token t = lx.next();
+            est.tLexer += est.reloj() - t0;
+            est.tokensPorTipo[(int)t.type]++;
+            return t;
+        } else return lx.next();
+    };
+    auto consultar = [&](int estado, int col){
+        if constexpr(Estadisticas::activo){
+            uint64_t t0 = est.reloj();
+            int a = G.accion(estado, col);
+            est.tTabla += est.reloj() - t0;
+            return a;
+        } else return G.accion(estado, col);
+    };
+
+    Token tk = siguiente();
+    while(true){
+        // Manejo de errores léxicos antes del parsing
+        if (tk.type == TokenType::DESCONOCIDO) {
+            return error(tk.pos, "Error léxico: Carácter desconocido '", tk.lexeme, "' en posición ", tk.pos);
+        }
+
+        int col = G.colToken[(int)tk.type];
+        if(col < 0){
+            return error(tk.pos, "Error sintáctico: Token '", tokenToKey(tk.type), "' (lexeme='", tk.lexeme, "') en posición ", tk.pos,
+                         " no tiene mapeo en el archivo .inf. Esto puede indicar un token inesperado o una configuración incorrecta.");
+        }
+        int estado = estados.back();
+        int accion = consultar(estado, col);
+
+        if(accion > 0){ // Shift (Desplazamiento)
+            estados.push_back(accion);
+            if constexpr(Estadisticas::activo){
+                est.desplazamientosPorEstado[estado]++;
+                est.profundidadMax = std::max(est.profundidadMax, estados.size());
+                uint64_t t0 = est.reloj();
+                cons.desplazar(tk);
+                est.tArbol += est.reloj() - t0;
+            } else cons.desplazar(tk); // nodo hoja para el token desplazado
+            tk = siguiente();     // Leer el siguiente token
+        } else if(accion == -1){ // Aceptación
+            cons.aceptar();
+            d.aceptada = true;
+            return d;
+        } else if(accion < 0){ // Reduce (Reducción)
+            int regla = -accion - 1;
+            if(regla <=0 || regla > G.nReglas){
+                return error(tk.pos, "Error sintáctico: Regla inválida ", regla, " en estado ", estado, " con token '", tokenToKey(tk.type), "'");
+            }
+            int lon = G.lonRegla[regla-1];
+            if(estados.size() <= (size_t)lon){
+                return error(tk.pos, "Error interno del parser: Pila vacía durante reducción de la regla ", regla);
+            }
+            estados.resize(estados.size() - lon);
+            int estadoPrev = estados.back();
+            int idNoTerm = G.idRegla[regla-1];
+            int gotoEstado = consultar(estadoPrev, idNoTerm);
+            if(gotoEstado==0){
+                return error(tk.pos, "Error sintáctico: Goto inválido (0) después de reducción de la regla ", G.nombreRegla(regla-1),
+                             " en estado ", estadoPrev, " con no-terminal ", idNoTerm);
+            }
+            estados.push_back(gotoEstado);
+            if constexpr(Estadisticas::activo){
+                est.reduccionesPorEstado[estado]++;
+                est.reduccionesPorRegla[regla-1]++;
+                est.profundidadMax = std::max(est.profundidadMax, estados.size());
+                uint64_t t0 = est.reloj();
+                cons.reducir(regla, lon);
+                est.tArbol += est.reloj() - t0;
+            } else cons.reducir(regla, lon); // nodo padre para la regla reducida
+            // Reducciones que siguen sin leer otro token (construirAtajos).
+            if(!G.filaAtajo.empty()){
+                int fila = G.filaAtajo[(size_t)estadoPrev * (G.nCols - G.nColsTerm) + idNoTerm - G.nColsTerm];
+                uint16_t ini = fila < 0 ? 0 : G.atajo[(size_t)fila * G.nColsTerm + col];
+                if(ini){
+                    const int16_t *c = &G.cadenaAtajo[ini];
+                    int n = *c++;
+                    for(int i=0;i<n;i++, c += 2){
+                        if constexpr(Estadisticas::activo){
+                            est.reduccionesPorEstado[c[1]]++;
+                            est.reduccionesPorRegla[c[0]-1]++;
+                            uint64_t t0 = est.reloj();
+                            cons.reducir(c[0], G.lonRegla[c[0]-1]);
+                            est.tArbol += est.reloj() - t0;
+                        } else cons.reducir(c[0], G.lonRegla[c[0]-1]);
+                    }
+                    int m = *c++;
+                    estados.pop_back();
+                    estados.insert(estados.end(), c, c + m);
+                    if constexpr(Estadisticas::activo){
+                        est.atajos++;
+                        est.reduccionesEnAtajos += n;
+                        est.profundidadMax = std::max(est.profundidadMax, estados.size());
+                    }
+                }
+            }
+        } else { // 0 = Error sintáctico
+            return error(tk.pos, "Error sintáctico: No se esperaba el token '", tokenToKey(tk.type), "' (lexeme='", tk.lexeme,
+                         "') en estado ", estado, " en la posición ", tk.pos, ".");
+        }
+    }
+}
+
+template<class Constructor, class Fuente>
+Diagnostico analizarLR(const LRGram &G, Fuente &lx, Constructor &cons){
+    SinEstadisticas est;
+    return analizarLR(G, lx, cons, est);
+}
+
+// Análisis completo: si la entrada es aceptada, arbol.raiz es la raíz del
+// árbol sintáctico. 'arbol' se limpia al empezar. Con 'operadores' las hojas
+// de los operadores con más de una forma guardan su texto (+ o -, ...).
+inline Diagnostico parseLR(const LRGram &G, std::string_view entrada, Arbol &arbol, bool operadores = false){
+    ConstruirArbol cons(arbol, operadores);
+    LexerRapido lx(entrada);
+    return analizarLR(G, lx, cons);
+}
+
+// Sólo aceptar/rechazar: misma pila de estados y mismos diagnósticos que
+// parseLR, sin reservar ni un nodo.
+inline Diagnostico reconocerLR(const LRGram &G, std::string_view entrada){
+    SoloReconocer cons;
+    LexerRapido lx(entrada);
+    return analizarLR(G, lx, cons);
+}
+
+#endif
@@ -0,0 +1,235 @@
+// parser_paralelo.h
+// Análisis sintáctico en paralelo por definiciones de primer nivel.
+// <programa> ::= <Definiciones> es una secuencia plana de DefVar/DefFunc, y
+// cada definición se reduce igual sin importar qué hay antes o después
+// (sólo mira 'tipo' o '$' como siguiente token). Entonces:
+//   1. se lexa la entrada en paralelo (lexer_paralelo.h);
+//   2. por segmento de tokens se calcula el saldo de llaves; la suma prefija
+//      da la profundidad al inicio de cada segmento y, en una segunda pasada
+//      paralela, cada segmento marca los finales de definición: ';' a
+//      profundidad 0 (DefVar) o '}' que vuelve a 0 (DefFunc). Cada
+//      definición debe empezar con 'tipo identificador';
+//   3. las definiciones se agrupan en tramos de tamaño parecido y cada tramo
+//      se analiza como un programa independiente con las mismas tablas;
+//   4. de cada subárbol se copian los nodos de sus Definicion (son un
+//      prefijo de su arena) y al final se arma la cadena
+//      Definiciones -> Definicion Definiciones ... -> \e y la raíz.
+// Las reducciones de la cadena y el internado de lexemas se hacen en el
+// mismo orden que el análisis secuencial, así que la arena resultante
+// (nodos, hijos e ids de lexema) es idéntica a la de parseLR. Ante cualquier
+// irregularidad (error léxico o sintáctico, llaves desbalanceadas, algo que
+// no es una definición) se analiza de forma secuencial, que da los mismos
+// diagnósticos de siempre. Con 'operadores' los tramos y la vuelta al
+// secuencial guardan el texto de los operadores, como parseLR.
+// Compilar con -pthread.
+#ifndef PARSER_PARALELO_H
+#define PARSER_PARALELO_H
+
+#include <algorithm>
+#include <string_view>
+#include <vector>
+#include "arbol.h"
+#include "gramatica.h"
+#include "hilos.h"
+#include "lexer.h"
+#include "lexer_paralelo.h"
+#include "parser.h"
+
+// Tokens [ini, fin) de un TokensParalelos (índices globales) seguidos de FIN.
+class FuenteRango {
+public:
+    FuenteRango(const TokensParalelos &t, const std::vector<size_t> &base, size_t ini, size_t fin)
+        : partes(t.partes), g(ini), fin(fin), tkFin(t.partes.back().back()) {
+        k = std::upper_bound(base.begin(), base.end(), ini) - base.begin() - 1;
+        i = ini - base[k];
+    }
+    Token next() {
+        if (g >= fin) return tkFin;
+        while (i == partes[k].size()) { k++; i = 0; }
+        g++;
+        return partes[k][i++];
+    }
+private:
+    const std::vector<std::vector<Token>> &partes;
+    size_t k, i, g, fin;
+    Token tkFin;
+};
+
+// Finales (índice global del token siguiente) de las definiciones de primer
+// nivel, en orden. Vacío si la entrada no tiene la forma esperada.
+inline std::vector<size_t> finalesDefiniciones(const TokensParalelos &tp, const std::vector<size_t> &base, PoolTrabajo &pool){
+    size_t P = tp.partes.size();
+    std::vector<long> saldo(P), minimo(P);
+    std::vector<char> raro(P, 0);
+    pool.paraCada(P, [&](size_t k, unsigned){
+        long d = 0, m = 0;
+        for (const Token &t : tp.partes[k]) {
+            if (t.type == TokenType::LLAVE_ABRE) d++;
+            else if (t.type == TokenType::LLAVE_CIERRA) m = std::min(m, --d);
+            else if (t.type == TokenType::DESCONOCIDO) raro[k] = 1;
+        }
+        saldo[k] = d;
+        minimo[k] = m;
+    });
+    std::vector<long> inicial(P);
+    long d = 0;
+    for (size_t k = 0; k < P; k++) {
+        if (raro[k] || d + minimo[k] < 0) return {};
+        inicial[k] = d;
+        d += saldo[k];
+    }
+    if (d != 0) return {};
+
+    std::vector<std::vector<size_t>> finales(P);
+    pool.paraCada(P, [&](size_t k, unsigned){
+        long p = inicial[k];
+        const std::vector<Token> &v = tp.partes[k];
+        for (size_t j = 0; j < v.size(); j++) {
+            TokenType t = v[j].type;
+            if (t == TokenType::LLAVE_ABRE) p++;
+            else if (t == TokenType::LLAVE_CIERRA) { if (--p == 0) finales[k].push_back(base[k] + j + 1); }
+            else if (t == TokenType::PUNTO_Y_COMA && p == 0) finales[k].push_back(base[k] + j + 1);
+        }
+    });
+    std::vector<size_t> r;
+    for (auto &f : finales) r.insert(r.end(), f.begin(), f.end());
+
+    // Cada definición empieza con 'tipo identificador' y tras la última sólo
+    // queda FIN.
+    size_t total = base.back(), anterior = 0;
+    if (r.empty() || r.back() != total - 1) return {};
+    for (size_t f : r) {
+        FuenteRango c(tp, base, anterior, f);
+        Token a = c.next(), b = c.next();
+        if ((a.type != TokenType::TIPO_INT && a.type != TokenType::TIPO_FLOAT) || b.type != TokenType::IDENT) return {};
+        anterior = f;
+    }
+    return r;
+}
+
+// Índice global del primer token de cada parte (y el total al final).
+inline std::vector<size_t> basesPartes(const TokensParalelos &tp){
+    std::vector<size_t> base(tp.partes.size() + 1, 0);
+    for (size_t k = 0; k < tp.partes.size(); k++) base[k+1] = base[k] + tp.partes[k].size();
+    return base;
+}
+
+// Tramos de definiciones consecutivas con una cantidad de tokens parecida:
+// corteTramo[t] y primeraDef[t] son el token y la definición donde empieza
+// el tramo t; el último elemento de cada uno cierra el último tramo.
+inline void tramosDefiniciones(const std::vector<size_t> &finales, size_t totalTokens, unsigned hilos,
+                               std::vector<size_t> &corteTramo, std::vector<size_t> &primeraDef){
+    size_t nTramos = std::min(finales.size(), (size_t)hilos * 4);
+    size_t objetivo = totalTokens / nTramos + 1;
+    corteTramo.assign(1, 0);
+    primeraDef.assign(1, 0);
+    for (size_t d = 0; d + 1 < finales.size(); d++)
+        if (finales[d] - corteTramo.back() >= objetivo) { corteTramo.push_back(finales[d]); primeraDef.push_back(d + 1); }
+    corteTramo.push_back(finales.back());
+    primeraDef.push_back(finales.size());
+}
+
+inline Diagnostico parseLRParalelo(const LRGram &G, std::string_view entrada, Arbol &arbol, PoolTrabajo &pool, bool operadores = false){
+    TokensParalelos tp = lexerParalelo(entrada, pool);
+    std::vector<size_t> base = basesPartes(tp);
+    std::vector<size_t> finales = finalesDefiniciones(tp, base, pool);
+    if (finales.size() < 2) return parseLR(G, entrada, arbol, operadores);
+
+    std::vector<size_t> corteTramo, primeraDef;
+    tramosDefiniciones(finales, base.back(), pool.size(), corteTramo, primeraDef);
+    size_t T = corteTramo.size() - 1;
+
+    std::vector<Arbol> sub(T);
+    std::vector<char> aceptado(T, 0);
+    pool.paraCada(T, [&](size_t t, unsigned){
+        FuenteRango lx(tp, base, corteTramo[t], corteTramo[t+1]);
+        ConstruirArbol cons(sub[t], operadores);
+        aceptado[t] = analizarLR(G, lx, cons).aceptada;
+    });
+    if (std::count(aceptado.begin(), aceptado.end(), 0)) return parseLR(G, entrada, arbol, operadores);
+
+    // Raíz de cada Definicion, recorriendo la cadena de Definiciones de cada
+    // subárbol; los nodos de la cadena deben ser los últimos de su arena.
+    int reglaPrograma = sub[0][sub[0].raiz].regla();
+    int reglaVacia = 0, reglaLista = 0;
+    std::vector<std::vector<uint32_t>> raices(T);
+    std::vector<size_t> nNodos(T), nHijos(T);
+    for (size_t t = 0; t < T; t++) {
+        const Arbol &A = sub[t];
+        size_t m = primeraDef[t+1] - primeraDef[t];
+        nNodos[t] = A.nodos.size() - (m + 2);
+        nHijos[t] = A.hijos.size() - (2 * m + 1);
+        uint32_t k = A.hijo(A[A.raiz], 0);
+        while (A[k].nHijos == 2) {
+            if (k < nNodos[t]) return parseLR(G, entrada, arbol, operadores);
+            reglaLista = A[k].regla();
+            raices[t].push_back(A.hijo(A[k], 0));
+            k = A.hijo(A[k], 1);
+        }
+        reglaVacia = A[k].regla();
+        if (k < nNodos[t] || raices[t].size() != m || A[k].nHijos != 0 || A.raiz + 1 != A.nodos.size()) return parseLR(G, entrada, arbol, operadores);
+    }
+
+    // Lexemas en el orden de su primera aparición, como en el secuencial.
+    arbol.limpiar();
+    std::vector<std::vector<uint32_t>> remapeo(T);
+    for (size_t t = 0; t < T; t++) {
+        remapeo[t].resize(sub[t].lexemas.size());
+        for (uint32_t j = 0; j < remapeo[t].size(); j++) remapeo[t][j] = arbol.lexemas.intern(sub[t].lexemas.texto(j));
+    }
+    std::vector<size_t> desNodos(T + 1, 0), desHijos(T + 1, 0);
+    for (size_t t = 0; t < T; t++) { desNodos[t+1] = desNodos[t] + nNodos[t]; desHijos[t+1] = desHijos[t] + nHijos[t]; }
+    arbol.nodos.resize(desNodos[T]);
+    arbol.hijos.resize(desHijos[T]);
+    pool.paraCada(T, [&](size_t t, unsigned){
+        const Arbol &A = sub[t];
+        uint32_t dn = (uint32_t)desNodos[t], dh = (uint32_t)desHijos[t];
+        for (size_t k = 0; k < nNodos[t]; k++) {
+            NodoAst n = A.nodos[k];
+            if (n.lexema != TablaLexemas::NINGUNO) n.lexema = remapeo[t][n.lexema];
+            if (!n.esHoja()) n.primerHijo += dh; // las hojas quedan en 0, como en Arbol::hoja
+            arbol.nodos[dn + k] = n;
+        }
+        for (size_t k = 0; k < nHijos[t]; k++) arbol.hijos[dh + k] = A.hijos[k] + dn;
+    });
+
+    // Cadena de Definiciones, de la más interna a la raíz.
+    uint32_t resto = arbol.interno(reglaVacia, nullptr, 0);
+    for (size_t t = T; t-- > 0;) {
+        for (size_t j = raices[t].size(); j-- > 0;) {
+            uint32_t h[2] = {raices[t][j] + (uint32_t)desNodos[t], resto};
+            resto = arbol.interno(reglaLista, h, 2);
+        }
+    }
+    arbol.raiz = arbol.interno(reglaPrograma, &resto, 1);
+    Diagnostico d;
+    d.aceptada = true;
+    return d;
+}
+
+// Sólo aceptar/rechazar (--check --paralelo): mismos tramos, sin árbol.
+// <Definiciones> es una lista, así que si cada tramo se acepta como programa
+// la entrada completa también; si alguno se rechaza se reconoce de forma
+// secuencial para dar el diagnóstico de siempre.
+inline Diagnostico reconocerLRParalelo(const LRGram &G, std::string_view entrada, PoolTrabajo &pool){
+    TokensParalelos tp = lexerParalelo(entrada, pool);
+    std::vector<size_t> base = basesPartes(tp);
+    std::vector<size_t> finales = finalesDefiniciones(tp, base, pool);
+    if (finales.size() < 2) return reconocerLR(G, entrada);
+
+    std::vector<size_t> corteTramo, primeraDef;
+    tramosDefiniciones(finales, base.back(), pool.size(), corteTramo, primeraDef);
+    size_t T = corteTramo.size() - 1;
+    std::vector<char> aceptado(T, 0);
+    pool.paraCada(T, [&](size_t t, unsigned){
+        FuenteRango lx(tp, base, corteTramo[t], corteTramo[t+1]);
+        SoloReconocer cons;
+        aceptado[t] = analizarLR(G, lx, cons).aceptada;
+    });
+    if (std::count(aceptado.begin(), aceptado.end(), 0)) return reconocerLR(G, entrada);
+    Diagnostico d;
+    d.aceptada = true;
+    return d;
+}
+
+#endif
@@ -0,0 +1,126 @@
+// parser_verificar.h
+// Pruebas diferenciales del ciclo de parser.h:
+//   - benchmark --verificar-atajos: con y sin los atajos de construirAtajos
+//     el ciclo debe dar la misma arena y el mismo diagnóstico, también en
+//     entradas con errores; además, pasos por token y tiempo de cada uno;
+//   - benchmark --verificar-directo: el parser generado (parser_generado.h,
+//     de generarparser) debe coincidir con analizarLR sobre la misma tabla en
+//     todo: aceptación, árbol, posición y texto de cada error.
+#ifndef PARSER_VERIFICAR_H
+#define PARSER_VERIFICAR_H
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "estadisticas.h"
+#include "generador.h"
+#include "lalr.h"
+#include "lexer_rapido.h"
+#include "parser.h"
+#include "verificacion.h"
+#if !defined(HAY_PARSER_DIRECTO) && __has_include("parser_generado.h") // ./generarparser compilador.lr compilador.inf parser_generado.h
+#include "parser_generado.h"
+#define HAY_PARSER_DIRECTO
+#endif
+
+/* ------------------ Atajos de reducción ------------------ */
+inline int verificarAtajos(ContextoVerificacion &c){
+    LRGram &G = c.G;
+    GramaticaBNF g;
+    std::string error;
+    if(!leerProducciones(c.rutaInf, g, error)){ std::fprintf(stderr, "Error: %s\n", error.c_str()); return 1; }
+    GeneradorProgramas gen(g);
+    construirAtajos(G);
+    std::vector<int16_t> filas = G.filaAtajo;
+    auto conAtajos = [&](bool si){ if(si) G.filaAtajo = filas; else G.filaAtajo.clear(); };
+
+    std::vector<std::string> entradas;
+    Azar azar(88172645u);
+    for(uint32_t s=1;s<=30;s++){
+        OpcionesGenerador op;
+        op.tokens = 2000;
+        op.anidamiento = 1 + s % 6;
+        op.complejidad = 1 + s % 5;
+        op.semilla = s;
+        entradas.push_back(gen.generar(op));
+        entradas.push_back(programaAleatorio(azar, 8));
+    }
+    // Errores: se borra o se duplica un trozo al azar de cada programa.
+    for(size_t k=0, n=entradas.size();k<n;k++){
+        std::string e = entradas[k];
+        uint32_t x = azar();
+        size_t i = x % e.size(), largo = 1 + x % 7;
+        entradas.push_back(k % 2 ? e.erase(i, largo) : e.insert(i, e.substr(i, largo)));
+    }
+    PruebaDiferencial prueba;
+    int rechazadas = 0;
+    for(size_t k=0;k<entradas.size();k++){
+        Arbol a, b;
+        conAtajos(false);
+        Diagnostico da = parseLR(G, entradas[k], a), ra = reconocerLR(G, entradas[k]);
+        conAtajos(true);
+        Diagnostico db = parseLR(G, entradas[k], b), rb = reconocerLR(G, entradas[k]);
+        rechazadas += !da.aceptada;
+        prueba.comprobar(da.aceptada == db.aceptada && da.mensaje == db.mensaje && ra.mensaje == rb.mensaje && (!da.aceptada || mismaArena(a, b)), [&]{
+            std::fprintf(stderr, "FALLO entrada %zu: %s / %s\n", k, da.mensaje.c_str(), db.mensaje.c_str());
+        });
+    }
+    std::printf("Atajos de reducción: %d entradas (%d con error), %d fallos\n", prueba.casos, rechazadas, prueba.fallos);
+    reporteAtajos(G, std::cout);
+
+    // Pasos del ciclo y tiempo con un programa generado grande.
+    OpcionesGenerador op;
+    op.tokens = 2000000;
+    op.semilla = 7;
+    std::string p = gen.generar(op);
+    for(bool si : {false, true}){
+        conAtajos(si);
+        EstadisticasLR est(G);
+        SoloReconocer nada;
+        LexerRapido lx(p);
+        analizarLR(G, lx, nada, est);
+        Arbol arbol;
+        double segReconocer = mejorTiempo(5, [&]{ reconocerLR(G, p); });
+        double segParse = mejorTiempo(5, [&]{ parseLR(G, p, arbol); });
+        std::printf("  %-12s %8.3f pasos/token (%llu reducciones, %llu en atajos)  reconocerLR %6.1f ms  parseLR %6.1f ms\n", si ? "con atajos" : "sin atajos",
+                    (double)est.pasos() / est.tokens(), (unsigned long long)est.reducciones(), (unsigned long long)est.reduccionesEnAtajos,
+                    segReconocer * 1e3, segParse * 1e3);
+    }
+    return prueba.codigo();
+}
+
+/* ------------------ Parser directo ------------------ */
+inline int verificarDirecto(ContextoVerificacion &c){
+#ifdef HAY_PARSER_DIRECTO
+    const LRGram &G = c.G;
+    if(huellaGramatica(G) != parser_generado::HUELLA){
+        std::fprintf(stderr, "Error: parser_generado.h se generó desde otra tabla (huella %u, la cargada es %u)\n",
+                     parser_generado::HUELLA, huellaGramatica(G));
+        return 1;
+    }
+    PruebaDiferencial prueba;
+    auto caso = [&](const std::string &s){
+        Arbol a, b;
+        Diagnostico d1 = parseLR(G, s, a), d2 = parser_generado::parseLR(s, b);
+        Diagnostico d3 = parser_generado::reconocerLR(s);
+        prueba.aceptados += d1.aceptada;
+        prueba.comprobar(d1.aceptada == d2.aceptada && d1.pos == d2.pos && d1.mensaje == d2.mensaje && mismaArena(a, b) &&
+                         d3.aceptada == d1.aceptada && d3.mensaje == d1.mensaje, [&]{
+            std::fprintf(stderr, "FALLO directo: %s | %s\n<<%s>>\n", d1.mensaje.c_str(), d2.mensaje.c_str(), s.c_str());
+        });
+    };
+    caso(generarEntrada(200000));
+    caso("");
+    Azar azar(7654321u);
+    programasMutados(azar, 3000, 3, {"x", "1", "(", ")", "{", "}", "+", "*", "==", "&&", "!", "else ", "if (a) ", "int ", ";", ",", "g(", "return ", "@", "\""}, caso);
+    std::printf("Parser directo frente a analizarLR: %d casos (%d aceptados), %d fallos\n", prueba.casos, prueba.aceptados, prueba.fallos);
+    return prueba.codigo();
+#else
+    (void)c;
+    std::fprintf(stderr, "Error: compilado sin parser_generado.h (ver generarparser.cpp)\n");
+    return 1;
+#endif
+}
+
+#endif
@@ -0,0 +1,63 @@
+// salida.h
+// Buffer de salida grande delante de un ostream: los escritores del árbol
+// (arbol.h, serializar.h) acumulan aquí y el ostream recibe bloques de
+// 1 MiB en lugar de un operator<< por pedazo de línea.
+#ifndef SALIDA_H
+#define SALIDA_H
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <string_view>
+
+class SalidaBuffer {
+public:
+    static const size_t TAM_DEFECTO = 1 << 20;
+
+    explicit SalidaBuffer(std::ostream &os, size_t tam = TAM_DEFECTO)
+        : os(os), buf(new char[tam]), cap(tam) {}
+    ~SalidaBuffer() { vaciar(); }
+    SalidaBuffer(const SalidaBuffer&) = delete;
+    SalidaBuffer& operator=(const SalidaBuffer&) = delete;
+
+    void escribir(const char *p, size_t n) {
+        if (n > cap - usado) {
+            vaciar();
+            if (n >= cap) { os.write(p, (std::streamsize)n); total += n; return; }
+        }
+        std::memcpy(buf.get() + usado, p, n);
+        usado += n;
+    }
+    void escribir(std::string_view s) { escribir(s.data(), s.size()); }
+    void caracter(char c) {
+        if (usado == cap) vaciar();
+        buf[usado++] = c;
+    }
+    void entero(uint64_t v) {
+        char tmp[20];
+        int n = 0;
+        do { tmp[19 - n++] = char('0' + v % 10); v /= 10; } while (v);
+        escribir(tmp + 20 - n, (size_t)n);
+    }
+    // Valor crudo en el orden de bytes de la máquina (formato binario).
+    template<class T> void binario(const T &v) { escribir((const char*)&v, sizeof v); }
+
+    void vaciar() {
+        if (!usado) return;
+        os.write(buf.get(), (std::streamsize)usado);
+        total += usado;
+        usado = 0;
+    }
+    // Bytes entregados hasta ahora, incluidos los que siguen en el buffer.
+    uint64_t escritos() const { return total + usado; }
+    bool ok() const { return (bool)os; }
+
+private:
+    std::ostream &os;
+    std::unique_ptr<char[]> buf;
+    size_t cap, usado = 0;
+    uint64_t total = 0;
+};
+
+#endif
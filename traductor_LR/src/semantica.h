@@ -0,0 +1,441 @@
+// semantica.h
+// Análisis semántico del árbol: declaraciones (DefVar, Parametros,
+// DefLocales), usos de variables, llamadas (LlamadaFunc) y tipos int/float.
+// Se reportan todos los errores, no sólo el primero, con la función en la
+// que ocurren. Las reglas del lenguaje son las de bytecode.h, salvo que aquí
+// un float no se convierte implícitamente a int (asignación, argumento o
+// return): se reporta. int pasa a float sin aviso.
+//
+// La tabla de símbolos usa direccionamiento abierto con el id del lexema
+// como clave (los identificadores ya vienen internados en el árbol), así que
+// buscar no compara texto. Cada ranura apunta al símbolo visible y cada
+// símbolo al que oculta; cerrar un ámbito recorre sólo los símbolos que se
+// declararon en él y libera las ranuras de los nombres que dejan de verse. Todo el recorrido es iterativo y lineal en el tamaño
+// del árbol, que puede ser el completo o el compacto de optimizar.h.
+#ifndef SEMANTICA_H
+#define SEMANTICA_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "arbol.h"
+#include "gramatica.h"
+#include "lexer.h"
+#include "vista_ast.h"
+
+enum class TipoSem : uint8_t { ENTERO, REAL, CADENA, NADA, ERROR };
+
+inline const char* nombreTipoSem(TipoSem t) {
+    static const char *const NOMBRES[] = {"int", "float", "cadena", "nada", "error"};
+    return NOMBRES[(int)t];
+}
+
+enum class ClaseSimbolo : uint8_t { GLOBAL, PARAMETRO, LOCAL, FUNCION };
+
+struct Simbolo {
+    uint32_t lexema;
+    uint32_t anterior; // símbolo con el mismo nombre que éste oculta
+    uint32_t nivel;    // ámbito en el que se declaró (1 = global)
+    uint32_t firma;    // funciones: índice en AnalizadorSemantico::firmas
+    ClaseSimbolo clase;
+    TipoSem tipo;      // de la variable o del valor de retorno
+};
+
+/* ------------------ Tabla de símbolos ------------------ */
+class TablaSimbolos {
+public:
+    static const uint32_t NINGUNO = UINT32_MAX;
+
+    TablaSimbolos() { limpiar(); }
+
+    void abrirAmbito() { marcas.push_back((uint32_t)simbolos.size()); }
+    // Deshace las declaraciones del ámbito: O(símbolos declarados en él). Un
+    // nombre que ya no oculta a nadie libera su ranura, así que la tabla sólo
+    // guarda nombres visibles y los locales de una función no alargan las
+    // búsquedas de las siguientes.
+    void cerrarAmbito() {
+        uint32_t m = marcas.back();
+        marcas.pop_back();
+        while (simbolos.size() > m) {
+            const Simbolo &s = simbolos.back();
+            size_t k = ranura(s.lexema);
+            if (s.anterior == NINGUNO) liberar(k);
+            else ranuras[k].simbolo = s.anterior;
+            simbolos.pop_back();
+        }
+    }
+    uint32_t nivel() const { return (uint32_t)marcas.size(); }
+
+    // NINGUNO si el nombre ya está declarado en el ámbito actual; si no, el
+    // índice del símbolo nuevo (válido hasta que se cierre su ámbito).
+    uint32_t declarar(uint32_t lexema, ClaseSimbolo clase, TipoSem tipo, uint32_t firma = NINGUNO) {
+        size_t k = ranura(lexema);
+        if (ranuras[k].lexema == NINGUNO) {
+            if ((ocupadas + 1) * 2 > ranuras.size()) { crecer(); k = ranura(lexema); }
+            ranuras[k].lexema = lexema;
+            ocupadas++;
+        }
+        uint32_t visible = ranuras[k].simbolo;
+        if (visible != NINGUNO && simbolos[visible].nivel == nivel()) return NINGUNO;
+        simbolos.push_back(Simbolo{lexema, visible, nivel(), firma, clase, tipo});
+        ranuras[k].simbolo = (uint32_t)simbolos.size() - 1;
+        return ranuras[k].simbolo;
+    }
+
+    // Símbolo visible con ese nombre, o nullptr.
+    const Simbolo* buscar(uint32_t lexema) {
+        const Ranura &r = ranuras[ranura(lexema)];
+        return r.lexema == lexema && r.simbolo != NINGUNO ? &simbolos[r.simbolo] : nullptr;
+    }
+    const Simbolo& operator[](uint32_t s) const { return simbolos[s]; }
+
+    void limpiar() {
+        ranuras.assign(64, Ranura{NINGUNO, NINGUNO});
+        corrimiento = 64 - 6;
+        simbolos.clear();
+        marcas.clear();
+        ocupadas = 0;
+        accesos = sondeos = 0;
+    }
+
+    size_t capacidad() const { return ranuras.size(); }
+    uint64_t accesos = 0, sondeos = 0; // sondeos / accesos = ranuras vistas por operación
+
+private:
+    struct Ranura { uint32_t lexema, simbolo; }; // lexema NINGUNO = libre
+    std::vector<Ranura> ranuras;
+    std::vector<Simbolo> simbolos; // pila de declaraciones vivas
+    std::vector<uint32_t> marcas;  // inicio de cada ámbito abierto en 'simbolos'
+    size_t ocupadas = 0;
+    unsigned corrimiento = 0; // 64 - log2(ranuras.size())
+
+    // Hash multiplicativo de Fibonacci: los ids de lexema son consecutivos y,
+    // usados directamente, los nombres de funciones vecinas ocupan corridas
+    // contiguas que el sondeo lineal tiene que atravesar.
+    size_t dispersar(uint32_t lexema) const { return (size_t)((lexema * 0x9E3779B97F4A7C15ull) >> corrimiento); }
+
+    size_t ranura(uint32_t lexema) {
+        size_t mascara = ranuras.size() - 1;
+        size_t k = dispersar(lexema);
+        accesos++;
+        while (ranuras[k].lexema != lexema && ranuras[k].lexema != NINGUNO) { k = (k + 1) & mascara; sondeos++; }
+        sondeos++;
+        return k;
+    }
+
+    // Borrado por corrimiento hacia atrás: cada ranura siguiente de la
+    // corrida que no quedaría alcanzable desde su posición ideal se mueve al
+    // hueco. No deja marcas de borrado, así que las corridas no crecen.
+    void liberar(size_t i) {
+        size_t mascara = ranuras.size() - 1;
+        for (size_t j = i;;) {
+            ranuras[i] = Ranura{NINGUNO, NINGUNO};
+            size_t ideal;
+            do {
+                j = (j + 1) & mascara;
+                if (ranuras[j].lexema == NINGUNO) { ocupadas--; return; }
+                ideal = dispersar(ranuras[j].lexema);
+            } while (i <= j ? (i < ideal && ideal <= j) : (i < ideal || ideal <= j));
+            ranuras[i] = ranuras[j];
+            i = j;
+        }
+    }
+
+    // Todas las ranuras ocupadas tienen un símbolo visible: se duplica.
+    void crecer() {
+        std::vector<Ranura> viejas(ranuras.size() * 2, Ranura{NINGUNO, NINGUNO});
+        viejas.swap(ranuras);
+        corrimiento--;
+        size_t mascara = ranuras.size() - 1;
+        for (const Ranura &r : viejas) {
+            if (r.lexema == NINGUNO) continue;
+            size_t k = dispersar(r.lexema);
+            while (ranuras[k].lexema != NINGUNO) k = (k + 1) & mascara;
+            ranuras[k] = r;
+        }
+    }
+};
+
+/* ------------------ Análisis ------------------ */
+struct ResultadoSemantico {
+    static const size_t ERRORES_MAX = 100; // se guardan los primeros; se cuentan todos
+
+    std::vector<std::string> errores;
+    uint64_t nErrores = 0;
+    uint64_t funciones = 0, declaraciones = 0, usos = 0, ambitos = 0;
+    uint64_t accesos = 0, sondeos = 0; // de la tabla de símbolos
+    size_t ranuras = 0;
+    uint64_t nsDeclaraciones = 0, nsCuerpos = 0; // primera pasada (globales y firmas) y cuerpos
+
+    bool ok() const { return nErrores == 0; }
+};
+
+class AnalizadorSemantico : private VistaAst {
+public:
+    AnalizadorSemantico(const Arbol &A, const LRGram &G) : VistaAst(A, G) {}
+
+    void analizar(ResultadoSemantico &res) {
+        R = &res;
+        res = ResultadoSemantico();
+        tabla.limpiar();
+        firmas.clear();
+        tiposParametros.clear();
+        funcion = TablaSimbolos::NINGUNO;
+        clasificarReglas();
+        tipoNodo.assign(A.nodos.size(), TipoSem::ERROR);
+
+        // Primera pasada: globales y firmas, visibles desde cualquier función.
+        auto t0 = std::chrono::steady_clock::now();
+        tabla.abrirAmbito();
+        res.ambitos++;
+        std::vector<uint32_t> cuerpos;
+        uint32_t lista = listaDefiniciones();
+        if (lista != Arbol::NINGUNO)
+            paraCadaElemento(lista, [&](uint32_t d) {
+                if (categoria(d) == DEFVAR) declararVariables(d, ClaseSimbolo::GLOBAL);
+                else if (categoria(d) == DEFFUNC && declararFuncion(d)) cuerpos.push_back(d);
+            });
+        auto t1 = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < cuerpos.size(); i++) analizarFuncion(cuerpos[i], (uint32_t)i);
+        tabla.cerrarAmbito();
+        auto t2 = std::chrono::steady_clock::now();
+
+        res.nsDeclaraciones = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+        res.nsCuerpos = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
+        res.funciones = firmas.size();
+        res.accesos = tabla.accesos;
+        res.sondeos = tabla.sondeos;
+        res.ranuras = tabla.capacidad();
+    }
+
+private:
+    struct Firma {
+        uint32_t lexema, primerParametro, nParametros;
+        TipoSem retorno;
+    };
+
+    ResultadoSemantico *R = nullptr;
+    TablaSimbolos tabla;
+    std::vector<Firma> firmas;
+    std::vector<TipoSem> tiposParametros; // de todas las firmas, consecutivos
+    std::vector<TipoSem> tipoNodo;        // tipo de cada nodo de expresión ya visitado
+    std::vector<uint32_t> pendientes, locales, nombres, args;
+    std::vector<std::pair<uint32_t, bool>> pila;
+    uint32_t funcion = TablaSimbolos::NINGUNO; // firma de la función que se analiza
+    uint32_t llamadaSentencia = Arbol::NINGUNO; // LlamadaFunc usada como sentencia (puede ser print)
+
+    void fallar(const std::string &m) {
+        if (R->errores.size() < ResultadoSemantico::ERRORES_MAX)
+            R->errores.push_back(funcion == TablaSimbolos::NINGUNO ? m : "en " + std::string(nombre(firmas[funcion].lexema)) + "(): " + m);
+        R->nErrores++;
+    }
+
+    std::string_view nombre(uint32_t lexema) const { return A.lexemas.texto(lexema); }
+    TipoSem tipoDe(uint32_t hojaTipo) const { return esToken(hojaTipo, TokenType::TIPO_FLOAT) ? TipoSem::REAL : TipoSem::ENTERO; }
+    static bool numerico(TipoSem t) { return t == TipoSem::ENTERO || t == TipoSem::REAL; }
+
+    /* ---- Declaraciones ---- */
+    void declarar(uint32_t hojaNombre, ClaseSimbolo clase, TipoSem t, uint32_t firma = TablaSimbolos::NINGUNO) {
+        uint32_t id = A[hojaNombre].lexema;
+        R->declaraciones++;
+        if (tabla.declarar(id, clase, t, firma) != TablaSimbolos::NINGUNO) return;
+        std::string n = "'" + std::string(nombre(id)) + "'";
+        if (clase == ClaseSimbolo::PARAMETRO) fallar("el parámetro " + n + " está repetido");
+        else if (clase == ClaseSimbolo::LOCAL) fallar("la variable local " + n + " ya está declarada");
+        else fallar(n + " ya está declarado");
+    }
+    void declararVariables(uint32_t d, ClaseSimbolo clase) {
+        TipoSem t = tipoDe(hijo(d, 0));
+        nombres.clear();
+        nombresDeclarados(d, nombres);
+        for (uint32_t n : nombres) declarar(n, clase, t);
+    }
+    bool declararFuncion(uint32_t d) {
+        Firma f{A[hijo(d, 1)].lexema, (uint32_t)tiposParametros.size(), 0, tipoDe(hijo(d, 0))};
+        nombres.clear();
+        parametros(d, nombres); // tipo, id, tipo, id, ...
+        for (size_t i = 0; i + 1 < nombres.size(); i += 2) { tiposParametros.push_back(tipoDe(nombres[i])); f.nParametros++; }
+        uint32_t antes = (uint32_t)R->nErrores;
+        declarar(hijo(d, 1), ClaseSimbolo::FUNCION, f.retorno, (uint32_t)firmas.size());
+        if (R->nErrores != antes) { tiposParametros.resize(f.primerParametro); return false; }
+        firmas.push_back(f);
+        return true;
+    }
+
+    /* ---- Cuerpos ---- */
+    void analizarFuncion(uint32_t d, uint32_t firma) {
+        funcion = firma;
+        tabla.abrirAmbito();
+        R->ambitos++;
+        nombres.clear();
+        parametros(d, nombres);
+        for (size_t i = 0; i + 1 < nombres.size(); i += 2) declarar(nombres[i + 1], ClaseSimbolo::PARAMETRO, tipoDe(nombres[i]));
+        locales.clear();
+        contenido(cuerpoFuncion(d), locales);
+        for (uint32_t x : locales) {
+            if (categoria(x) == DEFVAR) declararVariables(x, ClaseSimbolo::LOCAL);
+            else sentencias(x);
+        }
+        tabla.cerrarAmbito();
+        funcion = TablaSimbolos::NINGUNO;
+    }
+
+    // Recorre una Sentencia o un Bloque con sus bloques anidados, en orden
+    // de aparición.
+    void sentencias(uint32_t raiz) {
+        pendientes.assign(1, raiz);
+        while (!pendientes.empty()) {
+            uint32_t s = pendientes.back();
+            pendientes.pop_back();
+            if (categoria(s) == BLOQUE) {
+                size_t m = pendientes.size();
+                contenido(s, pendientes);
+                std::reverse(pendientes.begin() + (std::ptrdiff_t)m, pendientes.end());
+                continue;
+            }
+            if (categoria(s) != SENTENCIA) continue;
+            uint32_t x = hijo(s, 0);
+            if (esToken(x, TokenType::IDENT)) {
+                TipoSem destino = usarVariable(x), t = expresion(hijo(s, 2));
+                if (!compatible(destino, t)) noSeConvierte(destino, t, "en la asignación a '" + std::string(nombre(A[x].lexema)) + "'");
+            } else if (esToken(x, TokenType::RESERVADA_IF)) {
+                condicion(hijo(s, 2));
+                uint32_t otro = ramaElse(s);
+                if (otro != Arbol::NINGUNO) pendientes.push_back(otro);
+                pendientes.push_back(rama(hijo(s, 4)));
+            } else if (esToken(x, TokenType::RESERVADA_WHILE)) {
+                condicion(hijo(s, 2));
+                pendientes.push_back(hijo(s, 4));
+            } else if (esToken(x, TokenType::RESERVADA_RETURN)) {
+                uint32_t v = valorRetorno(s);
+                TipoSem t = v != Arbol::NINGUNO ? expresion(v) : firmas[funcion].retorno;
+                if (!compatible(firmas[funcion].retorno, t)) noSeConvierte(firmas[funcion].retorno, t, "en el valor de return");
+            } else if (categoria(x) == LLAMADAFUNC) {
+                llamadaSentencia = x;
+                expresion(x);
+                llamadaSentencia = Arbol::NINGUNO;
+            }
+        }
+    }
+
+    void condicion(uint32_t e) {
+        TipoSem t = expresion(e);
+        if (t != TipoSem::ERROR && !numerico(t)) fallar(std::string("la condición es de tipo ") + nombreTipoSem(t));
+    }
+
+    // int -> float se acepta; el resto de las diferencias se reporta. Un
+    // operando con error ya reportado no genera otro.
+    static bool compatible(TipoSem destino, TipoSem t) {
+        return t == destino || t == TipoSem::ERROR || destino == TipoSem::ERROR || (destino == TipoSem::REAL && t == TipoSem::ENTERO);
+    }
+    void noSeConvierte(TipoSem destino, TipoSem t, const std::string &donde) {
+        fallar(donde + ": no se puede convertir " + nombreTipoSem(t) + " a " + nombreTipoSem(destino));
+    }
+
+    TipoSem usarVariable(uint32_t hojaNombre) {
+        uint32_t id = A[hojaNombre].lexema;
+        R->usos++;
+        const Simbolo *s = tabla.buscar(id);
+        if (!s) { fallar("variable '" + std::string(nombre(id)) + "' no declarada"); return TipoSem::ERROR; }
+        if (s->clase == ClaseSimbolo::FUNCION) { fallar("'" + std::string(nombre(id)) + "' es una función, no una variable"); return TipoSem::ERROR; }
+        return s->tipo;
+    }
+
+    /* ---- Expresiones ---- */
+    // Postorden con pila explícita: al visitar un nodo sus hijos ya tienen
+    // tipo. Los identificadores se buscan en su turno, de izquierda a
+    // derecha (el orden de los errores); los literales toman su tipo al
+    // expandir el padre y el resto de los tokens no se consulta. Del nombre
+    // de una LlamadaFunc se encarga llamada().
+    TipoSem expresion(uint32_t e) {
+        pila.assign(1, {e, false});
+        while (!pila.empty()) {
+            auto [k, expandido] = pila.back();
+            if (A[k].esHoja()) {
+                pila.pop_back();
+                tipoNodo[k] = A[k].tipoToken() == TokenType::IDENT ? usarVariable(k) : literal(k);
+                continue;
+            }
+            Categoria c = categoria(k);
+            if (!expandido) {
+                pila.back().second = true;
+                for (uint32_t i = nHijos(k); i-- > (c == LLAMADAFUNC ? 1u : 0u);) {
+                    uint32_t h = hijo(k, i);
+                    if (!A[h].esHoja() || A[h].tipoToken() == TokenType::IDENT) pila.push_back({h, false});
+                    else tipoNodo[h] = literal(h);
+                }
+                continue;
+            }
+            pila.pop_back();
+            if (c == EXPRESION || c == TERMINO || c == LLAMADAFUNC) tipoNodo[k] = evaluar(k, c);
+        }
+        return tipoNodo[e];
+    }
+
+    TipoSem literal(uint32_t x) const {
+        switch (A[x].tipoToken()) {
+        case TokenType::ENTERO: return TipoSem::ENTERO;
+        case TokenType::REAL: return TipoSem::REAL;
+        case TokenType::CADENA: return TipoSem::CADENA;
+        default: return TipoSem::ERROR; // operadores y puntuación: no se consultan
+        }
+    }
+
+    TipoSem evaluar(uint32_t k, Categoria c) {
+        if (c == LLAMADAFUNC) return llamada(k);
+        uint32_t n = nHijos(k), x = hijo(k, 0);
+        if (n == 1) return tipoNodo[x]; // Termino, Expresion -> Termino
+        if (n == 3 && esToken(x, TokenType::PARENTESIS_ABRE)) return tipoNodo[hijo(k, 1)];
+        if (n == 2) {
+            TipoSem t = tipoNodo[hijo(k, 1)];
+            if (!operando(t)) return TipoSem::ERROR;
+            return esToken(x, TokenType::OP_NOT) ? TipoSem::ENTERO : t;
+        }
+        TipoSem a = tipoNodo[x], b = tipoNodo[hijo(k, 2)];
+        if (!operando(a) | !operando(b)) return TipoSem::ERROR;
+        uint32_t op = hijo(k, 1);
+        if (esToken(op, TokenType::OP_SUMA) || esToken(op, TokenType::OP_MUL))
+            return a == TipoSem::REAL || b == TipoSem::REAL ? TipoSem::REAL : TipoSem::ENTERO;
+        return TipoSem::ENTERO; // relacionales, igualdad, && y ||
+    }
+    bool operando(TipoSem t) {
+        if (numerico(t)) return true;
+        if (t != TipoSem::ERROR) fallar(std::string("operando de tipo ") + nombreTipoSem(t));
+        return false;
+    }
+
+    TipoSem llamada(uint32_t ll) {
+        uint32_t id = A[hijo(ll, 0)].lexema;
+        args.clear();
+        argumentos(ll, args);
+        R->usos++;
+        const Simbolo *s = tabla.buscar(id);
+        if (!s && nombre(id) == "print") { // los argumentos pueden ser de cualquier tipo, cadenas incluidas
+            if (ll != llamadaSentencia) { fallar("print no devuelve un valor"); return TipoSem::ERROR; }
+            return TipoSem::NADA;
+        }
+        if (!s) { fallar("función '" + std::string(nombre(id)) + "' no declarada"); return TipoSem::ERROR; }
+        if (s->clase != ClaseSimbolo::FUNCION) { fallar("'" + std::string(nombre(id)) + "' no es una función"); return TipoSem::ERROR; }
+        const Firma &f = firmas[s->firma];
+        if (args.size() != f.nParametros) {
+            fallar(std::string(nombre(id)) + "() espera " + std::to_string(f.nParametros) + " argumentos y recibe " + std::to_string(args.size()));
+            return f.retorno;
+        }
+        for (size_t i = 0; i < args.size(); i++) {
+            TipoSem p = tiposParametros[f.primerParametro + i];
+            if (!compatible(p, tipoNodo[args[i]]))
+                noSeConvierte(p, tipoNodo[args[i]], "en el argumento " + std::to_string(i + 1) + " de " + std::string(nombre(id)) + "()");
+        }
+        return f.retorno;
+    }
+};
+
+inline bool analizarSemantica(const Arbol &A, const LRGram &G, ResultadoSemantico &res) {
+    AnalizadorSemantico a(A, G);
+    a.analizar(res);
+    return res.ok();
+}
+
+#endif
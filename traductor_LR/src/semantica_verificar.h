@@ -0,0 +1,105 @@
+// semantica_verificar.h
+// Prueba del análisis semántico (benchmark --verificar-semantica
+// [--declaraciones N]): errores esperados en programas chicos y costo por
+// declaración a tres tamaños, con pocas y con muchas locales por función.
+#ifndef SEMANTICA_VERIFICAR_H
+#define SEMANTICA_VERIFICAR_H
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include "parser.h"
+#include "semantica.h"
+#include "verificacion.h"
+
+// Programa válido con unas 7 declaraciones por función: una global, la
+// función, dos parámetros y tres locales, con usos y una llamada a la
+// función anterior. Los nombres no se repiten entre funciones, así que la
+// tabla de símbolos ve tantos identificadores distintos como declaraciones.
+inline std::string programaDeclaraciones(size_t declaraciones){
+    std::string p;
+    for(size_t i=0;i*7<declaraciones;i++){
+        std::string n = std::to_string(i), llamada = i ? "f" + std::to_string(i - 1) + "(a, b)" : "a";
+        p += "float g" + n + ";\nint f" + n + "(int a, float b) { int x" + n + ", y; float z; x" + n + " = a + " + llamada +
+             "; z = b * g" + n + " + y; if (x" + n + " < 3) y = 1; else y = 2; return x" + n + " - y; }\n";
+    }
+    return p + "int main() { return f0(1, 2.5); }\n";
+}
+
+// Funciones con 'locales' variables locales de nombre propio cada una: al
+// cerrar cada función sus nombres dejan de verse, y la tabla no debe
+// acumularlos en las búsquedas de las funciones siguientes.
+inline std::string programaLocales(size_t declaraciones, size_t locales = 63){
+    std::string p;
+    for(size_t i=0;i*(locales + 1)<declaraciones;i++){
+        std::string n = std::to_string(i);
+        p += "int f" + n + "() { int ";
+        for(size_t j=0;j<locales;j++) p += (j ? ", l" : "l") + std::to_string(j) + "x" + n;
+        p += "; l0x" + n + " = l" + std::to_string(locales - 1) + "x" + n + "; return 0; }\n";
+    }
+    return p + "int main() { return 0; }\n";
+}
+
+inline int verificarSemantica(ContextoVerificacion &c){
+    const LRGram &G = c.G;
+    size_t declaraciones = (size_t)c.opcion("--declaraciones", 2000000);
+    struct Caso { const char *nombre, *fuente; uint64_t errores; };
+    const Caso casos[] = {
+        {"válido", "int g; float h;\nfloat f(int a, float b) { float c; c = a * b + g; return c; }\n"
+                   "int main() { int x; x = 2; h = f(x, 1); print(\"h\", h); while (x > 0) { x = x - 1; } return x; }\n", 0},
+        {"ocultar global", "float x;\nint main() { int x; x = 1; return x; }\n", 0},
+        {"usar antes de declarar", "int main() { return f(); }\nint f() { return g; }\nint g;\n", 0},
+        {"redeclaraciones", "int g; float g;\nint f(int a, int a) { int b; float b; return a; }\nint f() { return 0; }\n", 4},
+        {"no declarados", "int main() { x = 1; return y + h(2); }\n", 3},
+        {"tipos", "int f(int a) { return 1.5; }\nint main() { int i; float r; i = r; r = i; i = f(r); i = \"s\" + 1; if (\"c\") i = 2; return i; }\n", 5},
+        {"llamadas", "int f(int a) { return a; }\nint v;\nint main() { v = f(); v = f(1, 2); v = v(1); v = f + 1; v = print(1); return 0; }\n", 5},
+        {"local en otra función", "int f() { int t; return t; }\nint main() { return t; }\n", 1},
+    };
+    PruebaDiferencial prueba;
+    for(const Caso &k : casos){
+        Arbol A;
+        ResultadoSemantico r;
+        bool aceptada = parseLR(G, k.fuente, A).aceptada;
+        if(aceptada) analizarSemantica(A, G, r);
+        prueba.comprobar(aceptada && r.nErrores == k.errores, [&]{
+            if(!aceptada){ std::fprintf(stderr, "FALLO %s: entrada rechazada\n", k.nombre); return; }
+            std::fprintf(stderr, "FALLO %s: %llu errores, se esperaban %llu\n", k.nombre, (unsigned long long)r.nErrores, (unsigned long long)k.errores);
+            for(const std::string &e : r.errores) std::fprintf(stderr, "    %s\n", e.c_str());
+        });
+    }
+    std::printf("Análisis semántico: %d casos, %d fallos\n", prueba.casos, prueba.fallos);
+
+    // Mismo programa a tres tamaños: el costo por declaración no debe crecer,
+    // ni con pocas locales por función ni con muchas.
+    auto escalar = [&](const char *nombre, std::string (*programa)(size_t, size_t), size_t locales){
+        std::printf("  %s:\n", nombre);
+        double nsPorDecl[3] = {};
+        for(int k=0;k<3;k++){
+            size_t n = declaraciones >> (2 - k);
+            std::string p = programa(n, locales);
+            Arbol A;
+            auto t0 = std::chrono::steady_clock::now();
+            bool aceptada = parseLR(G, p, A).aceptada;
+            double msSintactico = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+            ResultadoSemantico r;
+            analizarSemantica(A, G, r);
+            if(!aceptada || !r.ok()){
+                prueba.fallo([&]{ std::fprintf(stderr, "FALLO %s, %zu declaraciones: %s\n", nombre, n, aceptada ? r.errores[0].c_str() : "entrada rechazada"); });
+                continue;
+            }
+            nsPorDecl[k] = (double)(r.nsDeclaraciones + r.nsCuerpos) / r.declaraciones;
+            double sondeos = (double)r.sondeos / r.accesos;
+            std::printf("  %9llu declaraciones  %9llu usos  sintáctico %8.1f ms  declaraciones %7.1f ms  cuerpos %7.1f ms  %5.1f ns/decl  %.2f sondeos/acceso\n",
+                        (unsigned long long)r.declaraciones, (unsigned long long)r.usos, msSintactico, r.nsDeclaraciones / 1e6, r.nsCuerpos / 1e6,
+                        nsPorDecl[k], sondeos);
+            if(sondeos > 8) prueba.fallo([&]{ std::fprintf(stderr, "FALLO %s: %.1f sondeos por acceso a la tabla de símbolos\n", nombre, sondeos); });
+        }
+        if(nsPorDecl[0] > 0 && nsPorDecl[2] > 3 * nsPorDecl[0])
+            prueba.fallo([&]{ std::fprintf(stderr, "FALLO %s: el costo por declaración creció de %.1f a %.1f ns\n", nombre, nsPorDecl[0], nsPorDecl[2]); });
+    };
+    escalar("3 locales por función", [](size_t n, size_t){ return programaDeclaraciones(n); }, 0);
+    escalar("63 locales por función", programaLocales, 63);
+    return prueba.codigo();
+}
+
+#endif
@@ -0,0 +1,249 @@
+// serializar.h
+// Escritura del árbol sintáctico en tres formatos, todos sin recursión y a
+// través de un SalidaBuffer:
+//   - ascii:  la vista con ramas de siempre (escribirArbolASCII, arbol.h);
+//   - json:   compacto, {"regla":"X","hijos":[...]} y {"token":"t","lexema":"l"};
+//   - binario: cabecera + nombres de reglas + lexemas + nodos en preorden,
+//     para herramientas que no quieren volver a analizar la entrada.
+// leerArbolBinario reconstruye un Arbol a partir del formato binario.
+#ifndef SERIALIZAR_H
+#define SERIALIZAR_H
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "arbol.h"
+#include "gramatica.h"
+#include "salida.h"
+
+enum class FormatoArbol { ASCII, JSON, BINARIO };
+
+inline bool leerFormatoArbol(const std::string &s, FormatoArbol &f) {
+    if (s == "ascii") f = FormatoArbol::ASCII;
+    else if (s == "json") f = FormatoArbol::JSON;
+    else if (s == "bin") f = FormatoArbol::BINARIO;
+    else return false;
+    return true;
+}
+
+/* ------------------ JSON ------------------ */
+inline void escribirCadenaJSON(SalidaBuffer &s, std::string_view t) {
+    static const char HEX[] = "0123456789abcdef";
+    s.caracter('"');
+    size_t ini = 0;
+    for (size_t i = 0; i < t.size(); i++) {
+        unsigned char c = (unsigned char)t[i];
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+        s.escribir(t.data() + ini, i - ini);
+        ini = i + 1;
+        if (c == '"' || c == '\\') { s.caracter('\\'); s.caracter((char)c); }
+        else if (c == '\n') s.escribir("\\n");
+        else if (c == '\t') s.escribir("\\t");
+        else if (c == '\r') s.escribir("\\r");
+        else { s.escribir("\\u00"); s.caracter(HEX[c >> 4]); s.caracter(HEX[c & 15]); }
+    }
+    s.escribir(t.data() + ini, t.size() - ini);
+    s.caracter('"');
+}
+
+inline void escribirArbolJSON(SalidaBuffer &s, const Arbol &A, const LRGram &G, uint32_t nodo) {
+    if (nodo == Arbol::NINGUNO) { s.escribir("null\n"); return; }
+    struct Marco { uint32_t nodo, siguiente; };
+    std::vector<Marco> pila;
+    auto abrir = [&](uint32_t k) {
+        const NodoAst &n = A[k];
+        if (n.esHoja()) {
+            s.escribir("{\"token\":");
+            escribirCadenaJSON(s, tokenToKey(n.tipoToken()));
+            if (n.lexema != TablaLexemas::NINGUNO) {
+                s.escribir(",\"lexema\":");
+                escribirCadenaJSON(s, A.lexemas.texto(n.lexema));
+            }
+            s.caracter('}');
+            return;
+        }
+        s.escribir("{\"regla\":");
+        escribirCadenaJSON(s, G.nombreRegla(n.regla() - 1));
+        s.escribir(",\"hijos\":[");
+        pila.push_back(Marco{k, 0});
+    };
+    abrir(nodo);
+    while (!pila.empty()) {
+        Marco &m = pila.back();
+        const NodoAst &n = A[m.nodo];
+        if (m.siguiente == n.nHijos) {
+            s.escribir("]}");
+            pila.pop_back();
+            continue;
+        }
+        if (m.siguiente) s.caracter(',');
+        abrir(A.hijo(n, m.siguiente++));
+    }
+    s.caracter('\n');
+}
+
+/* ------------------ Binario ------------------ */
+// Archivo = CabeceraAST, nombres de reglas (nReglas cadenas terminadas en
+// '\0', con relleno hasta múltiplo de 4), nLexemas+1 desplazamientos
+// uint32 seguidos de los bytes de los lexemas (con relleno), y nNodos
+// NodoBinario en preorden. Como en el .lrb, los enteros van en el orden de
+// bytes de la máquina que lo escribió y 'orden' lo delata.
+const char AST_MAGIA[8] = {'L','R','A','S','T','\r','\n','\x1a'};
+const uint32_t AST_VERSION = 1;
+
+struct CabeceraAST {
+    char magia[8];
+    uint32_t version;
+    uint32_t orden;
+    uint32_t nReglas, tamNombres;
+    uint32_t nLexemas, tamLexemas;
+    uint32_t nNodos;
+    uint32_t reservado;
+};
+
+// Mismos campos que NodoAst salvo el rango de hijos: en preorden basta con
+// cuántos son.
+struct NodoBinario {
+    int32_t simbolo;
+    uint32_t lexema;
+    uint32_t nHijos;
+};
+
+inline uint32_t contarNodos(const Arbol &A, uint32_t nodo) {
+    if (nodo == Arbol::NINGUNO) return 0;
+    uint32_t n = 0;
+    std::vector<uint32_t> pila{nodo};
+    while (!pila.empty()) {
+        const NodoAst &x = A[pila.back()];
+        pila.pop_back();
+        n++;
+        for (uint32_t i = 0; i < x.nHijos; i++) pila.push_back(A.hijo(x, i));
+    }
+    return n;
+}
+
+inline void escribirArbolBinario(SalidaBuffer &s, const Arbol &A, const LRGram &G, uint32_t nodo) {
+    auto rellenar = [&s](uint64_t n) { while (n++ % 4) s.caracter('\0'); };
+    CabeceraAST h{};
+    std::memcpy(h.magia, AST_MAGIA, sizeof h.magia);
+    h.version = AST_VERSION;
+    h.orden = LRB_ORDEN;
+    h.nReglas = (uint32_t)G.nReglas;
+    for (int r = 0; r < G.nReglas; r++) h.tamNombres += (uint32_t)std::strlen(G.nombreRegla(r)) + 1;
+    h.tamNombres = (h.tamNombres + 3) & ~3u;
+    h.nLexemas = (uint32_t)A.lexemas.size();
+    for (uint32_t l = 0; l < h.nLexemas; l++) h.tamLexemas += (uint32_t)A.lexemas.texto(l).size();
+    h.nNodos = contarNodos(A, nodo);
+    s.binario(h);
+
+    uint64_t n = 0;
+    for (int r = 0; r < G.nReglas; r++) {
+        const char *nombre = G.nombreRegla(r);
+        size_t lon = std::strlen(nombre) + 1;
+        s.escribir(nombre, lon);
+        n += lon;
+    }
+    rellenar(n);
+    uint32_t off = 0;
+    for (uint32_t l = 0; l < h.nLexemas; l++) { s.binario(off); off += (uint32_t)A.lexemas.texto(l).size(); }
+    s.binario(off);
+    for (uint32_t l = 0; l < h.nLexemas; l++) s.escribir(A.lexemas.texto(l));
+    rellenar(h.tamLexemas);
+
+    if (nodo == Arbol::NINGUNO) return;
+    std::vector<uint32_t> pila{nodo};
+    while (!pila.empty()) {
+        const NodoAst &x = A[pila.back()];
+        pila.pop_back();
+        s.binario(NodoBinario{x.simbolo, x.lexema, x.nHijos});
+        for (uint32_t i = x.nHijos; i-- > 0;) pila.push_back(A.hijo(x, i));
+    }
+}
+
+// Valida una imagen del formato binario y reconstruye el árbol en 'A' (los
+// nodos quedan en preorden y los lexemas con los mismos ids). Si 'nombres'
+// no es nulo recibe los nombres de las reglas guardados en el archivo.
+inline bool leerArbolBinario(const char *base, size_t tam, Arbol &A, std::vector<std::string> *nombres, std::string &error) {
+    auto falla = [&error](const char *motivo) { error = motivo; return false; };
+    if (tam < sizeof(CabeceraAST)) return falla("archivo truncado");
+    CabeceraAST h;
+    std::memcpy(&h, base, sizeof h);
+    if (std::memcmp(h.magia, AST_MAGIA, sizeof h.magia) != 0) return falla("firma inválida");
+    if (h.orden != LRB_ORDEN) return falla("orden de bytes distinto al de esta máquina");
+    if (h.version != AST_VERSION) return falla("versión no soportada");
+    uint64_t offNombres = sizeof h, offLexemas = offNombres + h.tamNombres;
+    uint64_t offBytes = offLexemas + 4ull * (h.nLexemas + 1ull);
+    uint64_t offNodos = offBytes + ((h.tamLexemas + 3ull) & ~3ull);
+    if (h.tamNombres % 4 || offNodos + (uint64_t)h.nNodos * sizeof(NodoBinario) != tam) return falla("tamaño incorrecto");
+
+    std::vector<std::string> leidos;
+    for (uint64_t p = offNombres; leidos.size() < h.nReglas;) {
+        const char *fin = (const char*)std::memchr(base + p, '\0', offLexemas - p);
+        if (!fin) return falla("nombres de reglas truncados");
+        leidos.emplace_back(base + p, fin);
+        p = (uint64_t)(fin - base) + 1;
+    }
+    A.limpiar();
+    uint32_t anterior = 0;
+    for (uint32_t l = 0; l < h.nLexemas; l++) {
+        uint32_t ini, fin;
+        std::memcpy(&ini, base + offLexemas + 4ull * l, 4);
+        std::memcpy(&fin, base + offLexemas + 4ull * (l + 1), 4);
+        if (ini != anterior || fin < ini || fin > h.tamLexemas) return falla("lexema fuera de rango");
+        if (A.lexemas.intern(std::string_view(base + offBytes + ini, fin - ini)) != l) return falla("lexema repetido");
+        anterior = fin;
+    }
+    if (anterior != h.tamLexemas) return falla("lexemas inconsistentes");
+
+    struct Pendiente { uint32_t nodo, faltan; };
+    std::vector<Pendiente> pila;
+    A.nodos.reserve(h.nNodos);
+    A.hijos.reserve(h.nNodos ? h.nNodos - 1 : 0);
+    for (uint32_t k = 0; k < h.nNodos; k++) {
+        NodoBinario b;
+        std::memcpy(&b, base + offNodos + (uint64_t)k * sizeof b, sizeof b);
+        bool hoja = b.simbolo < 0;
+        if (hoja ? (b.simbolo < -1 - (int32_t)TokenType::FIN || b.nHijos) : (b.simbolo == 0 || (uint32_t)b.simbolo > h.nReglas))
+            return falla("símbolo inválido");
+        if (b.lexema != TablaLexemas::NINGUNO && (!hoja || b.lexema >= h.nLexemas)) return falla("lexema inválido");
+        if (b.nHijos > h.nNodos - 1 - k) return falla("demasiados hijos");
+        if (k && pila.empty()) return falla("más de una raíz");
+        if (!pila.empty()) {
+            Pendiente &p = pila.back();
+            const NodoAst &padre = A.nodos[p.nodo];
+            A.hijos[padre.primerHijo + padre.nHijos - p.faltan] = k;
+            if (--p.faltan == 0) pila.pop_back();
+        }
+        A.nodos.push_back(NodoAst{b.simbolo, b.lexema, (uint32_t)A.hijos.size(), b.nHijos});
+        if (b.nHijos) {
+            A.hijos.resize(A.hijos.size() + b.nHijos);
+            pila.push_back(Pendiente{k, b.nHijos});
+        }
+    }
+    if (!pila.empty()) return falla("faltan nodos");
+    A.raiz = h.nNodos ? 0 : Arbol::NINGUNO;
+    if (nombres) nombres->swap(leidos);
+    return true;
+}
+
+inline bool cargarArbolBinario(const std::string &path, Arbol &A, std::vector<std::string> *nombres, std::string &error) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f) { error = "no se pudo abrir " + path; return false; }
+    std::vector<char> datos((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    return leerArbolBinario(datos.data(), datos.size(), A, nombres, error);
+}
+
+/* ------------------ Entrada común ------------------ */
+inline void escribirArbol(SalidaBuffer &s, const Arbol &A, const LRGram &G, uint32_t nodo, FormatoArbol f) {
+    if (f == FormatoArbol::JSON) escribirArbolJSON(s, A, G, nodo);
+    else if (f == FormatoArbol::BINARIO) escribirArbolBinario(s, A, G, nodo);
+    else escribirArbolASCII(s, A, G, nodo);
+}
+inline void escribirArbol(std::ostream &os, const Arbol &A, const LRGram &G, uint32_t nodo, FormatoArbol f) {
+    SalidaBuffer s(os);
+    escribirArbol(s, A, G, nodo, f);
+}
+
+#endif
@@ -0,0 +1,88 @@
+// serializar_verificar.h
+// Prueba de ida y vuelta del árbol (benchmark --verificar-arbol): por el
+// formato binario se obtiene el mismo árbol, los mismos bytes al volver a
+// escribirlo y la misma salida JSON y ASCII. Incluye un árbol de 100000
+// niveles (paréntesis anidados) que con el escritor recursivo agotaba la pila.
+#ifndef SERIALIZAR_VERIFICAR_H
+#define SERIALIZAR_VERIFICAR_H
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "arbol.h"
+#include "generador.h"
+#include "lalr.h"
+#include "parser.h"
+#include "serializar.h"
+#include "verificacion.h"
+
+inline std::string serializar(const Arbol &A, const LRGram &G, FormatoArbol f){
+    std::ostringstream os;
+    escribirArbol(os, A, G, A.raiz, f);
+    return os.str();
+}
+
+inline int verificarSerializacion(ContextoVerificacion &c){
+    const LRGram &G = c.G;
+    GramaticaBNF g;
+    std::string error;
+    if(!leerProducciones(c.rutaInf, g, error)){ std::fprintf(stderr, "Error: %s\n", error.c_str()); return 1; }
+    GeneradorProgramas gen(g);
+    PruebaDiferencial prueba;
+    auto caso = [&](const std::string &entrada, bool ascii, const char *nombre){
+        Arbol a, b;
+        bool ok = parseLR(G, entrada, a).aceptada;
+        if(!ok) error = "entrada rechazada";
+        else {
+            std::string bin = serializar(a, G, FormatoArbol::BINARIO);
+            std::vector<std::string> nombres;
+            ok = leerArbolBinario(bin.data(), bin.size(), b, &nombres, error);
+            ok = ok && (int)nombres.size() == G.nReglas && mismoArbol(a, b) && serializar(b, G, FormatoArbol::BINARIO) == bin &&
+                 serializar(b, G, FormatoArbol::JSON) == serializar(a, G, FormatoArbol::JSON);
+            if(ok && ascii){
+                std::ostringstream viejo;
+                imprimirArbolASCII(viejo, a, G, a.raiz, "", true);
+                ok = serializar(b, G, FormatoArbol::ASCII) == viejo.str();
+            }
+            // Un byte menos o un nodo cambiado deben rechazarse o dar otro árbol, nunca salirse.
+            Arbol d;
+            ok = ok && !leerArbolBinario(bin.data(), bin.size() - 1, d, nullptr, error);
+        }
+        prueba.comprobar(ok, [&]{ std::fprintf(stderr, "FALLO %s: %s\n", nombre, error.c_str()); });
+    };
+    uint32_t semilla = 1;
+    const int perfiles[][2] = {{1, 1}, {3, 3}, {8, 2}, {2, 8}};
+    for(auto &pf : perfiles)
+        for(size_t tokens : {10, 200, 3000}){
+            OpcionesGenerador op;
+            op.tokens = tokens;
+            op.anidamiento = pf[0];
+            op.complejidad = pf[1];
+            op.semilla = semilla++;
+            caso(gen.generar(op), true, "generado");
+        }
+    caso("", true, "vacío");
+    caso(generarEntrada(2000000), false, "sintética 2 MB");
+    std::string profundo = "int f() { return " + std::string(100000, '(') + "1" + std::string(100000, ')') + "; }\n";
+    caso(profundo, false, "100000 niveles");
+    // Bytes alterados al azar: el lector debe rechazar o construir algo
+    // consistente, sin leer fuera de la imagen.
+    {
+        Arbol a, b;
+        parseLR(G, gen.generar(OpcionesGenerador{}), a);
+        std::string bin = serializar(a, G, FormatoArbol::BINARIO);
+        Azar azar(12345u);
+        for(int k=0;k<2000;k++){
+            std::string u = bin;
+            uint32_t x = azar();
+            u[x % u.size()] ^= (char)(1 + x % 255);
+            if(leerArbolBinario(u.data(), u.size(), b, nullptr, error)) serializar(b, G, FormatoArbol::ASCII);
+            prueba.comprobar(true, []{});
+        }
+    }
+    std::printf("Serialización del árbol (binario, JSON, ASCII): %d casos, %d fallos\n", prueba.casos, prueba.fallos);
+    return prueba.codigo();
+}
+
+#endif
@@ -0,0 +1,427 @@
+// servidor.h
+// Modo servidor: la gramática se carga una vez y el proceso queda atendiendo
+// peticiones de análisis por un socket Unix o por stdin/stdout, así que cada
+// petición ya no paga el arranque del proceso ni cargarLR/leerInf, y las
+// tablas siguen en caché entre una y otra.
+//
+// Protocolo (igual en ambos sentidos: una línea de cabecera y un cuerpo de
+// longitud fija, sin escapes):
+//   petición:  <id> <modo> <longitud>\n<longitud bytes de entrada>
+//   respuesta: <id> <OK|FALLIDO|ERROR> <us de servicio> <longitud>\n<cuerpo>
+// Modos:
+//   check   sólo aceptar/rechazar; cuerpo vacío o el mensaje de error
+//   nodos   construye el árbol; el cuerpo es el número de nodos
+//   arbol   construye el árbol; el cuerpo es el árbol ASCII del traductor
+//   json    ídem, en JSON (serializar.h)
+//   bin     ídem, en el formato binario de serializar.h (leerArbolBinario)
+//   stats   (longitud 0) estadísticas de latencia acumuladas
+//   fin     (longitud 0) responde y detiene el servidor
+// Las peticiones de una conexión se reparten entre los hilos del pool, así
+// que las respuestas pueden llegar en otro orden: el id las identifica.
+// Cada hilo reutiliza su propio Arbol. Una conexión tiene a lo sumo
+// MAX_PENDIENTES peticiones en cola o en curso y MAX_BYTES_PENDIENTES de
+// entrada (una sola si es más grande); al llegar al tope su lector deja de
+// leer el socket hasta que se responda alguna. La latencia que se acumula va desde
+// que se termina de leer la petición hasta que se escribe la respuesta
+// (espera en la cola más servicio). Sólo POSIX; compilar con -pthread.
+#ifndef SERVIDOR_H
+#define SERVIDOR_H
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SERVIDOR_UNIX 1
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "arbol.h"
+#include "gramatica.h"
+#include "parser.h"
+#include "serializar.h"
+
+/* ------------------ E/S con marcos ------------------ */
+inline bool escribirTodo(int fd, const char *p, size_t n){
+    while(n){
+        ssize_t k = ::write(fd, p, n);
+        if(k < 0 && errno == EINTR) continue;
+        if(k <= 0) return false;
+        p += k; n -= (size_t)k;
+    }
+    return true;
+}
+
+// Lectura con búfer de cabeceras (hasta '\n') y cuerpos de longitud fija.
+class LectorMarcos {
+public:
+    explicit LectorMarcos(int fd) : fd(fd), buf(64 * 1024) {}
+
+    bool leerLinea(std::string &linea, size_t maximo = 512){
+        linea.clear();
+        while(true){
+            if(ini == fin && !llenar()) return false;
+            const char *p = buf.data() + ini, *nl = (const char*)std::memchr(p, '\n', fin - ini);
+            size_t k = nl ? (size_t)(nl - p) : fin - ini;
+            linea.append(p, k);
+            ini += k + (nl ? 1 : 0);
+            if(nl) return true;
+            if(linea.size() > maximo) return false;
+        }
+    }
+    bool leer(std::string &s, size_t n){
+        s.resize(n);
+        size_t hecho = std::min(n, fin - ini);
+        std::memcpy(&s[0], buf.data() + ini, hecho);
+        ini += hecho;
+        while(hecho < n){ // lo que falta va directo al string, sin pasar por el búfer
+            ssize_t k = ::read(fd, &s[hecho], n - hecho);
+            if(k < 0 && errno == EINTR) continue;
+            if(k <= 0) return false;
+            hecho += (size_t)k;
+        }
+        return true;
+    }
+
+private:
+    int fd;
+    std::vector<char> buf;
+    size_t ini = 0, fin = 0;
+
+    bool llenar(){
+        while(true){
+            ssize_t k = ::read(fd, buf.data(), buf.size());
+            if(k < 0 && errno == EINTR) continue;
+            if(k <= 0) return false;
+            ini = 0; fin = (size_t)k;
+            return true;
+        }
+    }
+};
+
+/* ------------------ Latencias ------------------ */
+// Histograma log-lineal en microsegundos: exacto hasta 16 us y después 16
+// cubetas por potencia de dos (error < 6.25%). Memoria fija sin importar
+// cuántas peticiones se atiendan.
+class Latencias {
+public:
+    void registrar(uint64_t us){
+        cubetas[cubeta(us)]++;
+        n++;
+        suma += us;
+        maximo = std::max(maximo, us);
+    }
+    // Cota inferior de la cubeta que contiene el percentil p (0..100).
+    uint64_t percentil(double p) const {
+        if(n == 0) return 0;
+        uint64_t objetivo = (uint64_t)(p / 100.0 * (double)(n - 1)) + 1, acum = 0;
+        for(size_t i=0;i<NCUBETAS;i++){
+            acum += cubetas[i];
+            if(acum >= objetivo) return std::min(inicio(i), maximo);
+        }
+        return maximo;
+    }
+    uint64_t cuenta() const { return n; }
+    uint64_t max() const { return maximo; }
+    double media() const { return n ? (double)suma / (double)n : 0.0; }
+
+private:
+    static const size_t NCUBETAS = 64 * 16;
+    uint64_t cubetas[NCUBETAS] = {};
+    uint64_t n = 0, suma = 0, maximo = 0;
+
+    static size_t cubeta(uint64_t us){
+        if(us < 16) return (size_t)us;
+        int e = 0;
+        while((us >> e) > 1) e++;
+        return (size_t)(e - 3) * 16 + (size_t)((us >> (e - 4)) & 15);
+    }
+    static uint64_t inicio(size_t i){
+        if(i < 16) return i;
+        size_t e = i / 16 + 3;
+        return (uint64_t)(16 + i % 16) << (e - 4);
+    }
+};
+
+/* ------------------ Servidor ------------------ */
+class Servidor {
+public:
+    Servidor(const LRGram &G, unsigned nHilos) : G(G) {
+        if(nHilos == 0) nHilos = std::max(1u, std::thread::hardware_concurrency());
+        for(unsigned h=0;h<nHilos;h++) trabajadores.emplace_back([this]{ trabajar(); });
+    }
+    ~Servidor(){
+        {
+            std::lock_guard<std::mutex> g(mtx);
+            terminar = true;
+        }
+        hayPeticion.notify_all();
+        for(auto &t : trabajadores) t.join();
+    }
+    Servidor(const Servidor&) = delete;
+    Servidor& operator=(const Servidor&) = delete;
+
+    unsigned hilos() const { return (unsigned)trabajadores.size(); }
+
+    // Atiende una sola conexión sobre dos descriptores (stdin/stdout) hasta
+    // fin de entrada o una petición 'fin'.
+    void atenderFlujo(int entrada, int salida){
+        std::signal(SIGPIPE, SIG_IGN); // un cliente que se va no termina el proceso
+        auto con = std::make_shared<Conexion>(entrada, salida, false);
+        leerPeticiones(con);
+        esperarVacia();
+    }
+
+    // Escucha en un socket Unix; cada conexión tiene un hilo lector y las
+    // peticiones van a la cola común. Devuelve false si no pudo escuchar.
+    bool atenderSocket(const std::string &ruta){
+        sockaddr_un dir{};
+        dir.sun_family = AF_UNIX;
+        if(ruta.size() >= sizeof dir.sun_path){ std::cerr << "Error: ruta de socket demasiado larga: " << ruta << "\n"; return false; }
+        std::memcpy(dir.sun_path, ruta.c_str(), ruta.size() + 1);
+        std::signal(SIGPIPE, SIG_IGN);
+        // Sólo se reemplaza un socket abandonado: nunca un archivo común ni
+        // el de un servidor que sigue escuchando.
+        struct stat st;
+        if(::lstat(ruta.c_str(), &st) == 0){
+            if(!S_ISSOCK(st.st_mode)){ std::cerr << "Error: " << ruta << " existe y no es un socket; no se reemplaza\n"; return false; }
+            int prueba = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            bool activo = prueba >= 0 && ::connect(prueba, (sockaddr*)&dir, sizeof dir) == 0;
+            if(prueba >= 0) ::close(prueba);
+            if(activo){ std::cerr << "Error: ya hay un servidor escuchando en " << ruta << "\n"; return false; }
+            ::unlink(ruta.c_str());
+        }
+        escucha = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if(escucha < 0 || ::bind(escucha, (sockaddr*)&dir, sizeof dir) < 0 || ::lstat(ruta.c_str(), &st) < 0 || ::listen(escucha, 128) < 0){
+            std::cerr << "Error: no se pudo escuchar en " << ruta << ": " << std::strerror(errno) << "\n";
+            if(escucha >= 0) ::close(escucha);
+            return false;
+        }
+        dev_t dispositivo = st.st_dev;
+        ino_t nodo = st.st_ino;
+        while(!parar){
+            int fd = ::accept(escucha, nullptr, nullptr);
+            if(fd < 0){
+                if(errno == EINTR || errno == ECONNABORTED) continue;
+                break; // shutdown() desde 'fin'
+            }
+            auto con = std::make_shared<Conexion>(fd, fd, true);
+            {
+                std::lock_guard<std::mutex> g(mtxConexiones);
+                if(parar) break; // 'con' cierra el descriptor
+                abiertas.erase(std::remove_if(abiertas.begin(), abiertas.end(), [](const std::weak_ptr<Conexion> &c){ return c.expired(); }), abiertas.end());
+                abiertas.push_back(con);
+                lectores++;
+            }
+            std::thread([this, con]{
+                leerPeticiones(con);
+                std::lock_guard<std::mutex> g(mtxConexiones);
+                if(--lectores == 0) sinLectores.notify_all();
+            }).detach();
+        }
+        {   // los lectores que siguen bloqueados en read() terminan con fin de entrada
+            std::unique_lock<std::mutex> g(mtxConexiones);
+            for(auto &c : abiertas) if(auto con = c.lock()) ::shutdown(con->entrada, SHUT_RD);
+            sinLectores.wait(g, [this]{ return lectores == 0; });
+        }
+        esperarVacia();
+        {
+            std::lock_guard<std::mutex> g(mtxConexiones);
+            ::close(escucha);
+            escucha = -1;
+        }
+        // Se borra sólo si la ruta sigue siendo el socket que creó este proceso.
+        struct stat fin;
+        if(::lstat(ruta.c_str(), &fin) == 0 && S_ISSOCK(fin.st_mode) && fin.st_dev == dispositivo && fin.st_ino == nodo)
+            ::unlink(ruta.c_str());
+        return true;
+    }
+
+    std::string estadisticas(){
+        std::lock_guard<std::mutex> g(mtxEst);
+        std::ostringstream os;
+        os << "peticiones " << lat.cuenta() << " (aceptadas " << aceptadas << ", fallidas " << fallidas << ", erróneas " << erroneas
+           << "), entrada " << bytesEntrada / 1e6 << " MB, " << hilos() << " hilos, " << pausas << " pausas por cola llena\n"
+           << "latencia us: media " << (uint64_t)lat.media() << ", p50 " << lat.percentil(50) << ", p90 " << lat.percentil(90)
+           << ", p99 " << lat.percentil(99) << ", max " << lat.max() << "\n";
+        return os.str();
+    }
+
+private:
+    enum class Modo { CHECK, NODOS, ARBOL };
+
+    struct Conexion {
+        int entrada, salida;
+        bool propia; // socket: se cierra al soltar la última referencia
+        std::mutex mtxEscritura;
+        size_t pendientes = 0, bytesPendientes = 0; // en cola o en curso; protegidos por Servidor::mtx
+        Conexion(int e, int s, bool p) : entrada(e), salida(s), propia(p) {}
+        ~Conexion(){ if(propia) ::close(entrada); }
+        void responder(const std::string &id, const char *estado, uint64_t us, const std::string &cuerpo){
+            std::string m = id + " " + estado + " " + std::to_string(us) + " " + std::to_string(cuerpo.size()) + "\n";
+            m += cuerpo;
+            std::lock_guard<std::mutex> g(mtxEscritura);
+            escribirTodo(salida, m.data(), m.size()); // si el cliente se fue, la respuesta se pierde
+        }
+    };
+
+    struct Peticion {
+        std::shared_ptr<Conexion> con;
+        std::string id, texto;
+        Modo modo;
+        FormatoArbol formato = FormatoArbol::ASCII; // Modo::ARBOL
+        std::chrono::steady_clock::time_point llegada;
+    };
+
+    static const size_t MAX_ENTRADA = (size_t)1 << 30;
+    static const size_t MAX_PENDIENTES = 64;
+    static const size_t MAX_BYTES_PENDIENTES = (size_t)64 << 20;
+
+    const LRGram &G;
+    std::vector<std::thread> trabajadores;
+    std::mutex mtx;
+    std::condition_variable hayPeticion, vacia, hayLugar;
+    std::deque<Peticion> cola;
+    size_t enCurso = 0;
+    bool terminar = false;
+
+    std::atomic<bool> parar{false};
+    int escucha = -1;
+    std::mutex mtxConexiones;
+    std::condition_variable sinLectores;
+    std::vector<std::weak_ptr<Conexion>> abiertas;
+    size_t lectores = 0;
+
+    std::mutex mtxEst;
+    Latencias lat;
+    uint64_t aceptadas = 0, fallidas = 0, erroneas = 0, bytesEntrada = 0, pausas = 0;
+
+    void leerPeticiones(const std::shared_ptr<Conexion> &con){
+        LectorMarcos lector(con->entrada);
+        std::string cabecera;
+        while(!parar && lector.leerLinea(cabecera)){
+            std::istringstream is(cabecera);
+            std::string id, modo;
+            long long lon = -1;
+            if(!(is >> id >> modo >> lon) || lon < 0 || (size_t)lon > MAX_ENTRADA){
+                con->responder(id.empty() ? "-" : id, "ERROR", 0, "cabecera inválida: " + cabecera + "\n");
+                std::lock_guard<std::mutex> g(mtxEst);
+                erroneas++;
+                return; // sin una longitud válida no se puede seguir leyendo el flujo
+            }
+            if(modo == "check" || modo == "nodos" || modo == "arbol" || modo == "json" || modo == "bin"){
+                // Contrapresión: con la cola de esta conexión llena no se lee
+                // más; los trabajadores siempre la vacían, así que no se queda.
+                std::unique_lock<std::mutex> g(mtx);
+                auto hayTope = [&]{ return con->pendientes == 0 ||
+                    (con->pendientes < MAX_PENDIENTES && con->bytesPendientes + (size_t)lon <= MAX_BYTES_PENDIENTES); };
+                if(!hayTope()){
+                    { std::lock_guard<std::mutex> ge(mtxEst); pausas++; }
+                    hayLugar.wait(g, hayTope);
+                }
+            }
+            Peticion p;
+            if(!lector.leer(p.texto, (size_t)lon)) return;
+            p.llegada = std::chrono::steady_clock::now();
+            if(modo == "stats"){ con->responder(id, "OK", 0, estadisticas()); continue; }
+            if(modo == "fin"){ con->responder(id, "OK", 0, ""); detener(); return; }
+            if(modo == "check") p.modo = Modo::CHECK;
+            else if(modo == "nodos") p.modo = Modo::NODOS;
+            else if(modo == "arbol" || modo == "json" || modo == "bin"){
+                p.modo = Modo::ARBOL;
+                if(modo != "arbol") leerFormatoArbol(modo, p.formato);
+            }
+            else {
+                con->responder(id, "ERROR", 0, "modo desconocido: " + modo + "\n");
+                std::lock_guard<std::mutex> g(mtxEst);
+                erroneas++;
+                continue;
+            }
+            p.con = con;
+            p.id = std::move(id);
+            {
+                std::lock_guard<std::mutex> g(mtx);
+                con->pendientes++;
+                con->bytesPendientes += p.texto.size();
+                cola.push_back(std::move(p));
+            }
+            hayPeticion.notify_one();
+        }
+    }
+
+    void detener(){
+        parar = true;
+        std::lock_guard<std::mutex> g(mtxConexiones);
+        if(escucha >= 0) ::shutdown(escucha, SHUT_RDWR); // despierta a accept()
+    }
+
+    void esperarVacia(){
+        std::unique_lock<std::mutex> g(mtx);
+        vacia.wait(g, [this]{ return cola.empty() && enCurso == 0; });
+    }
+
+    void trabajar(){
+        Arbol arbol;
+        while(true){
+            Peticion p;
+            {
+                std::unique_lock<std::mutex> g(mtx);
+                hayPeticion.wait(g, [this]{ return terminar || !cola.empty(); });
+                if(cola.empty()) return;
+                p = std::move(cola.front());
+                cola.pop_front();
+                enCurso++;
+            }
+            auto t0 = std::chrono::steady_clock::now();
+            Diagnostico d;
+            std::string cuerpo;
+            if(p.modo == Modo::CHECK){
+                d = reconocerLR(G, p.texto);
+            } else {
+                d = parseLR(G, p.texto, arbol);
+                if(d.aceptada && p.modo == Modo::NODOS) cuerpo = std::to_string(arbol.nodos.size()) + "\n";
+                else if(d.aceptada){
+                    std::ostringstream os;
+                    escribirArbol(os, arbol, G, arbol.raiz, p.formato);
+                    cuerpo = os.str();
+                }
+            }
+            if(!d.aceptada) cuerpo = d.mensaje + "\n";
+            auto t1 = std::chrono::steady_clock::now();
+            p.con->responder(p.id, d.aceptada ? "OK" : "FALLIDO", (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count(), cuerpo);
+            uint64_t us = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - p.llegada).count();
+            {
+                std::lock_guard<std::mutex> g(mtxEst);
+                lat.registrar(us);
+                (d.aceptada ? aceptadas : fallidas)++;
+                bytesEntrada += p.texto.size();
+            }
+            {
+                std::lock_guard<std::mutex> g(mtx);
+                p.con->pendientes--;
+                p.con->bytesPendientes -= p.texto.size();
+            }
+            hayLugar.notify_all();
+            p = Peticion(); // suelta la conexión antes de avisar
+            std::lock_guard<std::mutex> g(mtx);
+            if(--enCurso == 0 && cola.empty()) vacia.notify_all();
+        }
+    }
+};
+
+#endif // unix
+#endif
@@ -1,332 +1,329 @@
 // compilador_lr_parser.cpp
-// Compilar: g++ -std=c++17 compilador_lr_parser.cpp -o compilador_lr_parser
+// Compilar: g++ -std=c++17 -pthread compilador_lr_parser.cpp -o compilador_lr_parser
 // Ejecutar: ./compilador_lr_parser compilador.lr compilador.inf < entrada.txt
+//           ./compilador_lr_parser --tabla compilador.lrb [compilador.lr compilador.inf] < entrada.txt
+//           --check: sólo acepta/rechaza la entrada (mismos errores, sin construir el árbol)
+//           --bloque KB: tamaño del bloque de lectura cuando stdin no es un archivo regular (1024 por defecto)
+//           --lote <directorio|lista.txt> [--hilos N]: valida cada archivo (en el orden de la lista, o
+//               lexicográfico si es un directorio) cargando la gramática una sola vez; requiere -pthread
+//           --pipeline: el lexer corre en otro hilo y pasa los tokens al parser por un anillo (tuberia.h)
+//           --paralelo [--hilos N]: analiza en paralelo las definiciones de primer nivel (mismo árbol;
+//               con --check sólo las reconoce)
+//           --reporte-tabla: imprime en stderr la compresión y el costo de consulta de la tabla (y los
+//               atajos, si se pidieron)
+//           --atajos: aplica de una vez las cadenas de reducciones que siguen a un goto (parser.h)
+//           --servidor <socket|-> [--hilos N]: queda atendiendo peticiones por un socket Unix o por
+//               stdin/stdout (protocolo en servidor.h) con la gramática ya cargada
+//           sin .lr/.inf ni --tabla: usa las tablas embebidas (gramatica_embebida.h, generada con
+//               compilartabla --embebida) si al compilar estaba presente
+//           --stats json|chrome [--stats-salida archivo]: cuenta acciones por estado y por regla, tokens por
+//               tipo y profundidad de pila, y reparte el tiempo entre lexer, tabla, árbol y salida
+//               (estadisticas.h); el reporte va a stderr o al archivo indicado
+//           --arbol ascii|json|bin [--arbol-salida archivo]: formato del árbol (serializar.h); con
+//               --arbol-salida el árbol va al archivo en lugar de stdout (bin lo requiere)
+//           --semantica: revisa declaraciones, usos, llamadas y tipos (semantica.h); reporta todos los
+//               errores y el tiempo de cada fase en stderr
+//           --ejecutar: compila el programa aceptado a bytecode (bytecode.h) y ejecuta main() en la VM
+//               (vm.h); la salida de print va a stdout. --bytecode imprime el listado del bytecode.
+//               Antes de compilar se hace el análisis semántico
+//           --directo: usa el parser generado por generarparser (parser_generado.h) si al compilar
+//               estaba presente y corresponde a la tabla cargada
+//           --lexico <archivo.lex>: los tokens los da el autómata mínimo construido desde las definiciones
+//               del archivo (automata_lexico.h) en lugar de LexerRapido; sólo en el análisis secuencial
+//           --optimizar: antes de imprimir, revisar o compilar el árbol quita los nodos vacíos, reduce las
+//               cadenas de un solo hijo y pliega las expresiones constantes (optimizar.h); reporta en
+//               stderr los nodos y el tiempo de cada pasada
 
 #include <bits/stdc++.h>
+#include "arbol.h"
+#include "automata_lexico.h"
+#include "bytecode.h"
+#include "estadisticas.h"
+#include "flujo.h"
+#include "gramatica.h"
+#include "lexer.h"
+#include "lote.h"
+#include "optimizar.h"
+#include "parser.h"
+#include "parser_paralelo.h"
+#include "semantica.h"
+#include "serializar.h"
+#include "servidor.h"
+#include "tuberia.h"
+#include "vm.h"
+#if __has_include("gramatica_embebida.h") // ./compilartabla --embebida compilador.lr compilador.inf gramatica_embebida.h
+#include "gramatica_embebida.h"
+#define HAY_GRAMATICA_EMBEBIDA
+#endif
+#if __has_include("parser_generado.h") // ./generarparser compilador.lr compilador.inf parser_generado.h
+#include "parser_generado.h"
+#define HAY_PARSER_DIRECTO
+#endif
 using namespace std;
 
-/* ------------------ Definición de Tokens ------------------ */
-enum class TokenType {
-    IDENT, ENTERO, REAL, CADENA,
-    TIPO_INT, TIPO_FLOAT,
-    OP_SUMA, OP_MUL, OP_ASIG,
-    OP_RELAC, OP_AND, OP_OR, OP_NOT, OP_IGUALDAD,
-    PUNTO_Y_COMA, COMA,
-    PARENTESIS_ABRE, PARENTESIS_CIERRA,
-    LLAVE_ABRE, LLAVE_CIERRA,
-    RESERVADA_IF, RESERVADA_WHILE, RESERVADA_RETURN, RESERVADA_ELSE,
-    DESCONOCIDO, FIN
-};
-
-struct Token {
-    TokenType type;
-    string lexeme;
-    size_t pos; // Posición inicial del lexema en la cadena de entrada
-    // Podríamos añadir línea y columna para un reporte de errores más preciso
-    // size_t line;
-    // size_t col;
-};
-
-static bool esLetra(char c){ return isalpha((unsigned char)c)!=0; }
-
-/* ------------------ LEXER ------------------ */
-class Lexer {
-public:
-    explicit Lexer(const string& src) : s(src), n(src.size()), i(0) {}
-    Token next(){
-        saltarBlancos();
-        if (i >= n) return {TokenType::FIN, "$", i};
-        char c = s[i];
-
-        // Identificadores y palabras reservadas
-        if (esLetra(c)) {
-            size_t start = i++;
-            while (i < n && (esLetra(s[i]) || isdigit((unsigned char)s[i]))) ++i;
-            string lex = s.substr(start, i-start);
-            if (lex=="if") return {TokenType::RESERVADA_IF, lex, start};
-            if (lex=="while") return {TokenType::RESERVADA_WHILE, lex, start};
-            if (lex=="return") return {TokenType::RESERVADA_RETURN, lex, start};
-            if (lex=="else") return {TokenType::RESERVADA_ELSE, lex, start};
-            if (lex=="int") return {TokenType::TIPO_INT, lex, start};
-            if (lex=="float") return {TokenType::TIPO_FLOAT, lex, start};
-            return {TokenType::IDENT, lex, start};
-        }
-
-        // Números (Entero y Real)
-        if (isdigit((unsigned char)c)) {
-            size_t start = i++;
-            while (i < n && isdigit((unsigned char)s[i])) ++i;
-            if (i < n && s[i]=='.') {
-                size_t p = i++; // Guarda la posición del punto
-                if (i < n && isdigit((unsigned char)s[i])) {
-                    while (i < n && isdigit((unsigned char)s[i])) ++i;
-                    return {TokenType::REAL, s.substr(start, i-start), start};
-                } else {
-                    // Si hay un punto pero no dígitos después, retrocede y trata como entero
-                    i = p;
-                }
-            }
-            return {TokenType::ENTERO, s.substr(start, i-start), start};
-        }
-
-        // Cadenas
-        if (c=='"') {
-            size_t start = i++;
-            while (i<n && s[i]!='"') i++;
-            if (i<n) i++; // Consumir la comilla de cierre
-            return {TokenType::CADENA, s.substr(start, i-start), start};
-        }
-
-        // Operadores y símbolos
-        if (c=='+'){ i++; return {TokenType::OP_SUMA, "+", i-1}; }
-        if (c=='-'){ i++; return {TokenType::OP_SUMA, "-", i-1}; }
-        if (c=='*'){ i++; return {TokenType::OP_MUL, "*", i-1}; }
-        if (c=='/'){ i++; return {TokenType::OP_MUL, "/", i-1}; }
-        if (c=='='){
-            if (i+1 < n && s[i+1]=='='){ i+=2; return {TokenType::OP_IGUALDAD,"==",i-2}; }
-            i++; return {TokenType::OP_ASIG, "=", i-1};
-        }
-        if (c=='!'){
-            if (i+1<n && s[i+1]=='='){ i+=2; return {TokenType::OP_IGUALDAD,"!=",i-2}; }
-            i++; return {TokenType::OP_NOT,"!",i-1};
-        }
-        if (c=='<' || c=='>'){
-            // Manejo de <= y >=
-            if (i+1 < n && s[i+1]=='='){ i+=2; return {TokenType::OP_RELAC, s.substr(i-2,2), i-2}; }
-            i++; return {TokenType::OP_RELAC, string(1,c), i-1};
-        }
-        if (c=='&' && i+1<n && s[i+1]=='&'){ i+=2; return {TokenType::OP_AND,"&&",i-2}; }
-        if (c=='|' && i+1<n && s[i+1]=='|'){ i+=2; return {TokenType::OP_OR,"||",i-2}; }
-
-        if (c==';'){ i++; return {TokenType::PUNTO_Y_COMA, ";", i-1}; }
-        if (c==','){ i++; return {TokenType::COMA, ",", i-1}; }
-        if (c=='('){ i++; return {TokenType::PARENTESIS_ABRE, "(", i-1}; }
-        if (c==')'){ i++; return {TokenType::PARENTESIS_CIERRA, ")", i-1}; }
-        if (c=='{'){ i++; return {TokenType::LLAVE_ABRE, "{", i-1}; }
-        if (c=='}'){ i++; return {TokenType::LLAVE_CIERRA, "}", i-1}; }
+/* ------------------ MAIN ------------------ */
+int main(int argc, char **argv){
+    ios::sync_with_stdio(false);
+    cin.tie(nullptr);
 
-        // Desconocido
-        size_t start = i++;
-        return {TokenType::DESCONOCIDO, s.substr(start,1), start};
+    string rutaLRB, rutaLexico, origenLote, rutaServidor, formatoStats, rutaStats, formatoArbol = "ascii", rutaArbol;
+    unsigned nHilos = 0;
+    bool reporte = false, soloVerificar = false, enTuberia = false, enParalelo = false, directo = false, ejecutar = false, listado = false, semantica = false, optimizar = false, atajos = false;
+    size_t tamBloque = LexerFlujo::BLOQUE_DEFECTO;
+    vector<string> rutas;
+    for(int i=1;i<argc;i++){
+        string arg = argv[i];
+        if(arg == "--tabla" && i+1 < argc) rutaLRB = argv[++i];
+        else if(arg == "--reporte-tabla") reporte = true;
+        else if(arg == "--atajos") atajos = true;
+        else if(arg == "--check") soloVerificar = true;
+        else if(arg == "--pipeline") enTuberia = true;
+        else if(arg == "--paralelo") enParalelo = true;
+        else if(arg == "--directo") directo = true;
+        else if(arg == "--ejecutar") ejecutar = true;
+        else if(arg == "--bytecode") listado = true;
+        else if(arg == "--semantica") semantica = true;
+        else if(arg == "--optimizar") optimizar = true;
+        else if(arg == "--lexico" && i+1 < argc) rutaLexico = argv[++i];
+        else if(arg == "--stats" && i+1 < argc) formatoStats = argv[++i];
+        else if(arg == "--stats-salida" && i+1 < argc) rutaStats = argv[++i];
+        else if(arg == "--arbol" && i+1 < argc) formatoArbol = argv[++i];
+        else if(arg == "--arbol-salida" && i+1 < argc) rutaArbol = argv[++i];
+        else if(arg == "--lote" && i+1 < argc) origenLote = argv[++i];
+        else if(arg == "--servidor" && i+1 < argc) rutaServidor = argv[++i];
+        else if(arg == "--hilos" && i+1 < argc) nHilos = (unsigned)atoi(argv[++i]);
+        else if(arg == "--bloque" && i+1 < argc) tamBloque = (size_t)atoll(argv[++i]) * 1024;
+        else rutas.push_back(arg);
     }
-private:
-    const string& s;
-    size_t n;
-    size_t i;
-    void saltarBlancos(){
-        while (i<n && isspace((unsigned char)s[i])) ++i;
+#ifdef HAY_GRAMATICA_EMBEBIDA
+    bool embebida = rutas.size() < 2 && rutaLRB.empty();
+#else
+    bool embebida = false;
+#endif
+    if(rutas.size() < 2 && rutaLRB.empty() && !embebida){
+        cerr << "Uso: " << argv[0] << " <archivo_gramatica.lr> <archivo_mapeo.inf> < entrada.txt\n";
+        cerr << "     " << argv[0] << " --check <archivo_gramatica.lr> <archivo_mapeo.inf> < entrada.txt   (sin árbol)\n";
+        cerr << "     " << argv[0] << " --tabla <tabla.lrb> [<archivo_gramatica.lr> <archivo_mapeo.inf>] < entrada.txt\n";
+        cerr << "     " << argv[0] << " --lote <directorio|lista.txt> [--hilos N] <archivo_gramatica.lr> <archivo_mapeo.inf>\n";
+        cerr << "     " << argv[0] << " --servidor <socket|-> [--hilos N] <archivo_gramatica.lr> <archivo_mapeo.inf>\n";
+        return 1;
     }
-};
-
-/* ------------------ LR Loader ------------------ */
-struct LRGram {
-    int nReglas;
-    vector<int> idRegla;
-    vector<int> lonRegla;
-    vector<string> nomRegla;
-    int nFilas, nCols;
-    vector<vector<int>> tabla;
-};
 
-bool cargarLR(const string &path, LRGram &G){
-    ifstream f(path);
-    if(!f) { cerr<<"Error: No se puede abrir el archivo LR: "<<path<<"\n"; return false; }
-    if(!(f >> G.nReglas)){ cerr<<"Error de formato .lr: nReglas\n"; return false; }
-    G.idRegla.resize(G.nReglas);
-    G.lonRegla.resize(G.nReglas);
-    G.nomRegla.resize(G.nReglas);
-    for(int i=0;i<G.nReglas;i++){
-        int id, lon; string nombre;
-        f >> id >> lon >> nombre;
-        G.idRegla[i] = id;
-        G.lonRegla[i] = lon;
-        G.nomRegla[i] = nombre;
+    FormatoArbol formato;
+    if(!leerFormatoArbol(formatoArbol, formato)){
+        cerr << "Error: --arbol acepta 'ascii', 'json' o 'bin'.\n";
+        return 1;
     }
-    if(!(f >> G.nFilas >> G.nCols)){ cerr<<"Error de formato .lr: dimensiones de tabla\n"; return false; }
-    G.tabla.assign(G.nFilas, vector<int>(G.nCols, 0));
-    for(int r=0;r<G.nFilas;r++)
-        for(int c=0;c<G.nCols;c++)
-            f >> G.tabla[r][c];
-    return true;
-}
-
-unordered_map<string,int> leerInf(const string &path){
-    unordered_map<string,int> mapa;
-    ifstream f(path);
-    if(!f) { cerr<<"Error: No se puede abrir el archivo INF: "<<path<<"\n"; return mapa; }
-    string key; int val;
-    while(f >> key >> val){
-        mapa[key] = val;
+    if(formato == FormatoArbol::BINARIO && rutaArbol.empty()){
+        cerr << "Error: --arbol bin requiere --arbol-salida <archivo>.\n";
+        return 1;
     }
-    return mapa;
-}
 
-/* ------------------ Token -> clave de .inf ------------------ */
-string tokenToKey(const Token &t){
-    switch(t.type){
-        case TokenType::IDENT: return "identificador";
-        case TokenType::ENTERO: return "entero";
-        case TokenType::REAL: return "real";
-        case TokenType::CADENA: return "cadena";
-        case TokenType::TIPO_INT:
-        case TokenType::TIPO_FLOAT: return "tipo"; // Agrupados como "tipo"
-        case TokenType::OP_SUMA: return "opSuma";
-        case TokenType::OP_MUL: return "opMul";
-        case TokenType::OP_ASIG: return "=";
-        case TokenType::OP_RELAC: return "opRelac";
-        case TokenType::OP_AND: return "opAnd";
-        case TokenType::OP_OR: return "opOr";
-        case TokenType::OP_NOT: return "opNot";
-        case TokenType::OP_IGUALDAD: return "opIgualdad";
-        case TokenType::PUNTO_Y_COMA: return ";";
-        case TokenType::COMA: return ",";
-        case TokenType::PARENTESIS_ABRE: return "(";
-        case TokenType::PARENTESIS_CIERRA: return ")";
-        case TokenType::LLAVE_ABRE: return "{";
-        case TokenType::LLAVE_CIERRA: return "}";
-        case TokenType::RESERVADA_IF: return "if";
-        case TokenType::RESERVADA_WHILE: return "while";
-        case TokenType::RESERVADA_RETURN: return "return";
-        case TokenType::RESERVADA_ELSE: return "else";
-        case TokenType::FIN: return "$";
-        case TokenType::DESCONOCIDO: return "DESCONOCIDO"; // Para errores léxicos
-        default: return t.lexeme; // Fallback, aunque DESCONOCIDO debería cubrirlo
+    LRGram G;
+    bool cargada = false;
+#ifdef HAY_GRAMATICA_EMBEBIDA
+    if(embebida){ gramatica_embebida::cargar(G); cargada = true; }
+#endif
+    if(!rutaLRB.empty()){
+        cargada = cargarLRB(rutaLRB, G);
+        if(!cargada && rutas.size() >= 2) cerr << "Aviso: se usará la tabla de texto (.lr/.inf).\n";
     }
-}
-
-/* ------------------ Parser LR ------------------ */
-bool parseLR(const LRGram &G, const unordered_map<string,int> &mapa, const string &entrada){
-    Lexer lx(entrada);
-    std::stack<Nodo*> pilaSemantica; // pila para construir AST
-    stack<int> estados;
-    estados.push(0); // Estado inicial
-
-    Token tk = lx.next();
-    while(true){
-        string key = tokenToKey(tk);
-
-        // Manejo de errores léxicos antes del parsing
-        if (tk.type == TokenType::DESCONOCIDO) {
-            cerr << "Error léxico: Carácter desconocido '" << tk.lexeme << "' en posición " << tk.pos << "\n";
-            return false; // Detener el parsing ante un error léxico
-        }
-
-        auto it = mapa.find(key);
-        if(it == mapa.end()){
-            cerr << "Error sintáctico: Token '" << key << "' (lexeme='" << tk.lexeme << "') en posición " << tk.pos << " no tiene mapeo en el archivo .inf. Esto puede indicar un token inesperado o una configuración incorrecta.\n";
-            return false;
+    if(!cargada){
+        if(rutas.size() < 2) return 1;
+        if(!cargarLR(rutas[0], G)) return 1;
+        if(!leerInf(rutas[1], G)){
+            cerr << "Error: El archivo .inf está vacío o no se pudo leer.\n";
+            return 1;
         }
-        int col = it->second;
-        int estado = estados.top();
-        int accion = G.tabla[estado][col];
-
-        // cout << "Estado: " << estado << ", Token: " << key << " (col " << col << "), Accion: " << accion << "\n"; // Debugging
-
-        if(accion > 0){ // Shift (Desplazamiento)
-            estados.push(accion);
-
-            // Crear nodo hoja para el token desplazado
-            {
-                std::string lbl = tokenToKey(tk);
-                if(tk.type==TokenType::IDENT || tk.type==TokenType::ENTERO || tk.type==TokenType::REAL || tk.type==TokenType::CADENA){
-                    lbl += ":" + tk.lexeme;
-                }
-                Nodo* hoja = new Nodo(lbl);
-                pilaSemantica.push(hoja);
-            }
-            tk = lx.next(); // Leer el siguiente token
-        } else if(accion < 0){ // Reduce (Reducción)
-            int regla = -accion;
-            if(regla <=0 || regla > G.nReglas){
-                cerr << "Error sintáctico: Regla inválida " << regla << " en estado " << estado << " con token '" << key << "'\n";
-                return false;
-            }
-            int lon = G.lonRegla[regla-1];
-            for(int i=0;i<lon;i++) {
-                if(!estados.empty()) estados.pop();
-                else {
-                    cerr << "Error interno del parser: Pila vacía durante reducción de la regla " << regla << "\n";
-                    return false;
-                }
-            }
-            int estadoPrev = estados.top();
-            int idNoTerm = G.idRegla[regla-1];
-            int gotoEstado = G.tabla[estadoPrev][idNoTerm];
-            if(gotoEstado==0){
-                cerr << "Error sintáctico: Goto inválido (0) después de reducción de la regla " << G.nomRegla[regla-1] << " en estado " << estadoPrev << " con no-terminal " << idNoTerm << "\n";
-                return false;
-            }
-            estados.push(gotoEstado);
-
-            // Construir nodo padre para la regla reducida
-            {
-                std::vector<Nodo*> hijos_rev;
-                for(int i=0;i<lon;i++){
-                    if(!pilaSemantica.empty()){
-                        hijos_rev.push_back(pilaSemantica.top());
-                        pilaSemantica.pop();
-                    }
-                }
-                std::vector<Nodo*> hijos;
-                for(auto it = hijos_rev.rbegin(); it != hijos_rev.rend(); ++it) hijos.push_back(*it);
-                Nodo* padre = new Nodo(G.nomRegla[regla-1]);
-                for(auto h: hijos) padre->hijos.push_back(h);
-                pilaSemantica.push(padre);
-            }
-
-            // Condición de aceptación: Si el token actual es FIN ($) y el estado en la pila es 1 (estado de aceptación de la gramática aumentada)
-            if(key == "$" && estados.top()==1){
-                cout << "Entrada aceptada.\n";
-                
-                // Imprimir AST si existe
-                if(!pilaSemantica.empty()){
-                    Nodo* raiz = pilaSemantica.top();
-                    std::cout << "\nÁrbol sintáctico (ASCII):\n";
-                    imprimirArbolASCII(raiz, "", true);
-                }
-return true;
-            }
-        } else { // 0 = Error sintáctico
-            cerr << "Error sintáctico: No se esperaba el token '" << key << "' (lexeme='" << tk.lexeme << "') en estado " << estado << " en la posición " << tk.pos << ".\n";
-            return false;
+    }
+    resolverTokens(G);
+    if(atajos) construirAtajos(G);
+    if(reporte){ reporteTabla(G, cerr); if(atajos) reporteAtajos(G, cerr); }
+    TablaLexica lexico;
+    if(!rutaLexico.empty()){
+        string error;
+        if(!cargarLexico(rutaLexico, lexico, error)){
+            cerr << "Error: " << error << "\n";
+            return 1;
         }
+        if(reporte) reporteLexico(lexico, cerr);
+        if(enTuberia || enParalelo || !origenLote.empty() || !rutaServidor.empty())
+            cerr << "Aviso: --lexico sólo se usa en el análisis secuencial; con --pipeline, --paralelo, --lote o --servidor se usa LexerRapido.\n";
     }
-    // Si el bucle termina sin aceptación explícita (ej. por un FIN inesperado o error)
-    return false;
-}
-
-/* ------------------ MAIN ------------------ */
-int main(int argc, char **argv){
-    ios::sync_with_stdio(false);
-    cin.tie(nullptr);
-
-    if(argc < 3){
-        cerr << "Uso: " << argv[0] << " <archivo_gramatica.lr> <archivo_mapeo.inf> < entrada.txt\n";
+    if(!formatoStats.empty() && formatoStats != "json" && formatoStats != "chrome"){
+        cerr << "Error: --stats acepta 'json' o 'chrome'.\n";
         return 1;
     }
-
-    LRGram G;
-    if(!cargarLR(argv[1], G)) return 1;
-
-    auto mapa = leerInf(argv[2]);
-    if(mapa.empty()){
-        cerr << "Error: El archivo .inf está vacío o no se pudo leer.\n";
+    if(!formatoStats.empty() && (enTuberia || enParalelo || directo || !origenLote.empty() || !rutaServidor.empty())){
+        cerr << "Aviso: --stats sólo instrumenta el análisis secuencial con tabla; se ignora.\n";
+        formatoStats.clear();
+    }
+    bool compilar = ejecutar || listado;
+    bool operadores = compilar || optimizar; // el plegado necesita el texto de los operadores
+    if((semantica || optimizar || compilar) && soloVerificar){
+        cerr << "Aviso: --semantica, --optimizar, --ejecutar y --bytecode necesitan el árbol; se ignora --check.\n";
+        soloVerificar = false;
+    }
+#ifdef HAY_PARSER_DIRECTO
+    if(directo && huellaGramatica(G) != parser_generado::HUELLA){
+        cerr << "Aviso: parser_generado.h corresponde a otra tabla; se usará la tabla cargada.\n";
+        directo = false;
+    }
+#else
+    if(directo){
+        cerr << "Aviso: compilado sin parser_generado.h; se usará la tabla cargada.\n";
+        directo = false;
+    }
+#endif
+
+    if(!rutaServidor.empty()){
+#ifdef SERVIDOR_UNIX
+        Servidor srv(G, nHilos);
+        cerr << "Servidor listo (" << srv.hilos() << " hilos) en " << (rutaServidor == "-" ? string("stdin/stdout") : rutaServidor) << "\n";
+        bool ok = true;
+        if(rutaServidor == "-") srv.atenderFlujo(0, 1);
+        else ok = srv.atenderSocket(rutaServidor);
+        cerr << srv.estadisticas();
+        return ok ? 0 : 1;
+#else
+        cerr << "Error: el modo servidor sólo está disponible en sistemas POSIX.\n";
         return 1;
+#endif
     }
 
-    string entrada, linea;
-    while(getline(cin, linea)){
-        entrada += linea + "\n";
+    if(!origenLote.empty()){
+        vector<string> archivos;
+        if(!rutasLote(origenLote, archivos)) return 1;
+        PoolTrabajo pool(nHilos);
+        auto t0 = chrono::steady_clock::now();
+        vector<ResultadoLote> res = analizarLote(G, archivos, pool, false);
+        double seg = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        size_t aceptados = 0;
+        for(size_t i=0;i<archivos.size();i++){
+            cout << archivos[i] << ": ";
+            if(!res[i].abierto) cout << "ERROR: no se pudo abrir\n";
+            else if(res[i].errorLectura) cout << "ERROR: error de lectura\n";
+            else if(res[i].diag.aceptada){ cout << "OK\n"; aceptados++; }
+            else cout << "FALLIDO: " << res[i].diag.mensaje << "\n";
+        }
+        cerr << "Lote: " << aceptados << "/" << archivos.size() << " aceptados, " << pool.size() << " hilos, "
+             << seg << " s (" << (seg > 0 ? archivos.size() / seg : 0) << " archivos/s)\n";
+        return aceptados == archivos.size() ? 0 : 1;
     }
 
+    // stdin se analiza por bloques (o proyectado si es un archivo regular),
+    // sin copiarlo antes a un string.
+    AutomataLexico automata = lexico.vista();
+    LexerFlujo lx(stdin, tamBloque, rutaLexico.empty() ? nullptr : &automata);
     cout << "Iniciando análisis léxico y sintáctico...\n";
-    bool ok = parseLR(G, mapa, entrada);
+    Arbol arbol;
+    Diagnostico d;
+    optional<EstadisticasLR> est;
+    if(!formatoStats.empty()) est.emplace(G);
+    auto tAnalisis = chrono::steady_clock::now();
+    if(est){
+        uint64_t t0 = EstadisticasLR::reloj();
+        if(soloVerificar){ SoloReconocer cons; d = analizarLR(G, lx, cons, *est); }
+        else { ConstruirArbol cons(arbol, operadores); d = analizarLR(G, lx, cons, *est); }
+        est->tTotal = EstadisticasLR::reloj() - t0;
+    } else if(enParalelo){ // necesita la entrada completa
+        PoolTrabajo pool(nHilos);
+        d = soloVerificar ? reconocerLRParalelo(G, lx.completa(), pool) : parseLRParalelo(G, lx.completa(), arbol, pool, operadores);
+    } else if(enTuberia){ // el hilo del lexer necesita la entrada completa
+        string_view completa = lx.completa();
+        if(soloVerificar){ SoloReconocer cons; d = analizarEnTuberia(G, completa, cons); }
+        else { ConstruirArbol cons(arbol, operadores); d = analizarEnTuberia(G, completa, cons); }
+#ifdef HAY_PARSER_DIRECTO
+    } else if(directo){
+        if(soloVerificar){ SoloReconocer cons; d = parser_generado::analizar(lx, cons); }
+        else { ConstruirArbol cons(arbol, operadores); d = parser_generado::analizar(lx, cons); }
+#endif
+    } else if(soloVerificar){
+        SoloReconocer cons;
+        d = analizarLR(G, lx, cons);
+    } else {
+        ConstruirArbol cons(arbol, operadores);
+        d = analizarLR(G, lx, cons);
+    }
+    double msSintactico = chrono::duration<double, milli>(chrono::steady_clock::now() - tAnalisis).count();
+    // Lo leído antes de un error de lectura puede ser un programa válido: no
+    // se da por aceptada una entrada que no se leyó completa.
+    bool ok = d.aceptada && !lx.errorLectura();
+    if(lx.errorLectura()) cerr << "Error: error de lectura en la entrada estándar; se analizó sólo lo leído hasta ahí.\n";
+    else if(!ok) cerr << d.mensaje << "\n";
+    uint64_t tSalida = EstadisticasLR::reloj();
+    if(ok && optimizar && arbol.raiz != Arbol::NINGUNO){
+        ResultadoOptimizacion opt;
+        optimizarArbol(arbol, G, opt);
+        cerr << "Optimización: " << opt.nodosAntes << " nodos -> " << opt.nodosCompactos << " al compactar ("
+             << opt.vacios << " vacíos, " << opt.colapsados << " de un solo hijo) -> " << opt.nodosDespues
+             << " al plegar (" << opt.plegados << " expresiones constantes";
+        if(opt.sinTexto) cerr << ", " << opt.sinTexto << " sin texto del operador";
+        cerr << "); compactar " << opt.nsCompactar / 1e6 << " ms, plegar " << opt.nsPlegar / 1e6 << " ms\n";
+    }
+    if(ok){
+        cout << "Entrada aceptada.\n";
+
+        // Imprimir AST si existe
+        if(arbol.raiz != Arbol::NINGUNO && !rutaArbol.empty()){
+            ofstream archivo(rutaArbol, ios::binary);
+            escribirArbol(archivo, arbol, G, arbol.raiz, formato);
+            if(!archivo) cerr << "Error: no se pudo escribir el árbol en " << rutaArbol << "\n";
+        } else if(arbol.raiz != Arbol::NINGUNO && !compilar){
+            cout << (formato == FormatoArbol::JSON ? "\nÁrbol sintáctico (JSON):\n" : "\nÁrbol sintáctico (ASCII):\n");
+            escribirArbol(cout, arbol, G, arbol.raiz, formato);
+        }
+    }
+
+    if(ok && (semantica || compilar)){
+        ResultadoSemantico sem;
+        analizarSemantica(arbol, G, sem);
+        for(const string &e : sem.errores) cerr << "Error semántico: " << e << "\n";
+        if(sem.nErrores > sem.errores.size()) cerr << "... y " << sem.nErrores - sem.errores.size() << " errores semánticos más\n";
+        if(semantica){
+            cerr << "Semántica: " << sem.nErrores << " errores; " << sem.declaraciones << " declaraciones, " << sem.usos << " usos, "
+                 << sem.funciones << " funciones, " << sem.ambitos << " ámbitos; tabla de " << sem.ranuras << " ranuras, "
+                 << (sem.accesos ? (double)sem.sondeos / sem.accesos : 0.0) << " sondeos por acceso\n"
+                 << "Tiempos: sintáctico " << msSintactico << " ms, declaraciones " << sem.nsDeclaraciones / 1e6
+                 << " ms, cuerpos " << sem.nsCuerpos / 1e6 << " ms\n";
+        }
+        ok = sem.ok();
+    }
+
+    if(ok && compilar){
+        ProgramaBC prog;
+        string error;
+        if(!compilarBytecode(arbol, G, prog, error)){
+            cerr << "Error de compilación: " << error << "\n";
+            ok = false;
+        } else {
+            if(listado){ cout << "\nBytecode:\n"; desensamblar(prog, cout); }
+            if(ejecutar){
+                cout << "\nEjecución:\n";
+                MaquinaBC vm(prog);
+                ResultadoVM r = vm.ejecutar(cout);
+                if(!r.ok){ cerr << "Error de ejecución: " << r.error << "\n"; ok = false; }
+                else if(r.tipo == TipoBC::REAL) cout << "main devolvió " << r.valor.f << "\n";
+                else cout << "main devolvió " << r.valor.i << "\n";
+            }
+        }
+    }
 
     if(ok) {
         cout << "Análisis completado: OK\n";
     } else {
         cout << "Análisis completado: FALLIDO\n";
     }
+    if(est){
+        cout.flush();
+        est->tSalida = EstadisticasLR::reloj() - tSalida;
+        ofstream archivo;
+        if(!rutaStats.empty()) archivo.open(rutaStats);
+        ostream &os = rutaStats.empty() ? (ostream&)cerr : archivo;
+        if(formatoStats == "json") est->escribirJSON(os, G);
+        else est->escribirTrazaChrome(os, G);
+        if(!os) cerr << "Error: no se pudo escribir el reporte de --stats.\n";
+    }
 
     return 0;
 }
@@ -0,0 +1,140 @@
+// tuberia.h
+// Análisis en tubería: un hilo ejecuta LexerRapido y entrega los tokens en
+// lotes por un anillo SPSC sin bloqueos; el hilo que llama ejecuta el ciclo
+// LR sobre esos lotes. El anillo tiene capacidad fija, así que si el parser
+// se atrasa el lexer espera (contrapresión), y cuando el parser termina
+// (aceptación o error) el lexer se detiene en el siguiente lote.
+// Los lexemas son vistas de 'entrada', que debe estar completa en memoria.
+// Compilar con -pthread.
+#ifndef TUBERIA_H
+#define TUBERIA_H
+
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+#include <thread>
+#include "gramatica.h"
+#include "lexer.h"
+#include "lexer_rapido.h"
+#include "parser.h"
+
+/* ------------------ Anillo SPSC ------------------ */
+// Un productor y un consumidor. Las casillas se llenan en su lugar:
+// escribir() da la casilla libre, publicar() la entrega; leer() da la más
+// antigua, liberar() la devuelve. Los índices crecen sin límite y se toman
+// módulo N (potencia de 2).
+template<class T, size_t N>
+class AnilloSPSC {
+    static_assert((N & (N - 1)) == 0, "N debe ser potencia de 2");
+public:
+    T* escribir() {
+        uint64_t c = cola.load(std::memory_order_relaxed);
+        return c - cabeza.load(std::memory_order_acquire) < N ? &casillas[c & (N - 1)] : nullptr;
+    }
+    void publicar() { cola.store(cola.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    T* leer() {
+        uint64_t c = cabeza.load(std::memory_order_relaxed);
+        return c != cola.load(std::memory_order_acquire) ? &casillas[c & (N - 1)] : nullptr;
+    }
+    void liberar() { cabeza.store(cabeza.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+private:
+    alignas(64) std::atomic<uint64_t> cabeza{0}; // próxima a leer (consumidor)
+    alignas(64) std::atomic<uint64_t> cola{0};   // próxima a escribir (productor)
+    alignas(64) T casillas[N];
+};
+
+// Espera activa corta y luego cede el procesador: con menos núcleos que
+// hilos girar sin ceder sólo retrasa al otro extremo.
+inline void esperarTurno(unsigned &vueltas){
+    if (++vueltas < 64) {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    } else {
+        std::this_thread::yield();
+    }
+}
+
+/* ------------------ Tubería lexer -> parser ------------------ */
+struct LoteTokens {
+    static const size_t CAPACIDAD = 512;
+    uint32_t n;
+    Token tk[CAPACIDAD]; // el último lote termina en FIN
+};
+
+class Tuberia {
+public:
+    static const size_t LOTES = 64; // como máximo 64 x 512 tokens (1 MB) en vuelo
+
+    explicit Tuberia(std::string_view entrada) : hilo([this, entrada] { producir(entrada); }) {}
+    ~Tuberia() {
+        cancelar.store(true, std::memory_order_relaxed);
+        hilo.join();
+    }
+    Tuberia(const Tuberia&) = delete;
+    Tuberia& operator=(const Tuberia&) = delete;
+
+    // Fuente de tokens para analizarLR.
+    Token next() {
+        if (i == actualN) {
+            if (actual) anillo.liberar();
+            unsigned vueltas = 0;
+            while (!(actual = anillo.leer())) esperarTurno(vueltas);
+            actualN = actual->n;
+            i = 0;
+        }
+        Token tk = actual->tk[i++];
+        if (tk.type == TokenType::FIN) i--; // FIN se repite, como en LexerRapido
+        return tk;
+    }
+
+    // El lexer deja de producir en cuanto termina el lote actual.
+    void detener() { cancelar.store(true, std::memory_order_relaxed); }
+
+    uint64_t esperasProductor() const { return esperas.load(std::memory_order_relaxed); }
+
+private:
+    AnilloSPSC<LoteTokens, LOTES> anillo;
+    std::atomic<bool> cancelar{false};
+    std::atomic<uint64_t> esperas{0}; // veces que el lexer encontró el anillo lleno
+    LoteTokens *actual = nullptr;
+    uint32_t i = 0, actualN = 0;
+    std::thread hilo; // último: se inicia con el resto ya construido
+
+    void producir(std::string_view entrada) {
+        LexerRapido lx(entrada);
+        uint64_t llenos = 0;
+        bool fin = false;
+        while (!fin && !cancelar.load(std::memory_order_relaxed)) {
+            LoteTokens *lote;
+            unsigned vueltas = 0;
+            while (!(lote = anillo.escribir())) {
+                if (cancelar.load(std::memory_order_relaxed)) { esperas = llenos; return; }
+                if (vueltas == 0) llenos++;
+                esperarTurno(vueltas);
+            }
+            uint32_t n = 0;
+            while (n < LoteTokens::CAPACIDAD) {
+                Token tk = lx.next();
+                lote->tk[n++] = tk;
+                if (tk.type == TokenType::FIN) { fin = true; break; }
+            }
+            lote->n = n;
+            anillo.publicar();
+        }
+        esperas = llenos;
+    }
+};
+
+// Como analizarLR, con el lexer en otro hilo. Mismos resultados y mensajes.
+template<class Constructor>
+Diagnostico analizarEnTuberia(const LRGram &G, std::string_view entrada, Constructor &cons){
+    Tuberia t(entrada);
+    Diagnostico d = analizarLR(G, t, cons);
+    t.detener();
+    return d;
+}
+
+#endif
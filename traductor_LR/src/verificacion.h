@@ -0,0 +1,201 @@
+// verificacion.h
+// Piezas comunes de las pruebas diferenciales (benchmark --verificar-X).
+// Cada módulo tiene su verificador al lado, en <modulo>_verificar.h, con la
+// forma int verificarX(ContextoVerificacion&); acá están el contexto, el
+// conteo de casos, los generadores de entradas y la comparación de árboles.
+#ifndef VERIFICACION_H
+#define VERIFICACION_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+#include "arbol.h"
+#include "gramatica.h"
+#include "parser.h"
+
+/* ------------------ Contexto ------------------ */
+// Lo que recibe cada verificador: la gramática del .lr ya cargada (con
+// resolverTokens), su tabla densa, las rutas y las opciones que siguen.
+struct ContextoVerificacion {
+    LRGram G;
+    std::vector<int32_t> densa;
+    std::string rutaLR, rutaInf;
+    std::vector<std::string> opciones;
+
+    bool cargar(const std::string &lr, const std::string &inf){
+        rutaLR = lr;
+        rutaInf = inf;
+        if(!cargarLR(lr, G, &densa) || !leerInf(inf, G)) return false;
+        resolverTokens(G);
+        return true;
+    }
+    // Valor de "--nombre N" en las opciones, o 'defecto'.
+    long long opcion(const std::string &nombre, long long defecto) const {
+        for(size_t i=0;i+1<opciones.size();i++) if(opciones[i] == nombre) return std::atoll(opciones[i+1].c_str());
+        return defecto;
+    }
+};
+
+/* ------------------ Conteo de casos ------------------ */
+// Cada caso compara una implementación con su referencia; de los fallos se
+// muestran los primeros (mostrar() imprime el detalle) y el resto sólo se
+// cuenta.
+struct PruebaDiferencial {
+    static const int MOSTRAR = 5;
+    int casos = 0, aceptados = 0, fallos = 0;
+
+    template<class F>
+    bool comprobar(bool ok, F mostrar){
+        casos++;
+        if(!ok && ++fallos <= MOSTRAR) mostrar();
+        return ok;
+    }
+    // Un fallo que no es un caso (la entrada de un caso fijo se rechazó, el
+    // costo creció...).
+    template<class F>
+    void fallo(F mostrar){ if(++fallos <= MOSTRAR) mostrar(); }
+    int codigo() const { return fallos ? 1 : 0; }
+};
+
+/* ------------------ Generadores ------------------ */
+// xorshift32: la misma secuencia en todas las plataformas.
+struct Azar {
+    uint32_t x;
+    explicit Azar(uint32_t semilla) : x(semilla) {}
+    uint32_t operator()(){ x ^= x << 13; x ^= x >> 17; x ^= x << 5; return x; }
+};
+
+// Repite un programa válido con nombres distintos hasta llegar a 'bytes'.
+inline std::string generarEntrada(size_t bytes){
+    std::string s;
+    char buf[512];
+    for(int k=0; s.size() < bytes; k++){
+        std::snprintf(buf, sizeof buf,
+            "int v%d, w%d;\n"
+            "float f%d(int a, float b) {\n"
+            "  float r;\n"
+            "  r = a + b * 2.5 - (a / 3);\n"
+            "  if (r > 10) return r; else { r = 0; }\n"
+            "  while (a != 0 && r < 100) { a = a - 1; r = r + 1.5; }\n"
+            "  imprimir(\"hola\", r);\n"
+            "  return r;\n"
+            "}\n", k, k, k);
+        s += buf;
+    }
+    return s;
+}
+
+// Programa aleatorio con expresiones de todos los operadores (unarios,
+// paréntesis, llamadas) e if/else anidados, para ejercitar las celdas que
+// decide la precedencia.
+inline std::string programaAleatorio(Azar &azar, int nDefs){
+    const char *ops[] = {"+", "-", "*", "/", "<", ">", "<=", ">=", "==", "!=", "&&", "||"};
+    std::function<std::string(int)> expr = [&](int d) -> std::string {
+        uint32_t k = d <= 0 ? azar() % 3 : azar() % 8;
+        switch(k){
+            case 0: return "a";
+            case 1: return std::to_string(azar() % 100);
+            case 2: return "2.5";
+            case 3: return "(" + expr(d - 1) + ")";
+            case 4: return (azar() % 2 ? "-" : "!") + expr(d - 1);
+            case 5: return "g(" + expr(d - 1) + ", " + expr(d - 2) + ")";
+            default: return expr(d - 1) + " " + ops[azar() % 12] + " " + expr(d - 1);
+        }
+    };
+    // finElse: la sentencia termina en una rama else. La tabla del .lr no
+    // acepta otro else a continuación, así que ese if queda sin else.
+    bool finElse = false;
+    std::function<std::string(int)> sent = [&](int d) -> std::string {
+        uint32_t k = d <= 0 ? azar() % 2 : azar() % 6;
+        finElse = false;
+        switch(k){
+            case 0: return "x = " + expr(3) + ";";
+            case 1: return "return " + expr(2) + ";";
+            case 2: {
+                std::string c = "if (" + expr(2) + ") ";
+                c += sent(d - 1);
+                if(!finElse && azar() % 2){ c += " else " + sent(d - 1); finElse = true; }
+                return c;
+            }
+            case 3: { std::string c = "while (" + expr(2) + ") { " + sent(d - 1) + " " + sent(d - 1) + " }"; finElse = false; return c; }
+            case 4: return "h(" + expr(2) + ");";
+            default: { std::string c = "if (" + expr(1) + ") { " + sent(d - 1) + " }"; finElse = false; return c; }
+        }
+    };
+    std::string s;
+    for(int k=0;k<nDefs;k++){
+        if(azar() % 3 == 0){ s += "int v" + std::to_string(k) + ", w;\n"; continue; }
+        s += "float f" + std::to_string(k) + "(int a, float b) {\n  int r;\n";
+        for(int j=azar()%4; j>=0; j--) s += "  " + sent(3) + "\n";
+        s += "}\n";
+    }
+    return s;
+}
+
+// 'n' programas de programaAleatorio y, por cada uno, 'mutaciones' copias
+// con un trozo insertado y a veces unos bytes borrados (casi siempre
+// inválidas, a veces no); caso() recibe cada entrada.
+template<class F>
+void programasMutados(Azar &azar, int n, int mutaciones, const std::vector<const char*> &trozos, F caso){
+    for(int k=0;k<n;k++){
+        std::string s = programaAleatorio(azar, 1 + azar() % 6);
+        caso(s);
+        for(int m=0;m<mutaciones;m++){
+            std::string u = s;
+            size_t p = azar() % (u.size() + 1);
+            u.insert(p, trozos[azar() % trozos.size()]);
+            if(azar() % 2 && !u.empty()) u.erase(azar() % u.size(), 1 + azar() % 3);
+            caso(u);
+        }
+    }
+}
+
+/* ------------------ Comparaciones ------------------ */
+// Misma arena nodo por nodo, mismos hijos y mismos lexemas por id.
+inline bool mismaArena(const Arbol &a, const Arbol &b){
+    if(a.raiz != b.raiz || a.nodos.size() != b.nodos.size() || a.hijos != b.hijos || a.lexemas.size() != b.lexemas.size()) return false;
+    for(size_t k=0;k<a.nodos.size();k++){
+        const NodoAst &x = a.nodos[k], &y = b.nodos[k];
+        if(x.simbolo != y.simbolo || x.lexema != y.lexema || x.primerHijo != y.primerHijo || x.nHijos != y.nHijos) return false;
+    }
+    for(uint32_t j=0;j<a.lexemas.size();j++) if(a.lexemas.texto(j) != b.lexemas.texto(j)) return false;
+    return true;
+}
+
+// Mismo árbol comparando forma, reglas y lexemas por texto (los ids pueden
+// diferir: el análisis incremental interna en otro orden).
+inline bool mismoArbol(const Arbol &a, const Arbol &b){
+    if((a.raiz == Arbol::NINGUNO) != (b.raiz == Arbol::NINGUNO)) return false;
+    if(a.raiz == Arbol::NINGUNO) return true;
+    std::vector<std::pair<uint32_t,uint32_t>> pila{{a.raiz, b.raiz}};
+    while(!pila.empty()){
+        auto [i, j] = pila.back();
+        pila.pop_back();
+        const NodoAst &x = a[i], &y = b[j];
+        if(x.simbolo != y.simbolo || x.nHijos != y.nHijos) return false;
+        if((x.lexema == TablaLexemas::NINGUNO) != (y.lexema == TablaLexemas::NINGUNO)) return false;
+        if(x.lexema != TablaLexemas::NINGUNO && a.lexemas.texto(x.lexema) != b.lexemas.texto(y.lexema)) return false;
+        for(uint32_t k=0;k<x.nHijos;k++) pila.push_back({a.hijo(x, k), b.hijo(y, k)});
+    }
+    return true;
+}
+
+// Mejor tiempo (segundos) de 'reps' ejecuciones.
+template<class F>
+double mejorTiempo(int reps, F f){
+    double mejor = 1e30;
+    for(int r=0;r<reps;r++){
+        auto t0 = std::chrono::steady_clock::now();
+        f();
+        auto t1 = std::chrono::steady_clock::now();
+        mejor = std::min(mejor, std::chrono::duration<double>(t1 - t0).count());
+    }
+    return mejor;
+}
+
+#endif
@@ -0,0 +1,138 @@
+// vista_ast.h
+// Acceso al árbol del lenguaje de compilador.inf por construcción (DefVar,
+// Sentencia, Expresion, ...) en lugar de por posición de hijo. Sirve igual
+// para el árbol completo de parseLR y para el compacto de optimizar.h, donde
+// no hay nodos de producciones vacías y las cadenas de un solo hijo
+// (Expresion -> Termino -> entero, Definicion -> DefVar, ...) quedaron
+// reducidas al nodo de abajo. La usan semantica.h y bytecode.h.
+#ifndef VISTA_AST_H
+#define VISTA_AST_H
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+#include "arbol.h"
+#include "gramatica.h"
+#include "lexer.h"
+
+class VistaAst {
+public:
+    enum Categoria {
+        PROGRAMA, DEFINICIONES, DEFINICION, DEFVAR, LISTAVAR, DEFFUNC, PARAMETROS, LISTAPARAM, BLOQFUNC,
+        DEFLOCALES, DEFLOCAL, SENTENCIAS, SENTENCIA, OTRO, BLOQUE, VALORREGRESA, ARGUMENTOS, LISTAARGUMENTOS,
+        TERMINO, LLAMADAFUNC, SENTENCIABLOQUE, EXPRESION, HOJA, DESCONOCIDA
+    };
+
+    VistaAst(const Arbol &A, const LRGram &G) : A(A), G(G) {}
+
+    // Hay que llamarla antes de usar categoria() (la gramática puede cambiar
+    // entre análisis si el objeto se reutiliza).
+    void clasificarReglas() {
+        static const char *const NOMBRES[] = {"programa", "Definiciones", "Definicion", "DefVar", "ListaVar", "DefFunc", "Parametros",
+            "ListaParam", "BloqFunc", "DefLocales", "DefLocal", "Sentencias", "Sentencia", "Otro", "Bloque", "ValorRegresa",
+            "Argumentos", "ListaArgumentos", "Termino", "LlamadaFunc", "SentenciaBloque", "Expresion"};
+        catRegla.assign(G.nReglas + 1, DESCONOCIDA);
+        for (int r = 0; r < G.nReglas; r++)
+            for (int c = 0; c <= EXPRESION; c++)
+                if (std::strcmp(G.nombreRegla(r), NOMBRES[c]) == 0) catRegla[r + 1] = (Categoria)c;
+        reglaLista.assign(catRegla.size(), 0);
+        for (size_t r = 0; r < catRegla.size(); r++) reglaLista[r] = esLista(catRegla[r]);
+    }
+
+    Categoria categoria(uint32_t k) const {
+        const NodoAst &n = A[k];
+        if (n.esHoja()) return HOJA;
+        return n.regla() > 0 && n.regla() < (int)catRegla.size() ? catRegla[n.regla()] : DESCONOCIDA;
+    }
+    uint32_t nHijos(uint32_t k) const { return A[k].nHijos; }
+    uint32_t hijo(uint32_t k, uint32_t i) const { return A.hijo(A[k], i); }
+    bool esToken(uint32_t k, TokenType t) const { return A[k].esHoja() && A[k].tipoToken() == t; }
+    uint32_t lexema(uint32_t k) const { return A[k].lexema; }
+    std::string_view texto(uint32_t k) const {
+        return A[k].lexema == TablaLexemas::NINGUNO ? std::string_view() : A.lexemas.texto(A[k].lexema);
+    }
+    static bool esLista(Categoria c) {
+        return c == DEFINICIONES || c == LISTAVAR || c == PARAMETROS || c == LISTAPARAM || c == DEFLOCALES ||
+               c == SENTENCIAS || c == ARGUMENTOS || c == LISTAARGUMENTOS;
+    }
+
+    // Baja por los nodos de un solo hijo (Definicion, DefLocal, Termino,
+    // SentenciaBloque, Expresion -> Termino, ...), que no agregan nada.
+    uint32_t desenvolver(uint32_t k) const {
+        while (!A[k].esHoja() && A[k].nHijos == 1) k = hijo(k, 0);
+        return k;
+    }
+
+    // Llama a f con cada elemento de una lista recursiva por la derecha
+    // (Definiciones, DefLocales, Sentencias, ListaVar, Parametros,
+    // Argumentos), sin las comas y ya desenvuelto. Si 'k' no es una lista
+    // es el único elemento. Iterativa: las listas pueden tener millones.
+    template<class F> void paraCadaElemento(uint32_t k, F f) const {
+        for (;;) {
+            const NodoAst &n = A[k];
+            if (n.esHoja() || !reglaLista[n.regla()]) { f(desenvolver(k)); return; }
+            if (n.nHijos == 0) return;
+            const uint32_t *h = &A.hijos[n.primerHijo];
+            for (uint32_t i = 0; i + 1 < n.nHijos; i++)
+                if (!esToken(h[i], TokenType::COMA)) f(desenvolver(h[i]));
+            k = h[n.nHijos - 1];
+        }
+    }
+    void elementos(uint32_t k, std::vector<uint32_t> &v) const {
+        paraCadaElemento(k, [&v](uint32_t x) { v.push_back(x); });
+    }
+
+    /* ---- Construcciones ---- */
+    // Lista de definiciones de primer nivel (DefVar o DefFunc), para
+    // paraCadaElemento; NINGUNO si no hay.
+    uint32_t listaDefiniciones() const {
+        uint32_t k = A.raiz;
+        if (k == Arbol::NINGUNO || categoria(k) != PROGRAMA) return k;
+        return nHijos(k) ? hijo(k, 0) : Arbol::NINGUNO;
+    }
+    void definiciones(std::vector<uint32_t> &v) const {
+        uint32_t k = listaDefiniciones();
+        if (k != Arbol::NINGUNO) elementos(k, v);
+    }
+    // DefVar -> tipo id [ListaVar] ;   (hojas identificador)
+    void nombresDeclarados(uint32_t defVar, std::vector<uint32_t> &v) const {
+        v.push_back(hijo(defVar, 1));
+        if (nHijos(defVar) == 4) elementos(hijo(defVar, 2), v);
+    }
+    // DefFunc -> tipo id ( [Parametros] ) BloqFunc;  v recibe tipo, id, tipo, id, ...
+    void parametros(uint32_t defFunc, std::vector<uint32_t> &v) const {
+        if (nHijos(defFunc) == 6) elementos(hijo(defFunc, 3), v);
+    }
+    uint32_t cuerpoFuncion(uint32_t defFunc) const { return hijo(defFunc, nHijos(defFunc) - 1); }
+    // Bloque o BloqFunc -> { [lista] }: DefLocal/Sentencia en orden.
+    void contenido(uint32_t bloque, std::vector<uint32_t> &v) const {
+        if (nHijos(bloque) == 3) elementos(hijo(bloque, 1), v);
+    }
+    // Cuerpo de un if/else/while: una Sentencia o un Bloque.
+    uint32_t rama(uint32_t k) const { return desenvolver(k); }
+    // Sentencia -> if ( E ) SB [Otro]: la rama del else, o NINGUNO.
+    uint32_t ramaElse(uint32_t sentenciaIf) const {
+        if (nHijos(sentenciaIf) != 6) return Arbol::NINGUNO;
+        uint32_t otro = hijo(sentenciaIf, 5);
+        return nHijos(otro) == 2 ? rama(hijo(otro, 1)) : Arbol::NINGUNO;
+    }
+    // Sentencia -> return [ValorRegresa] ;: la expresión, o NINGUNO.
+    uint32_t valorRetorno(uint32_t sentenciaReturn) const {
+        if (nHijos(sentenciaReturn) != 3) return Arbol::NINGUNO;
+        uint32_t v = hijo(sentenciaReturn, 1);
+        return categoria(v) == VALORREGRESA && nHijos(v) == 0 ? Arbol::NINGUNO : desenvolver(v);
+    }
+    // LlamadaFunc -> id ( [Argumentos] ): las expresiones de los argumentos.
+    void argumentos(uint32_t llamada, std::vector<uint32_t> &v) const {
+        if (nHijos(llamada) == 4) elementos(hijo(llamada, 2), v);
+    }
+
+protected:
+    const Arbol &A;
+    const LRGram &G;
+    std::vector<Categoria> catRegla;
+    std::vector<char> reglaLista; // esLista(catRegla[r]), para elementos()
+};
+
+#endif
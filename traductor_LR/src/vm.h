@@ -0,0 +1,209 @@
+// vm.h
+// Intérprete del bytecode de bytecode.h. El despacho usa goto computado
+// (una tabla de direcciones de etiqueta, extensión de GCC y Clang): cada
+// instrucción salta directo a la siguiente, sin volver a un switch central.
+// Con otros compiladores (o con -DVM_SIN_GOTO_COMPUTADO) se usa un switch
+// dentro del ciclo.
+// Los registros de todas las llamadas activas viven en una sola pila de
+// ValorBC de tamaño fijo; cada marco empieza donde el que llama dejó los
+// argumentos.
+#ifndef VM_H
+#define VM_H
+
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "bytecode.h"
+#include "salida.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(VM_SIN_GOTO_COMPUTADO)
+#define VM_GOTO_COMPUTADO
+#endif
+
+struct ResultadoVM {
+    bool ok = false;
+    ValorBC valor{};            // lo que devolvió main
+    TipoBC tipo = TipoBC::ENTERO;
+    std::string error;          // error de ejecución si !ok
+    uint64_t instrucciones = 0; // sólo con ejecutarContando
+};
+
+class MaquinaBC {
+public:
+    static const size_t RANURAS_DEFECTO = 1 << 20; // 8 MB de registros
+    static const size_t MARCOS_MAX = 1 << 18;
+
+    explicit MaquinaBC(const ProgramaBC &P, size_t ranuras = RANURAS_DEFECTO) : P(P), pila(ranuras) { marcos.reserve(1024); }
+
+    // La salida de print va a 'os' (con buffer).
+    ResultadoVM ejecutar(std::ostream &os) { return correr<false>(os); }
+    // Igual, contando instrucciones ejecutadas (un poco más lento).
+    ResultadoVM ejecutarContando(std::ostream &os) { return correr<true>(os); }
+
+private:
+    struct Marco {
+        const InstrBC *retorno;
+        ValorBC *R;
+    };
+    const ProgramaBC &P;
+    std::vector<ValorBC> pila, globales;
+    std::vector<Marco> marcos;
+
+    static int64_t sumar(int64_t x, int64_t y) { return (int64_t)((uint64_t)x + (uint64_t)y); }
+    static int64_t restar(int64_t x, int64_t y) { return (int64_t)((uint64_t)x - (uint64_t)y); }
+    static int64_t multiplicar(int64_t x, int64_t y) { return (int64_t)((uint64_t)x * (uint64_t)y); }
+    static int64_t aEntero(double f) { return f > -9.2e18 && f < 9.2e18 ? (int64_t)f : 0; }
+    static void imprimirEntero(SalidaBuffer &s, int64_t v) {
+        if (v < 0) { s.caracter('-'); s.entero(0 - (uint64_t)v); }
+        else s.entero((uint64_t)v);
+    }
+    static void imprimirReal(SalidaBuffer &s, double v) {
+        char num[32];
+        int n = std::snprintf(num, sizeof num, "%g", v);
+        s.escribir(num, (size_t)n);
+    }
+
+    template<bool CONTAR>
+    ResultadoVM correr(std::ostream &os) {
+        ResultadoVM res;
+        if (P.principal < 0) { res.error = "no hay función main"; return res; }
+        const FuncionBC &principal = P.funciones[P.principal];
+        res.tipo = principal.retorno;
+        if (principal.nRegistros > pila.size()) { res.error = "la pila de registros es muy chica para main"; return res; }
+        globales.assign(P.globales.size(), ValorBC{0});
+        marcos.clear();
+        SalidaBuffer sal(os);
+        const InstrBC *codigo = P.codigo.data();
+        const ValorBC *K = P.constantes.data();
+        ValorBC *G = globales.data(), *fondo = pila.data(), *R = fondo;
+        const InstrBC *pc = codigo + principal.inicio;
+        uint64_t pasos = 0;
+        for (uint32_t i = 0; i < principal.nLocales; i++) R[i].i = 0;
+
+#ifdef VM_GOTO_COMPUTADO
+        static void *const ETIQUETAS[] = {
+#define X(n) &&L_##n,
+            OPS_BC(X)
+#undef X
+        };
+#define CASO(n) L_##n:
+#define SIGUIENTE() do { if constexpr (CONTAR) pasos++; goto *ETIQUETAS[pc->op]; } while (0)
+        SIGUIENTE();
+#else
+#define CASO(n) case (uint16_t)OpBC::n:
+#define SIGUIENTE() continue
+        for (;;) {
+        if constexpr (CONTAR) pasos++;
+        switch (pc->op) {
+#endif
+        CASO(MOV) R[pc->a] = R[pc->b]; ++pc; SIGUIENTE();
+        CASO(CARGAK) R[pc->a] = K[pc->k()]; ++pc; SIGUIENTE();
+        CASO(CARGAG) R[pc->a] = G[pc->k()]; ++pc; SIGUIENTE();
+        CASO(GUARDAG) G[pc->k()] = R[pc->a]; ++pc; SIGUIENTE();
+        CASO(I2F) R[pc->a].f = (double)R[pc->b].i; ++pc; SIGUIENTE();
+        CASO(F2I) R[pc->a].i = aEntero(R[pc->b].f); ++pc; SIGUIENTE();
+
+        CASO(SUMAI) R[pc->a].i = sumar(R[pc->b].i, R[pc->c].i); ++pc; SIGUIENTE();
+        CASO(RESTAI) R[pc->a].i = restar(R[pc->b].i, R[pc->c].i); ++pc; SIGUIENTE();
+        CASO(MULI) R[pc->a].i = multiplicar(R[pc->b].i, R[pc->c].i); ++pc; SIGUIENTE();
+        CASO(DIVI) {
+            int64_t d = R[pc->c].i;
+            if (d == 0) { res.error = "división entera entre cero"; goto fin; }
+            R[pc->a].i = d == -1 ? restar(0, R[pc->b].i) : R[pc->b].i / d;
+            ++pc;
+            SIGUIENTE();
+        }
+        CASO(SUMAIK) R[pc->a].i = sumar(R[pc->b].i, (int16_t)pc->c); ++pc; SIGUIENTE();
+        CASO(NEGI) R[pc->a].i = restar(0, R[pc->b].i); ++pc; SIGUIENTE();
+        CASO(NOT) R[pc->a].i = R[pc->b].i == 0; ++pc; SIGUIENTE();
+
+        CASO(SUMAF) R[pc->a].f = R[pc->b].f + R[pc->c].f; ++pc; SIGUIENTE();
+        CASO(RESTAF) R[pc->a].f = R[pc->b].f - R[pc->c].f; ++pc; SIGUIENTE();
+        CASO(MULF) R[pc->a].f = R[pc->b].f * R[pc->c].f; ++pc; SIGUIENTE();
+        CASO(DIVF) R[pc->a].f = R[pc->b].f / R[pc->c].f; ++pc; SIGUIENTE();
+        CASO(NEGF) R[pc->a].f = -R[pc->b].f; ++pc; SIGUIENTE();
+        CASO(NOTF) R[pc->a].i = R[pc->b].f == 0; ++pc; SIGUIENTE();
+
+        CASO(LTI) R[pc->a].i = R[pc->b].i < R[pc->c].i; ++pc; SIGUIENTE();
+        CASO(LEI) R[pc->a].i = R[pc->b].i <= R[pc->c].i; ++pc; SIGUIENTE();
+        CASO(GTI) R[pc->a].i = R[pc->b].i > R[pc->c].i; ++pc; SIGUIENTE();
+        CASO(GEI) R[pc->a].i = R[pc->b].i >= R[pc->c].i; ++pc; SIGUIENTE();
+        CASO(EQI) R[pc->a].i = R[pc->b].i == R[pc->c].i; ++pc; SIGUIENTE();
+        CASO(NEI) R[pc->a].i = R[pc->b].i != R[pc->c].i; ++pc; SIGUIENTE();
+        CASO(LTF) R[pc->a].i = R[pc->b].f < R[pc->c].f; ++pc; SIGUIENTE();
+        CASO(LEF) R[pc->a].i = R[pc->b].f <= R[pc->c].f; ++pc; SIGUIENTE();
+        CASO(GTF) R[pc->a].i = R[pc->b].f > R[pc->c].f; ++pc; SIGUIENTE();
+        CASO(GEF) R[pc->a].i = R[pc->b].f >= R[pc->c].f; ++pc; SIGUIENTE();
+        CASO(EQF) R[pc->a].i = R[pc->b].f == R[pc->c].f; ++pc; SIGUIENTE();
+        CASO(NEF) R[pc->a].i = R[pc->b].f != R[pc->c].f; ++pc; SIGUIENTE();
+
+        CASO(SALTA) pc = codigo + pc->k(); SIGUIENTE();
+        CASO(SALTAF) pc = R[pc->a].i ? pc + 1 : codigo + pc->k(); SIGUIENTE();
+        CASO(SALTAV) pc = R[pc->a].i ? codigo + pc->k() : pc + 1; SIGUIENTE();
+        CASO(SALTALT) pc += R[pc->a].i < R[pc->b].i ? (int16_t)pc->c : 1; SIGUIENTE();
+        CASO(SALTALE) pc += R[pc->a].i <= R[pc->b].i ? (int16_t)pc->c : 1; SIGUIENTE();
+        CASO(SALTAGT) pc += R[pc->a].i > R[pc->b].i ? (int16_t)pc->c : 1; SIGUIENTE();
+        CASO(SALTAGE) pc += R[pc->a].i >= R[pc->b].i ? (int16_t)pc->c : 1; SIGUIENTE();
+        CASO(SALTAEQ) pc += R[pc->a].i == R[pc->b].i ? (int16_t)pc->c : 1; SIGUIENTE();
+        CASO(SALTANE) pc += R[pc->a].i != R[pc->b].i ? (int16_t)pc->c : 1; SIGUIENTE();
+
+        CASO(LLAMAR) {
+            const FuncionBC &f = P.funciones[pc->k()];
+            ValorBC *nuevo = R + pc->a;
+            if ((size_t)(nuevo - fondo) + f.nRegistros > pila.size() || marcos.size() >= MARCOS_MAX) {
+                res.error = "desbordamiento de pila al llamar a " + f.nombre + "()";
+                goto fin;
+            }
+            for (uint32_t i = f.nParametros; i < f.nLocales; i++) nuevo[i].i = 0;
+            marcos.push_back(Marco{pc + 1, R});
+            R = nuevo;
+            pc = codigo + f.inicio;
+            SIGUIENTE();
+        }
+        CASO(RET) {
+            ValorBC v = R[pc->a];
+            if (marcos.empty()) { res.valor = v; res.ok = true; goto fin; }
+            R[0] = v;
+            pc = marcos.back().retorno;
+            R = marcos.back().R;
+            marcos.pop_back();
+            SIGUIENTE();
+        }
+        CASO(RET0) {
+            if (marcos.empty()) { res.valor.i = 0; res.ok = true; goto fin; }
+            R[0].i = 0;
+            pc = marcos.back().retorno;
+            R = marcos.back().R;
+            marcos.pop_back();
+            SIGUIENTE();
+        }
+
+        CASO(IMPRIMIRI) if (pc->b) sal.caracter(' '); imprimirEntero(sal, R[pc->a].i); ++pc; SIGUIENTE();
+        CASO(IMPRIMIRF) if (pc->b) sal.caracter(' '); imprimirReal(sal, R[pc->a].f); ++pc; SIGUIENTE();
+        CASO(IMPRIMIRS) if (pc->a) sal.caracter(' '); sal.escribir(P.cadenas[pc->k()]); ++pc; SIGUIENTE();
+        CASO(IMPRIMIRNL) sal.caracter('\n'); ++pc; SIGUIENTE();
+#ifndef VM_GOTO_COMPUTADO
+        }
+        }
+#endif
+#undef CASO
+#undef SIGUIENTE
+    fin:
+        res.instrucciones = pasos;
+        return res;
+    }
+};
+
+// Compila y ejecuta; 'error' distingue errores de compilación y de ejecución.
+inline bool ejecutarPrograma(const Arbol &A, const LRGram &G, std::ostream &os, ResultadoVM &res, std::string &error) {
+    ProgramaBC P;
+    if (!compilarBytecode(A, G, P, error)) { error = "Error de compilación: " + error; return false; }
+    MaquinaBC vm(P);
+    res = vm.ejecutar(os);
+    if (!res.ok) { error = "Error de ejecución: " + res.error; return false; }
+    return true;
+}
+
+#endif